@@ -0,0 +1,394 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file Burst.c
+//! \brief The burst capture service of transducer 0
+//!
+//! Keeps the packed ring buffer, runs the trigger on every sample handed on
+//! by the ADC ISR, and serves the transfer objects described in Burst.h.
+//!
+//! @addtogroup burst
+//! @{
+//!
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "Thermo.h"
+#include "Burst.h"
+
+//! \def BURST_NO_TRIGGER
+//! \brief Trigger index of a capture without a trigger sample
+#define BURST_NO_TRIGGER		0xFFFF
+
+#if (BURST_SAMPLES & 1) != 0
+	#error "BURST_SAMPLES must be even"
+#endif
+
+#if (BURST_MAX_TICKS / BURST_MAX_INTERVAL) <= BURST_SAMPLES
+	#error "BURST_MAX_TICKS leaves no time to wait for a trigger"
+#endif
+
+//! \var g_ucaBurst_Buffer
+//! \brief The ring of packed samples, two samples to three bytes
+static uint8 g_ucaBurst_Buffer[BURST_BYTES];
+
+//******************  Settings  *********************************************//
+//! @name Settings
+//! The parameters of the latest capture
+//! @{
+//! \var g_ucBurst_State
+static uint8 g_ucBurst_State = BURST_STATE_IDLE;
+
+//! \var g_ucBurst_Channel
+static uint8 g_ucBurst_Channel;
+
+//! \var g_uiBurst_Interval
+//! \brief SMCLK ticks between samples
+static uint16 g_uiBurst_Interval;
+
+//! \var g_ucBurst_Trigger
+static uint8 g_ucBurst_Trigger;
+
+//! \var g_uiBurst_Level
+static uint16 g_uiBurst_Level;
+
+//! \var g_uiBurst_Pretrigger
+//! \brief Samples kept ahead of the trigger sample
+static uint16 g_uiBurst_Pretrigger;
+//! @}
+
+//******************  Capture State  ****************************************//
+//! @name Capture State
+//! Updated by ucBurst_Sample() from the ADC ISR
+//! @{
+//! \var g_uiBurst_Head
+//! \brief The slot of the next sample, the oldest once the ring is full
+static uint16 g_uiBurst_Head;
+
+//! \var g_uiBurst_Count
+//! \brief Samples taken in the capture
+static uint16 g_uiBurst_Count;
+
+//! \var g_uiBurst_Left
+//! \brief Samples still to wait for the trigger, or to take after it
+static uint16 g_uiBurst_Left;
+
+//! \var g_uiBurst_Previous
+//! \brief The sample before the current one, for the trigger
+static uint16 g_uiBurst_Previous;
+
+//! \var g_uiBurst_TriggerIdx
+//! \brief The index of the trigger sample in the data, BURST_NO_TRIGGER
+//! until it is found
+static uint16 g_uiBurst_TriggerIdx;
+//! @}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the byte offset of the pair that holds a sample
+//!   \param uiIdx The sample slot
+//!   \return Three times half the slot
+///////////////////////////////////////////////////////////////////////////////
+static uint16 uiBurst_PairOffset(uint16 uiIdx)
+{
+	uiIdx >>= 1;
+
+	return uiIdx + (uiIdx << 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Stores a sample in its slot
+//!   \param uiIdx The sample slot
+//!   \param uiSample The 12-bit sample
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vBurst_Put(uint16 uiIdx, uint16 uiSample)
+{
+	uint8 * pucPair;
+
+	pucPair = &g_ucaBurst_Buffer[uiBurst_PairOffset(uiIdx)];
+
+	if ((uiIdx & 1) == 0) {
+		pucPair[0] = (uint8) (uiSample >> 4);
+		pucPair[1] = (pucPair[1] & 0x0F) | (uint8) (uiSample << 4);
+	}
+	else {
+		pucPair[1] = (pucPair[1] & 0xF0) | ((uint8) (uiSample >> 8) & 0x0F);
+		pucPair[2] = (uint8) uiSample;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the sample in a slot
+//!   \param uiIdx The sample slot
+//!   \return The 12-bit sample
+///////////////////////////////////////////////////////////////////////////////
+static uint16 uiBurst_Get(uint16 uiIdx)
+{
+	uint8 * pucPair;
+
+	pucPair = &g_ucaBurst_Buffer[uiBurst_PairOffset(uiIdx)];
+
+	if ((uiIdx & 1) == 0)
+		return ((uint16) pucPair[0] << 4) | (pucPair[1] >> 4);
+
+	return ((uint16) (pucPair[1] & 0x0F) << 8) | pucPair[2];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the samples a finished capture holds
+//!
+//! A capture that timed out before the ring was full holds fewer than
+//! BURST_SAMPLES, from slot 0 on.  An odd count drops the oldest sample so
+//! the data still packs in pairs.
+//!   \param puiOldest Where the slot of the oldest sample served goes
+//!   \return The number of samples, even
+///////////////////////////////////////////////////////////////////////////////
+static uint16 uiBurst_Held(uint16 * puiOldest)
+{
+	if (g_ucBurst_State != BURST_STATE_DONE && g_ucBurst_State != BURST_STATE_TIMEOUT) {
+		*puiOldest = 0;
+		return 0;
+	}
+
+	if (g_uiBurst_Count >= BURST_SAMPLES) {
+		*puiOldest = g_uiBurst_Head;
+		return BURST_SAMPLES;
+	}
+
+	*puiOldest = g_uiBurst_Count & 1;
+
+	return g_uiBurst_Count & ~1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Runs a burst capture
+//!
+//! Called for transducer 0 commands with BURST_OP_CAPTURE.  Returns once the
+//! capture is over, within BURST_MAX_TICKS.  The ADC must be initialized.
+//!
+//!   \param ucParamLen The number of parameter bytes
+//!   \param pucParam The parameters, see Burst.h
+//!   \return 0 on success, 1 for bad parameters
+///////////////////////////////////////////////////////////////////////////////
+uint16 uiBurst_Command(uint8 ucParamLen, uint8 * pucParam)
+{
+	uint8 ucChannel;
+	uint16 uiInterval;
+	uint8 ucTrigger;
+	uint16 uiLevel;
+	uint16 uiPretrigger;
+	uint16 uiWait;
+
+	if (ucParamLen < 4)
+		return 1;
+
+	ucChannel = pucParam[1];
+	uiInterval = ((uint16) pucParam[2] << 8) | pucParam[3];
+
+	ucTrigger = BURST_TRIG_NONE;
+	if (ucParamLen >= 5)
+		ucTrigger = pucParam[4];
+
+	uiLevel = 0;
+	if (ucParamLen >= 7)
+		uiLevel = ((uint16) pucParam[5] << 8) | pucParam[6];
+
+	uiPretrigger = BURST_SAMPLES / 2;
+	if (ucParamLen >= 9)
+		uiPretrigger = ((uint16) pucParam[7] << 8) | pucParam[8];
+
+	if (ucChannel == 0 || ucChannel > 4 || uiInterval < BURST_MIN_INTERVAL || uiInterval > BURST_MAX_INTERVAL)
+		return 1;
+
+	if (ucTrigger > BURST_TRIG_FALLING || uiPretrigger >= BURST_SAMPLES)
+		return 1;
+
+	g_ucBurst_Channel = ucChannel;
+	g_uiBurst_Interval = uiInterval;
+	g_ucBurst_Trigger = ucTrigger;
+	g_uiBurst_Level = uiLevel;
+
+	g_uiBurst_Head = 0;
+	g_uiBurst_Count = 0;
+
+	if (ucTrigger == BURST_TRIG_NONE) {
+		// The first sample is the trigger
+		g_uiBurst_Pretrigger = 0;
+		g_uiBurst_TriggerIdx = 0;
+		g_uiBurst_Left = BURST_SAMPLES;
+	}
+	else {
+		// The worst case is the trigger on the last sample of the wait
+		uiWait = (uint16) (BURST_MAX_TICKS / uiInterval) - BURST_SAMPLES;
+		if (uiWait > BURST_WAIT_SAMPLES)
+			uiWait = BURST_WAIT_SAMPLES;
+
+		g_uiBurst_Pretrigger = uiPretrigger;
+		g_uiBurst_TriggerIdx = BURST_NO_TRIGGER;
+		g_uiBurst_Left = uiWait;
+	}
+
+	g_ucBurst_State = BURST_STATE_RUNNING;
+
+	vThermo_Burst(ucChannel, uiInterval);
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Takes the next sample of the capture
+//!
+//! Called from the ADC ISR for every conversion of a burst.  A trigger is
+//! looked for once the pretrigger samples are in.  The trigger sample then
+//! lands at index g_uiBurst_Pretrigger of a full ring.
+//!
+//!   \param uiSample The raw conversion
+//!   \return 1 once the capture is over, 0 otherwise
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucBurst_Sample(uint16 uiSample)
+{
+	uint8 ucCrossed;
+
+	vBurst_Put(g_uiBurst_Head, uiSample);
+
+	g_uiBurst_Head++;
+	if (g_uiBurst_Head == BURST_SAMPLES)
+		g_uiBurst_Head = 0;
+
+	g_uiBurst_Count++;
+
+	if (g_uiBurst_TriggerIdx == BURST_NO_TRIGGER) {
+		if (g_uiBurst_Count > g_uiBurst_Pretrigger && g_uiBurst_Count > 1) {
+			if (g_ucBurst_Trigger == BURST_TRIG_RISING)
+				ucCrossed = (g_uiBurst_Previous < g_uiBurst_Level && uiSample >= g_uiBurst_Level);
+			else
+				ucCrossed = (g_uiBurst_Previous >= g_uiBurst_Level && uiSample < g_uiBurst_Level);
+
+			if (ucCrossed) {
+				g_uiBurst_TriggerIdx = g_uiBurst_Pretrigger;
+				g_uiBurst_Left = BURST_SAMPLES - g_uiBurst_Pretrigger;
+			}
+			else if (--g_uiBurst_Left == 0) {
+				g_ucBurst_State = BURST_STATE_TIMEOUT;
+				return 1;
+			}
+		}
+	}
+
+	g_uiBurst_Previous = uiSample;
+
+	// The trigger sample counts as the first sample after it
+	if (g_uiBurst_TriggerIdx != BURST_NO_TRIGGER) {
+		if (--g_uiBurst_Left == 0) {
+			g_ucBurst_State = BURST_STATE_DONE;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Serves the capture info and the samples
+//!
+//!   \param ucObject The object number
+//!   \param uiOffset Byte offset in the object
+//!   \param pucBuff Where the segment goes
+//!   \param ucMaxLen The size of a full segment
+//!   \return The segment length or XFER_NO_OBJECT
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucBurst_XferRead(uint8 ucObject, uint16 uiOffset, volatile uint8 * pucBuff, uint8 ucMaxLen)
+{
+	uint16 uiIdx;
+	uint16 uiHeld;
+	uint16 uiOldest;
+	uint16 uiBytes;
+	uint16 uiFirst;
+	uint16 uiSecond;
+	uint8 ucPhase;
+	uint8 ucLength;
+	uint8 ucByte;
+
+	uiHeld = uiBurst_Held(&uiOldest);
+
+	switch (ucObject) {
+		case BURST_OBJ_INFO:
+			// The whole info fits one segment
+			if (uiOffset != 0)
+				return 0;
+
+			*pucBuff++ = g_ucBurst_State;
+			*pucBuff++ = g_ucBurst_Channel;
+			*pucBuff++ = (uint8) (g_uiBurst_Interval >> 8);
+			*pucBuff++ = (uint8) g_uiBurst_Interval;
+			*pucBuff++ = g_ucBurst_Trigger;
+			*pucBuff++ = (uint8) (g_uiBurst_Level >> 8);
+			*pucBuff++ = (uint8) g_uiBurst_Level;
+			*pucBuff++ = (uint8) (g_uiBurst_Pretrigger >> 8);
+			*pucBuff++ = (uint8) g_uiBurst_Pretrigger;
+
+			*pucBuff++ = (uint8) (uiHeld >> 8);
+			*pucBuff++ = (uint8) uiHeld;
+			*pucBuff++ = (uint8) (g_uiBurst_TriggerIdx >> 8);
+			*pucBuff = (uint8) g_uiBurst_TriggerIdx;
+
+			return BURST_INFO_LEN;
+
+		case BURST_OBJ_DATA:
+			if (g_ucBurst_State != BURST_STATE_DONE && g_ucBurst_State != BURST_STATE_TIMEOUT)
+				return XFER_NO_OBJECT;
+
+			// The last segment is short, or empty if the length is a multiple
+			uiBytes = (uiHeld >> 1) + uiHeld;
+			if (uiOffset >= uiBytes)
+				return 0;
+
+			ucLength = ucMaxLen;
+			if (uiBytes - uiOffset < ucMaxLen)
+				ucLength = (uint8) (uiBytes - uiOffset);
+
+			// One divide per segment finds the pair and the byte in it.  The
+			// data starts at the oldest sample held.
+			uiIdx = uiOffset / 3;
+			ucPhase = (uint8) (uiOffset - ((uiIdx << 1) + uiIdx));
+			uiIdx = uiOldest + (uiIdx << 1);
+			if (uiIdx >= BURST_SAMPLES)
+				uiIdx -= BURST_SAMPLES;
+
+			uiFirst = uiBurst_Get(uiIdx);
+			uiSecond = uiBurst_Get((uiIdx + 1 == BURST_SAMPLES) ? 0 : uiIdx + 1);
+
+			for (ucByte = 0; ucByte < ucLength; ucByte++) {
+				switch (ucPhase) {
+					case 0:
+						pucBuff[ucByte] = (uint8) (uiFirst >> 4);
+						break;
+
+					case 1:
+						pucBuff[ucByte] = (uint8) (uiFirst << 4) | (uint8) (uiSecond >> 8);
+						break;
+
+					default:
+						pucBuff[ucByte] = (uint8) uiSecond;
+						break;
+				}
+
+				if (++ucPhase == 3) {
+					ucPhase = 0;
+
+					uiIdx += 2;
+					if (uiIdx >= BURST_SAMPLES)
+						uiIdx -= BURST_SAMPLES;
+
+					uiFirst = uiBurst_Get(uiIdx);
+					uiSecond = uiBurst_Get((uiIdx + 1 == BURST_SAMPLES) ? 0 : uiIdx + 1);
+				}
+			}
+
+			return ucLength;
+
+		default:
+			return XFER_NO_OBJECT;
+	}
+}
+
+//! @}
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file Burst.h
+//! \brief Header file for the burst capture service
+//!
+//! This file provides all of the defines and function prototypes for the
+//! \ref burst
+//!
+//! @addtogroup burst Burst Capture
+//! A reading averages its conversions into one value, so a transient on a
+//! channel is never seen.  The burst capture records up to BURST_SAMPLES raw
+//! 12-bit conversions of one channel at a fixed rate, around a threshold
+//! crossing, so an installation can be diagnosed without a scope on site.
+//!
+//! A command to transducer 0 with the first parameter BURST_OP_CAPTURE runs
+//! a capture:
+//!
+//!   - [BURST_OP_CAPTURE, channel, interval MSB, interval LSB,
+//!      trigger, level MSB, level LSB, pretrigger MSB, pretrigger LSB]
+//!
+//! The interval is in SMCLK ticks (0.25 us), BURST_MIN_INTERVAL to
+//! BURST_MAX_INTERVAL.
+//! The trigger is a BURST_TRIG code, BURST_TRIG_NONE if left out, and the
+//! level is in raw ticks.  The pretrigger is the number of samples kept
+//! ahead of the trigger sample, BURST_SAMPLES / 2 if left out.
+//!
+//! The SP is busy for the whole capture and only confirms the command once
+//! it is over, so a capture never runs longer than BURST_MAX_TICKS.  Without
+//! a trigger it lasts BURST_SAMPLES intervals.  With one it waits for the
+//! trigger for as many more intervals as fit in BURST_MAX_TICKS, at most
+//! BURST_WAIT_SAMPLES, after which the capture ends holding the latest
+//! samples.  At the longer intervals the pretrigger and the wait may come
+//! to fewer than BURST_SAMPLES, and the capture then holds only those.  The
+//! report carries the operation and 0 once the capture is over.
+//!
+//! The CP then reads BURST_OBJ_INFO and BURST_OBJ_DATA with XFER_READ.  The
+//! data holds the number of samples given in the info, oldest first, each
+//! pair in three bytes MSB first: [a11..a4] [a3..a0 b11..b8] [b7..b0].  An
+//! odd number of samples leaves out the oldest.
+//! @{
+//!
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef BURST_H_
+#define BURST_H_
+
+//! \def BURST_OP_CAPTURE
+//! \brief First parameter byte of a transducer 0 command, after the
+//! \ref linktest operations
+#define BURST_OP_CAPTURE		0x03
+
+//! @name Transfer Objects
+//! Transducer 0 objects, after the \ref linktest objects
+//! @{
+//! \def BURST_OBJ_INFO
+//! \brief Read only, the capture settings and result
+#define BURST_OBJ_INFO			0x04
+//! \def BURST_OBJ_DATA
+//! \brief Read only, the packed samples
+#define BURST_OBJ_DATA			0x05
+//! @}
+
+//! @name Trigger Modes
+//! @{
+//! \def BURST_TRIG_NONE
+//! \brief Capture at once, the pretrigger is ignored
+#define BURST_TRIG_NONE			0x00
+//! \def BURST_TRIG_RISING
+//! \brief The first sample at or above the level after one below it
+#define BURST_TRIG_RISING		0x01
+//! \def BURST_TRIG_FALLING
+//! \brief The first sample below the level after one at or above it
+#define BURST_TRIG_FALLING		0x02
+//! @}
+
+//! @name Capture States
+//! @{
+//! \def BURST_STATE_IDLE
+//! \brief Nothing captured yet
+#define BURST_STATE_IDLE		0x00
+//! \def BURST_STATE_RUNNING
+#define BURST_STATE_RUNNING		0x01
+//! \def BURST_STATE_DONE
+//! \brief The capture is complete, around its trigger if it has one
+#define BURST_STATE_DONE		0x02
+//! \def BURST_STATE_TIMEOUT
+//! \brief No trigger in BURST_WAIT_SAMPLES, the latest samples are kept
+#define BURST_STATE_TIMEOUT		0x03
+//! @}
+
+//! @name Capture Limits
+//! @{
+//! \def BURST_SAMPLES
+//! \brief Samples in the buffer, even so they pack in pairs
+#define BURST_SAMPLES			400
+//! \def BURST_BYTES
+//! \brief The size of the packed buffer and of a full BURST_OBJ_DATA
+#define BURST_BYTES				(BURST_SAMPLES / 2 * 3)
+//! \def BURST_MIN_INTERVAL
+//! \brief The shortest interval in SMCLK ticks, 100 us
+#define BURST_MIN_INTERVAL		400
+//! \def BURST_MAX_INTERVAL
+//! \brief The longest interval in SMCLK ticks, 1 ms
+#define BURST_MAX_INTERVAL		4000
+//! \def BURST_WAIT_SAMPLES
+//! \brief The most samples to wait for a trigger once the pretrigger is in
+#define BURST_WAIT_SAMPLES		(4 * BURST_SAMPLES)
+//! \def BURST_MAX_TICKS
+//! \brief The longest capture in SMCLK ticks, 0.5 s
+//!
+//! With the channel settle ahead of it the command is confirmed well inside
+//! the CP's frame timeout, COMM_FRAME_TIMEOUT_TICKS (about 1 s).
+#define BURST_MAX_TICKS			2000000UL
+//! @}
+
+//! @name Info Layout
+//! BURST_OBJ_INFO holds, MSB first:
+//!   - state (1 byte), channel (1), interval (2)
+//!   - trigger (1), level (2), pretrigger (2)
+//!   - the number of samples in the data (2)
+//!   - the index of the trigger sample in the data (2), 0xFFFF if none
+//! @{
+//! \def BURST_INFO_LEN
+#define BURST_INFO_LEN			13
+//! @}
+
+//! @name Burst Capture Functions
+//! @{
+uint16 uiBurst_Command(uint8 ucParamLen, uint8 * pucParam);
+uint8 ucBurst_Sample(uint16 uiSample);
+uint8 ucBurst_XferRead(uint8 ucObject, uint16 uiOffset, volatile uint8 * pucBuff, uint8 ucMaxLen);
+//! @}
+
+#endif /* BURST_H_ */
+//! @}
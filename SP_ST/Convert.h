@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file Convert.h
+//! \brief Header file for the temperature conversion engine
+//!
+//! This file provides all of the defines and function prototypes for the
+//! \ref convert
+//!
+//! @addtogroup convert Temperature Conversion
+//! Turns the raw readings of the \ref SPTC into degrees C x 100 on the SP,
+//! so the CP and the server no longer each have to repeat the zero
+//! subtraction, the thermistor linearization, the cold junction compensation
+//! and the thermocouple polynomial.
+//!
+//! The conversion uses only integer math and piecewise linear tables in
+//! flash:
+//!   - Each thermocouple type has a table of its EMF in uV from
+//!     CONVERT_TC_FIRST to CONVERT_TC_LAST in steps of CONVERT_TC_STEP.  The
+//!     values come from the NIST ITS-90 reference functions.  Interpolating
+//!     between 10 C points is within 0.1 C of the polynomial.
+//!   - The cold junction thermistor has a table of ADC ticks in steps of
+//!     CONVERT_CJ_STEP.
+//!
+//! A thermocouple reading is converted as follows:
+//!   -# The zero reading is subtracted, and the difference is scaled to uV
+//!      at the thermocouple.
+//!   -# The EMF at the cold junction temperature is added.
+//!   -# The total is looked up in the table in reverse.
+//!
+//! Each channel is bound to the table of its type when it is configured, so
+//! a reading costs the same whatever the mix of types on the board.
+//! Readings outside a table return CONVERT_OUT_OF_RANGE.
+//! @{
+//!
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CONVERT_H_
+#define CONVERT_H_
+
+//! @name Thermocouple Types
+//! The ASCII letter of the type
+//! @{
+//! \def CONVERT_TYPE_NONE
+//! \brief Report raw ticks only
+#define CONVERT_TYPE_NONE		0x00
+//! \def CONVERT_TYPE_K
+#define CONVERT_TYPE_K			0x4B //ascii K
+//! \def CONVERT_TYPE_T
+#define CONVERT_TYPE_T			0x54 //ascii T
+//! \def CONVERT_TYPE_J
+#define CONVERT_TYPE_J			0x4A //ascii J
+//! @}
+
+//! \def CONVERT_CHANNELS
+//! \brief The number of thermocouple channels
+#define CONVERT_CHANNELS		4
+
+//! \def CONVERT_OUT_OF_RANGE
+//! \brief Returned for readings that fall outside of a table
+#define CONVERT_OUT_OF_RANGE	((int16) 0x7FFF)
+
+//! @name Front End
+//! The SP-ST front end: a 2.5 V LM4040 reference for the ADC, an OPA2335
+//! with a gain of 1 + 499k / 1k = 500 for the thermocouples, and a 10k 1%
+//! resistor from the reference over a 10k B3950 thermistor to ground.
+//! @{
+//! \def CONVERT_UV_PER_TICK_NUM
+//! \brief uV at the thermocouple per ADC tick, numerator
+//! 2500000 uV / 4096 ticks / 500 = 10000 / 8192 uV
+#define CONVERT_UV_PER_TICK_NUM		10000
+//! \def CONVERT_UV_PER_TICK_SHIFT
+//! \brief uV at the thermocouple per ADC tick, log2 of the denominator
+#define CONVERT_UV_PER_TICK_SHIFT	13
+//! @}
+
+//! @name Table Layout
+//! The temperatures of the table points, in degrees C x 100
+//! @{
+//! \def CONVERT_TC_FIRST
+#define CONVERT_TC_FIRST		-6000
+//! \def CONVERT_TC_STEP
+#define CONVERT_TC_STEP			1000
+//! \def CONVERT_TC_POINTS
+#define CONVERT_TC_POINTS		27
+//! \def CONVERT_TC_LAST
+#define CONVERT_TC_LAST			(CONVERT_TC_FIRST + (CONVERT_TC_POINTS - 1) * CONVERT_TC_STEP)
+//! \def CONVERT_TC_STEP_RECIP
+//! \brief 2^22 / CONVERT_TC_STEP, with a shift of 10 turns an offset into
+//! the step into 1/4096ths
+#define CONVERT_TC_STEP_RECIP	(4194304UL / CONVERT_TC_STEP)
+
+//! \def CONVERT_CJ_FIRST
+//! \brief The thermistor table runs from hot to cold so its ticks rise
+#define CONVERT_CJ_FIRST		8500
+//! \def CONVERT_CJ_STEP
+#define CONVERT_CJ_STEP			-500
+//! \def CONVERT_CJ_POINTS
+#define CONVERT_CJ_POINTS		26
+//! @}
+
+//! @name Conversion Functions
+//! @{
+uint8 ucConvert_Bind(uint8 ucChannel, uint8 ucType);
+uint8 ucConvert_GetType(uint8 ucChannel);
+int16 iConvert_Thermistor(uint16 uiTicks);
+int16 iConvert_Thermocouple(uint8 ucChannel, uint16 uiTicks, uint16 uiZeroTicks, int16 iColdJunction);
+//! @}
+
+#endif /* CONVERT_H_ */
+//! @}
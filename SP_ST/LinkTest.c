@@ -0,0 +1,299 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file LinkTest.c
+//! \brief The link test service of transducer 0
+//!
+//! Serves and checks the LFSR pattern through the transfer objects described
+//! in LinkTest.h.  The counters are kept across the transfer windows of one
+//! run.
+//!
+//! @addtogroup linktest
+//! @{
+//!
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "LinkTest.h"
+
+//******************  Run State  ********************************************//
+//! @name Run State
+//! @{
+//! \var g_ucLinkTest_Op
+//! \brief The operation in progress, 0 if none
+static uint8 g_ucLinkTest_Op = 0;
+
+//! \var g_uiLinkTest_Seed
+static uint16 g_uiLinkTest_Seed;
+
+//! \var g_uiLinkTest_Length
+//! \brief Size of the source object
+static uint16 g_uiLinkTest_Length;
+
+//! \var g_ulLinkTest_Bytes
+//! \brief Bytes served or checked
+static uint32 g_ulLinkTest_Bytes;
+
+//! \var g_uiLinkTest_Segments
+//! \brief Segments served or checked
+static uint16 g_uiLinkTest_Segments;
+
+//! \var g_ulLinkTest_ByteErrors
+static uint32 g_ulLinkTest_ByteErrors;
+
+//! \var g_ulLinkTest_BitErrors
+static uint32 g_ulLinkTest_BitErrors;
+
+//! \var g_uiLinkTest_FirstTick
+//! \brief TAR at the first segment of the run
+static uint16 g_uiLinkTest_FirstTick;
+
+//! \var g_uiLinkTest_LastTick
+//! \brief TAR at the latest segment of the run
+static uint16 g_uiLinkTest_LastTick;
+//! @}
+
+//! \var g_ucaLinkTest_NibbleBits
+//! \brief Number of set bits in the values 0 to 15
+static const uint8 g_ucaLinkTest_NibbleBits[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Reads Timer_A, which the \ref comm Module runs from ACLK
+//!
+//! TAR changes asynchronously to MCLK, so it is read until two reads agree.
+//!   \param none
+//!   \return The ACLK tick count
+///////////////////////////////////////////////////////////////////////////////
+static uint16 uiLinkTest_Ticks(void)
+{
+	uint16 uiNow;
+
+	do {
+		uiNow = TAR;
+	}
+	while (uiNow != TAR);
+
+	return uiNow;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Notes the time of a segment and counts it
+//!   \param ucLength The number of bytes in the segment
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vLinkTest_CountSegment(uint8 ucLength)
+{
+	g_uiLinkTest_LastTick = uiLinkTest_Ticks();
+
+	if (g_uiLinkTest_Segments == 0)
+		g_uiLinkTest_FirstTick = g_uiLinkTest_LastTick;
+
+	g_uiLinkTest_Segments++;
+	g_ulLinkTest_Bytes += ucLength;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the LFSR start value of the segment at an offset
+//!   \param uiOffset The object offset of the segment
+//!   \return The nonzero LFSR state
+///////////////////////////////////////////////////////////////////////////////
+static uint16 uiLinkTest_SegmentSeed(uint16 uiOffset)
+{
+	uint16 uiState;
+
+	uiState = g_uiLinkTest_Seed ^ uiOffset;
+
+	if (uiState == 0)
+		uiState = LINKTEST_ZERO_SEED;
+
+	return uiState;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Clocks the LFSR 8 times and returns the output bits
+//!   \param puiState Pointer to the LFSR state
+//!   \return The next pattern byte
+///////////////////////////////////////////////////////////////////////////////
+static uint8 ucLinkTest_NextByte(uint16 * puiState)
+{
+	uint16 uiState;
+	uint8 ucByte;
+	uint8 ucBit;
+
+	uiState = *puiState;
+	ucByte = 0;
+
+	for (ucBit = 0; ucBit < 8; ucBit++) {
+		ucByte >>= 1;
+
+		if (uiState & 0x0001) {
+			ucByte |= 0x80;
+			uiState = (uiState >> 1) ^ LINKTEST_LFSR_TAPS;
+		}
+		else
+			uiState >>= 1;
+	}
+
+	*puiState = uiState;
+
+	return ucByte;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Writes a 32 bit value MSB first
+//!   \param pucBuff Pointer to the destination
+//!   \param ulValue The value
+//!   \return Pointer past the value
+///////////////////////////////////////////////////////////////////////////////
+static volatile uint8 * pucLinkTest_Put32(volatile uint8 * pucBuff, uint32 ulValue)
+{
+	*pucBuff++ = (uint8) (ulValue >> 24);
+	*pucBuff++ = (uint8) (ulValue >> 16);
+	*pucBuff++ = (uint8) (ulValue >> 8);
+	*pucBuff++ = (uint8) ulValue;
+
+	return pucBuff;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Starts a link test run
+//!
+//! Called for commands to transducer 0.  A command without parameters is the
+//! original test function and reports 0xBEEF.  Otherwise the report carries
+//! the operation and 0 once the run is armed.
+//!
+//!   \param ucParamLen The number of parameter bytes
+//!   \param pucParam The parameters, see LinkTest.h
+//!   \return 0 on success, 1 for bad parameters
+///////////////////////////////////////////////////////////////////////////////
+uint16 uiLinkTest_Command(uint8 ucParamLen, uint8 * pucParam)
+{
+	if (ucParamLen < 3)
+		return 1;
+
+	switch (pucParam[0]) {
+		case LINKTEST_OP_SOURCE:
+			if (ucParamLen < 5)
+				return 1;
+
+			g_uiLinkTest_Length = ((uint16) pucParam[3] << 8) | pucParam[4];
+			break;
+
+		case LINKTEST_OP_SINK:
+			g_uiLinkTest_Length = 0;
+			break;
+
+		default:
+			return 1;
+	}
+
+	g_ucLinkTest_Op = pucParam[0];
+	g_uiLinkTest_Seed = ((uint16) pucParam[1] << 8) | pucParam[2];
+
+	g_ulLinkTest_Bytes = 0;
+	g_uiLinkTest_Segments = 0;
+	g_ulLinkTest_ByteErrors = 0;
+	g_ulLinkTest_BitErrors = 0;
+	g_uiLinkTest_FirstTick = 0;
+	g_uiLinkTest_LastTick = 0;
+
+	// The link statistics count the run only
+	vCOMM_ClearStats();
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Serves the source pattern and the result
+//!
+//!   \param ucObject The object number
+//!   \param uiOffset Byte offset in the object
+//!   \param pucBuff Where the segment goes
+//!   \param ucMaxLen The size of a full segment
+//!   \return The segment length or XFER_NO_OBJECT
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucLinkTest_XferRead(uint8 ucObject, uint16 uiOffset, volatile uint8 * pucBuff, uint8 ucMaxLen)
+{
+	uint16 uiState;
+	uint8 ucLength;
+	uint8 ucIdx;
+
+	switch (ucObject) {
+		case LINKTEST_OBJ_SOURCE:
+			if (g_ucLinkTest_Op != LINKTEST_OP_SOURCE)
+				return XFER_NO_OBJECT;
+
+			// The last segment is short, or empty if the length is a multiple
+			if (uiOffset >= g_uiLinkTest_Length)
+				return 0;
+
+			ucLength = ucMaxLen;
+			if (g_uiLinkTest_Length - uiOffset < ucMaxLen)
+				ucLength = (uint8) (g_uiLinkTest_Length - uiOffset);
+
+			uiState = uiLinkTest_SegmentSeed(uiOffset);
+			for (ucIdx = 0; ucIdx < ucLength; ucIdx++)
+				pucBuff[ucIdx] = ucLinkTest_NextByte(&uiState);
+
+			vLinkTest_CountSegment(ucLength);
+
+			return ucLength;
+
+		case LINKTEST_OBJ_RESULT:
+			// The whole result fits one segment
+			if (uiOffset != 0)
+				return 0;
+
+			*pucBuff++ = g_ucLinkTest_Op;
+			*pucBuff++ = (uint8) (g_uiLinkTest_Seed >> 8);
+			*pucBuff++ = (uint8) g_uiLinkTest_Seed;
+			pucBuff = pucLinkTest_Put32(pucBuff, g_ulLinkTest_Bytes);
+			*pucBuff++ = (uint8) (g_uiLinkTest_Segments >> 8);
+			*pucBuff++ = (uint8) g_uiLinkTest_Segments;
+			pucBuff = pucLinkTest_Put32(pucBuff, g_ulLinkTest_ByteErrors);
+			pucBuff = pucLinkTest_Put32(pucBuff, g_ulLinkTest_BitErrors);
+			*pucBuff++ = (uint8) ((g_uiLinkTest_LastTick - g_uiLinkTest_FirstTick) >> 8);
+			*pucBuff++ = (uint8) (g_uiLinkTest_LastTick - g_uiLinkTest_FirstTick);
+			ucCOMM_FetchStats(pucBuff);
+
+			return LINKTEST_RESULT_LEN;
+
+		default:
+			return XFER_NO_OBJECT;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Checks a sink segment against the pattern
+//!
+//!   \param ucObject The object number
+//!   \param uiOffset Byte offset in the object
+//!   \param pucData The segment data
+//!   \param ucLength The number of bytes
+//!   \return XFER_OK or XFER_ERR_OBJECT
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucLinkTest_XferWrite(uint8 ucObject, uint16 uiOffset, volatile uint8 * pucData, uint8 ucLength)
+{
+	uint16 uiState;
+	uint8 ucDiff;
+	uint8 ucIdx;
+
+	if (ucObject != LINKTEST_OBJ_SINK || g_ucLinkTest_Op != LINKTEST_OP_SINK)
+		return XFER_ERR_OBJECT;
+
+	uiState = uiLinkTest_SegmentSeed(uiOffset);
+
+	for (ucIdx = 0; ucIdx < ucLength; ucIdx++) {
+		ucDiff = pucData[ucIdx] ^ ucLinkTest_NextByte(&uiState);
+
+		if (ucDiff) {
+			g_ulLinkTest_ByteErrors++;
+			g_ulLinkTest_BitErrors += g_ucaLinkTest_NibbleBits[ucDiff & 0x0F] + g_ucaLinkTest_NibbleBits[ucDiff >> 4];
+		}
+	}
+
+	vLinkTest_CountSegment(ucLength);
+
+	return XFER_OK;
+}
+
+//! @}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file LinkTest.h
+//! \brief Header file for the link test service
+//!
+//! This file provides all of the defines and function prototypes for the
+//! \ref linktest
+//!
+//! @addtogroup linktest Link Test
+//! The link test service runs on transducer 0.  It lets the CP measure the
+//! throughput and error rate of the bus to this SP, so that each cable run
+//! can be given the fastest reliable SCL.
+//!
+//! A command to transducer 0 with no parameters still returns 0xBEEF.  With
+//! parameters, the first byte selects the operation:
+//!
+//!   - [LINKTEST_OP_SOURCE, seed MSB, seed LSB, length MSB, length LSB]
+//!     The CP reads LINKTEST_OBJ_SOURCE with XFER_READ, and gets length
+//!     bytes of pattern.
+//!   - [LINKTEST_OP_SINK, seed MSB, seed LSB]
+//!     The CP writes the pattern to LINKTEST_OBJ_SINK with XFER_WRITE, and the
+//!     SP compares every segment.
+//!
+//! Both operations clear the counters and the link statistics.  The result
+//! can be read at any time from LINKTEST_OBJ_RESULT.
+//!
+//! The pattern is a 16 bit Galois LFSR (x^16 + x^14 + x^13 + x^11 + 1).  Its
+//! output bits go out LSB first, 8 to a byte.  Every segment restarts the
+//! LFSR from seed XOR the object offset of the segment, or LINKTEST_ZERO_SEED
+//! when that is 0.  A segment that is read again is therefore the same.
+//!
+//! Frames that fail their CRC never reach the application.  The result also
+//! holds the link statistics, so the CP gets the frame error rate in both
+//! directions.  It can compute its own bit error rate on the source pattern.
+//! The SP counts byte and bit errors in the sink segments that passed the
+//! CRC.
+//! @{
+//!
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LINKTEST_H_
+#define LINKTEST_H_
+
+//! @name Operations
+//! First parameter byte of a transducer 0 command
+//! @{
+//! \def LINKTEST_OP_SOURCE
+//! \brief Serve the pattern through LINKTEST_OBJ_SOURCE
+#define LINKTEST_OP_SOURCE		0x01
+//! \def LINKTEST_OP_SINK
+//! \brief Verify the pattern written to LINKTEST_OBJ_SINK
+#define LINKTEST_OP_SINK		0x02
+//! @}
+
+//! @name Transfer Objects
+//! @{
+//! \def LINKTEST_OBJ_SOURCE
+//! \brief Read only, the pattern
+#define LINKTEST_OBJ_SOURCE		0x01
+//! \def LINKTEST_OBJ_SINK
+//! \brief Write only, checked against the pattern
+#define LINKTEST_OBJ_SINK		0x02
+//! \def LINKTEST_OBJ_RESULT
+//! \brief Read only, the result
+#define LINKTEST_OBJ_RESULT		0x03
+//! @}
+
+//! \def LINKTEST_ZERO_SEED
+//! \brief LFSR start value used in place of 0
+#define LINKTEST_ZERO_SEED		0xACE1
+
+//! \def LINKTEST_LFSR_TAPS
+//! \brief Feedback mask of the Galois LFSR
+#define LINKTEST_LFSR_TAPS		0xB400
+
+//! @name Result Layout
+//! LINKTEST_OBJ_RESULT holds, MSB first:
+//!   - operation (1 byte), seed (2)
+//!   - bytes moved (4), segments moved (2)
+//!   - byte errors (4), bit errors (4), sink only
+//!   - ACLK ticks from the first to the last segment (2)
+//!   - the link statistics as in REQUEST_DIAGNOSTICS (2 per counter)
+//! @{
+//! \def LINKTEST_RESULT_LEN
+#define LINKTEST_RESULT_LEN		(19 + COMM_STAT_COUNT * 2)
+//! @}
+
+//! @name Link Test Functions
+//! @{
+uint16 uiLinkTest_Command(uint8 ucParamLen, uint8 * pucParam);
+uint8 ucLinkTest_XferRead(uint8 ucObject, uint16 uiOffset, volatile uint8 * pucBuff, uint8 ucMaxLen);
+uint8 ucLinkTest_XferWrite(uint8 ucObject, uint16 uiOffset, volatile uint8 * pucData, uint8 ucLength);
+//! @}
+
+#endif /* LINKTEST_H_ */
+//! @}
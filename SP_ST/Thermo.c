@@ -1,396 +1,1087 @@
-//*************************************************************************************
-//
-// \file Thermo.c
-// \brief This is the primary run file for the Thermocopule Sattelite Processor board
-//
-// By:   Jeremy Anderson
-//       Wireless Networks Research Lab
-//       Dept. Of Electrical Engineering, CEFNS
-//       Northern Arizona University
-//
-//
-// Fixed by CP
-//
-//*************************************************************************************
-
-
-#include "Thermo.h"
-#include "msp430f235.h"
-
-//! \var gui_ZeroReading
-//! \brief global which stores the offset value
-extern unsigned int gui_ZeroReading;
-
-//! \var gui_ThermistorReading
-//! \brief global which stores the thermistor value
-extern unsigned int gui_ThermistorReading;
-
-//! \def NUM_SAMPLES
-//! \brief Number of samples taken by the ADC in repeat-single-channel mode
-#define   NUM_SAMPLES   10
-
-//! \var gui_ADCResults
-//! \brief Array that stores the results of the ADC measurements
-volatile unsigned int gui_ADCResults[NUM_SAMPLES];
-
-//! \var guc_ADCSampleIndex
-//! \brief Index into the ADC results array
-static unsigned char guc_ADCSampleIndex = 0;
-
-//! \var *ADC_GainFactor
-//! \var *ADC_Offset
-//! \brief ADC calibration constants
-//! Each MCU can have unique calibration constants stored in memory.  An ADC reading is adjusted using the following equation:
-//! ADC(adjusted) = ADC(raw)*ADC_GainFactor/2^15 + *ADC_Offset
-signed int *ADC_GainFactor = (signed int*)0x10DC;
-signed int *ADC_Offset = (signed int*)0x10DE;
-
-//! \var iDivider
-//! \brief Divides the ADC reading after it is multiplied by the gain factor (2^15)
-signed int iDivider = 0x8000;
-
-
-//////////////////////////////////////////////////
-//!
-//! \brief initializes the ADC for use
-//!
-//! This function does not use variables
-//!
-//////////////////////////////////////////////////
-void vADCInit()
-{
-
-	VREF_EN &= ~VREF_PIN; 							// Turn on vref
-	ZERO_EN |= ZERO_PIN;  							// Turn on the zero path important to keep the output non-railed
-	EN_CH |= (CH4_ENABLE_BIT | CH3_ENABLE_BIT |CH2_ENABLE_BIT |CH1_ENABLE_BIT); //turn off all TC channels
-
-	// Sample hold time = 1024 cycles, multiple sample conversion = true, internal reference off
-	ADC12CTL0 = (SHT0_15 | MSC);
-	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
-
-	// sample-hold = SC bit, ADC clock source = SMCLK, clock divider = 8, Repeat single channel mode
-	ADC12CTL1 = (SHS_0 | SHP | ADC12SSEL_3 | CONSEQ_2 | ADC12DIV_7);
-
-	// Selects input channel A3, and chooses external reference
-	ADC12MCTL0 |=  SREF_7;
-}
-
-
-////////////////////////////////////////////////////////////
-//!
-//! \brief Enters the chosen LPM for the desired time.
-//!
-//!
-//! \param uiDelay, ucLowPowerMode
-///////////////////////////////////////////////////////////
-void vThermo_LPMDelay(unsigned int uiDelay, unsigned char ucLowPowerMode)
-{
-
-	TBCTL = (TBSSEL_2 | ID_3 | TBCLR);
-	TBCCR1 = uiDelay;
-	TBCCTL1 &= ~CCIFG;
-	TBCCTL1 |= CCIE;
-	TBCTL |= MC_2;
-
-	switch (ucLowPowerMode) {
-		case 0:
-			LPM0;
-		break;
-
-		case 1:
-			LPM1;
-		break;
-
-		case 2:
-			LPM2;
-		break;
-
-		case 3:
-			LPM3;
-		break;
-
-		default:
-			LPM0;
-		break;
-
-	}
-
-	TBCCTL1 = 0x00;
-	TBCTL = 0x00;
-}
-
-
-
-/////////////////////////////////////////////////////////////
-//!
-//! \brief Reads the requested thermocouple channel
-//!
-//!
-//! \return uiADCTicks
-//!
-////////////////////////////////////////////////////////////
-unsigned int uiThermo_ReadChannel(unsigned char ucChannel)
-{
-	unsigned int uiADCTicks;
-	unsigned char ucChannelIdx;
-	unsigned char ucChEnableBits[5] = {CH1_ENABLE_BIT, CH2_ENABLE_BIT, CH3_ENABLE_BIT, CH4_ENABLE_BIT};
-	unsigned long ulADC_val;
-	signed long lTemp;
-	unsigned char ucIndex;
-
-
-	ucChannelIdx = ucChannel-1;
-	ZERO_EN &= ~ZERO_PIN;				//Disable Zero ref
-	EN_CH &= ~ucChEnableBits[ucChannelIdx];					//Enables channel 0
-	vThermo_LPMDelay(62500, 1);  		//Delay to make sure the reading is independent from last
-	ADC12MCTL0 |= INCH_3;				//Put on the right ADC input
-	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
-	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
-
-	// Clean the ADC results array
-	for (ucIndex = 0; ucIndex < NUM_SAMPLES; ucIndex++){
-		gui_ADCResults[ucIndex] = 0;
-	}
-
-	// Reset the sample index
-	guc_ADCSampleIndex = 0;
-
-	// Clear interrupt flag and enable interrupts for mem0
-	ADC12IFG = 0x00;
-	ADC12IE = BIT0;
-
-	// Start conversions
-	ADC12CTL0 |= (ADC12SC | ENC);
-
-	// Sleep until conversion is complete
-  LPM1;
-
-	// Disable conversions
-	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
-
-	// Clear input channel for mem0
-	ADC12MCTL0 &= ~INCH_3;
-
-	ZERO_EN |= ZERO_PIN;				//Enable Zero ref
-	EN_CH |= ucChEnableBits[ucChannelIdx];					//Disable channel 0
-
-	// Average the sequence of readings
-  ulADC_val = 0;
-	for (ucIndex = 0; ucIndex < NUM_SAMPLES; ucIndex++)
-	{
-		lTemp = gui_ADCResults[ucIndex];
-		lTemp *= *ADC_GainFactor;
-		lTemp /= iDivider;
-		lTemp += *ADC_Offset;
-		ulADC_val += (unsigned long)lTemp;
-	}
-	uiADCTicks = (unsigned int) ulADC_val/NUM_SAMPLES;
-
-	// Round up when required
-	if((ulADC_val % 10) >= 5 )
-		uiADCTicks++;
-
-	return uiADCTicks;
-}
-
-
-///////////////////////////////////////////////////////////
-//!
-//! \brief Reads the thermocouple offset
-//!
-//! \param none
-//!
-//! \return stores the offset reading in gui_ZeroReading
-//!
-////////////////////////////////////////////////////////////
-void vZeroReading()
-{
-	unsigned long ulADC_val;
-	signed long lTemp;
-	unsigned char ucIndex;
-
-	ADC12MCTL0 |= INCH_3;				//Put on the right ADC input
-	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
-	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
-	vThermo_LPMDelay(62500, 1);  		//Delay to make sure the reading is independent from last
-	vThermo_LPMDelay(62500, 1);  		//Delay to make sure the reading is independent from last
-
-	// Clear ADC results buffer
-	for (ucIndex = 0; ucIndex < NUM_SAMPLES; ucIndex++){
-		gui_ADCResults[ucIndex] = 0;
-	}
-
-	// Reset the sample index
-	guc_ADCSampleIndex = 0;
-
-	// Clear interrupt flag and enable interrupts for mem0
-	ADC12IFG = 0x00;
-	ADC12IE |= BIT0;
-
-	// Start conversions
-	ADC12CTL0 |= (ADC12SC | ENC);
-
-	// Sleep until conversion is complete
-  LPM1;
-
-	// Disable conversions and shutdown ADC
-	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
-
-	// Clear input channel for MEM0
-	ADC12MCTL0 &= ~INCH_3;
-
-  // Average the sequence of readings
-  ulADC_val = 0;
-	for (ucIndex = 0; ucIndex < NUM_SAMPLES; ucIndex++)
-	{
-		lTemp = gui_ADCResults[ucIndex];
-		lTemp *= *ADC_GainFactor;
-		lTemp = lTemp / iDivider;
-		lTemp += *ADC_Offset;
-		ulADC_val += ((unsigned long)lTemp);
-	}
-	gui_ZeroReading = ((unsigned int) ulADC_val/NUM_SAMPLES);
-
-	// Round up when required
-	if((ulADC_val % 10) >= 5 )
-		gui_ZeroReading++;
-}
-
-
-//////////////////////////////////////////////////////////
-//!
-//! \brief Reads the thermistor voltage
-//!
-//! \param none
-//!
-//! \return stores the thermistor reading in gui_ThermistorReading
-//!
-///////////////////////////////////////////////////////////
-void vThermistorReading()
-{
-
-	unsigned long ulADC_val;
-	signed long lTemp;
-	unsigned char ucIndex;
-
-	CJC_EN &= ~CJC_PIN;					//Enable thermistor
-	ADC12MCTL0 |= INCH_7;				//turn on right ADC input
-	ADC12CTL0 |= SHT0_7;
-	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
-	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
-
-	// Rise time for thermistor is approximately 3 ms at 24 degrees C , we give it some slack
-	vThermo_LPMDelay(10000, 1);
-
-	// Clear the ADC results buffer
-	for (ucIndex = 0; ucIndex < NUM_SAMPLES; ucIndex++) {
-		gui_ADCResults[ucIndex] = 0;
-	}
-
-	// Reset the sample index
-	guc_ADCSampleIndex = 0;
-
-	// Clear interrupt flag and enable interrupts for mem0
-	ADC12IFG = 0x00;
-	ADC12IE |= BIT0;
-
-	// Start conversions
-	ADC12CTL0 |= (ADC12SC | ENC);
-
-	// Sleep until conversion is complete
-  LPM1;
-
-	// Disable thermister
-	CJC_EN |= CJC_PIN;
-
-	// Disable conversions and shutdown ADC
-	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
-
-	// Deselect the channel for mem0
-	ADC12MCTL0 &= ~INCH_7;
-
-  // Average the sequence of readings
-  ulADC_val = 0;
-	for (ucIndex = 0; ucIndex < NUM_SAMPLES; ucIndex++)
-	{
-		lTemp = gui_ADCResults[ucIndex];
-		lTemp *= *ADC_GainFactor;
-		lTemp /= iDivider;
-		lTemp += *ADC_Offset;
-		ulADC_val += (unsigned long)lTemp;
-	}
-
-	gui_ThermistorReading = (unsigned int) ulADC_val/NUM_SAMPLES;
-
-	// Round up when required
-	if((ulADC_val % 10) >= 5 )
-		gui_ThermistorReading++;
-}
-
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Triggers when an ADC reading is complete and brings the board out of LPM when
-//!				 conversions are complete
-//!
-//////////////////////////////////////////////////////////////////////////////////////////////////////
-#pragma vector = ADC12_VECTOR;
-__interrupt void ADC_Conversion(void)
-{
-	switch (__even_in_range(ADC12IV, 34))
-	{
-		case ADC12IV_NONE:
-		break;
-		case ADC12IV_ADC12OVIFG:
-		break;
-		case ADC12IV_ADC12TOVIFG:
-		break;
-		case ADC12IV_ADC12IFG0:
-			gui_ADCResults[guc_ADCSampleIndex] = ADC12MEM0; // Move results
-			guc_ADCSampleIndex++; // Increment results index
-
-			// If we have reached the desired number of conversions then wake the CPU
-			if (guc_ADCSampleIndex == NUM_SAMPLES)
-			{
-				// Reset the sample index
-				guc_ADCSampleIndex = 0;
-				ADC12IE &= ~BIT0;
-				__bic_SR_register_on_exit(LPM3_bits);
-			}
-		break;
-		case ADC12IV_ADC12IFG1:
-		break;
-		case ADC12IV_ADC12IFG2:
-		break;
-		case ADC12IV_ADC12IFG3:
-		break;
-		case ADC12IV_ADC12IFG4:
-		break;
-		case ADC12IV_ADC12IFG5:
-		break;
-		case ADC12IV_ADC12IFG6:
-		break;
-		case ADC12IV_ADC12IFG7:
-		break;
-		case ADC12IV_ADC12IFG8:
-		break;
-		case ADC12IV_ADC12IFG9:
-		break;
-		case ADC12IV_ADC12IFG10:
-		break;
-		case ADC12IV_ADC12IFG11:
-		break;
-		case ADC12IV_ADC12IFG12:
-		break;
-		case ADC12IV_ADC12IFG13:
-		break;
-		case ADC12IV_ADC12IFG14:
-		break;
-		case ADC12IV_ADC12IFG15:
-		break;
-
-	}
-}
-
-//! @}
-
+//*************************************************************************************
+//
+// \file Thermo.c
+// \brief This is the primary run file for the Thermocopule Sattelite Processor board
+//
+// By:   Jeremy Anderson
+//       Wireless Networks Research Lab
+//       Dept. Of Electrical Engineering, CEFNS
+//       Northern Arizona University
+//
+//
+// Fixed by CP
+//
+//*************************************************************************************
+
+
+#include "Thermo.h"
+#include "hal.h"
+#include "core.h"
+#include "Burst.h"
+
+//! \var gui_ZeroReading
+//! \brief global which stores the offset value
+extern unsigned int gui_ZeroReading;
+
+//! \var gui_ThermistorReading
+//! \brief global which stores the thermistor value
+extern unsigned int gui_ThermistorReading;
+
+//! \def NUM_SAMPLES
+//! \brief Number of samples taken by the ADC in repeat-single-channel mode
+#define   NUM_SAMPLES   THERMO_SAMPLES
+
+//! \def TRIM_SHIFT
+//! \brief log2 of the samples left once the lowest and highest are dropped
+#define   TRIM_SHIFT    3
+
+#if (NUM_SAMPLES - 2) != (1 << TRIM_SHIFT)
+	#error "TRIM_SHIFT does not match NUM_SAMPLES"
+#endif
+
+#if THERMO_FULL_SCALE != 4095
+	#error "The ratiometric scaling assumes THERMO_FULL_SCALE is 2^12 - 1"
+#endif
+
+//! @name Sample Accumulator
+//! The ADC ISR folds every conversion in as it arrives, so no buffer of
+//! samples is kept.  NUM_SAMPLES 12-bit samples fit the 16-bit sum.
+//! @{
+//! \var gui_ADCSum
+//! \brief Sum of the samples of the sequence
+static volatile unsigned int gui_ADCSum;
+
+//! \var gui_ADCMin
+//! \brief Lowest sample of the sequence
+static volatile unsigned int gui_ADCMin;
+
+//! \var gui_ADCMax
+//! \brief Highest sample of the sequence
+static volatile unsigned int gui_ADCMax;
+//! @}
+
+//! \var guc_ADCSampleIndex
+//! \brief Number of samples taken in the sequence
+static unsigned char guc_ADCSampleIndex = 0;
+
+//! \var g_uiThermo_SyncInterval
+//! \brief SMCLK ticks between mains synchronous samples, 0 when free running
+static unsigned int g_uiThermo_SyncInterval = 0;
+
+//! \var g_ucThermo_Burst
+//! \brief Nonzero while the ADC ISR hands every sample to the \ref burst
+static unsigned char g_ucThermo_Burst = 0;
+
+//! @name Ratiometric Mode
+//! @{
+//! \var g_ucThermo_Ratiometric
+//! \brief Nonzero to scale readings to the ADC's own conversions of the
+//! references instead of the factory calibration
+static unsigned char g_ucThermo_Ratiometric = 0;
+
+//! \var g_uiThermo_RefHigh
+//! \brief Raw ticks of VeREF+ from the latest reading
+static unsigned int g_uiThermo_RefHigh;
+
+//! \var g_uiThermo_RefLow
+//! \brief Raw ticks of VeREF- from the latest reading
+static unsigned int g_uiThermo_RefLow;
+//! @}
+
+//! \var g_uiaThermo_IIR
+//! \brief The low-pass state of each channel in ticks x 16, 0 until seeded
+static unsigned int g_uiaThermo_IIR[4];
+
+//! \var *ADC_GainFactor
+//! \var *ADC_Offset
+//! \brief ADC calibration constants
+//! Each MCU can have unique calibration constants stored in memory.  An ADC reading is adjusted using the following equation:
+//! ADC(adjusted) = ADC(raw)*ADC_GainFactor/2^15 + *ADC_Offset
+//! The gain factor is unsigned, near 2^15.  They are read once, into the
+//! merged calibration.
+uint16 *ADC_GainFactor = HAL_PTR(uint16, 0x10DC);
+int16 *ADC_Offset = HAL_PTR(int16, 0x10DE);
+
+//! \var g_ucaThermo_ChEnable
+//! \brief The enable bit of each channel, active low
+static const unsigned char g_ucaThermo_ChEnable[4] = {CH1_ENABLE_BIT, CH2_ENABLE_BIT, CH3_ENABLE_BIT, CH4_ENABLE_BIT};
+
+//! \var g_ucaThermo_Health
+//! \brief The last classification of each channel
+static unsigned char g_ucaThermo_Health[4] = {THERMO_HEALTH_UNKNOWN, THERMO_HEALTH_UNKNOWN, THERMO_HEALTH_UNKNOWN, THERMO_HEALTH_UNKNOWN};
+
+//! \def GAIN_SHIFT
+//! \brief Divides the ADC reading after it is multiplied by the gain factor (2^15)
+#define   GAIN_SHIFT    15
+
+//! @name Channel Calibration
+//! The gain (x 2^15) and offset of each channel on top of the factory
+//! calibration, as stored in flash
+//! @{
+//! \var g_uiaThermo_CalGain
+static unsigned int g_uiaThermo_CalGain[4];
+
+//! \var g_iaThermo_CalOffset
+static signed int g_iaThermo_CalOffset[4];
+//! @}
+
+//! @name Merged Calibration
+//! The factory and channel calibrations folded into one gain and offset, so
+//! a reading costs one multiply and shift.  Index 0 holds the factory
+//! calibration alone for the zero and thermistor readings, 1 to 4 the
+//! channels.
+//! @{
+//! \var g_uiaThermo_Gain
+static unsigned int g_uiaThermo_Gain[5];
+
+//! \var g_iaThermo_Offset
+static signed int g_iaThermo_Offset[5];
+//! @}
+
+//! @name Calibration Capture
+//! The points of the two point calibration in progress
+//! @{
+//! \var g_ucThermo_CalChannel
+//! \brief The channel the points belong to, 0 if none
+static unsigned char g_ucThermo_CalChannel = 0;
+
+//! \var g_ucThermo_CalPoints
+//! \brief One bit per captured point
+static unsigned char g_ucThermo_CalPoints = 0;
+
+//! \var g_uiaThermo_CalRead
+//! \brief The factory calibrated reading at each point
+static unsigned int g_uiaThermo_CalRead[2];
+
+//! \var g_uiaThermo_CalTarget
+//! \brief The reading each point should give
+static unsigned int g_uiaThermo_CalTarget[2];
+
+//! \var g_ucThermo_Capture
+//! \brief Nonzero while a reading is taken with the factory calibration only
+static unsigned char g_ucThermo_Capture = 0;
+//! @}
+
+
+//////////////////////////////////////////////////
+//!
+//! \brief initializes the ADC for use
+//!
+//! This function does not use variables
+//!
+//////////////////////////////////////////////////
+void vADCInit()
+{
+
+	VREF_EN &= ~VREF_PIN; 							// Turn on vref
+	ZERO_EN |= ZERO_PIN;  							// Turn on the zero path important to keep the output non-railed
+	EN_CH |= (CH4_ENABLE_BIT | CH3_ENABLE_BIT |CH2_ENABLE_BIT |CH1_ENABLE_BIT); //turn off all TC channels
+
+	// Sample hold time = 1024 cycles, multiple sample conversion = true, internal reference off
+	ADC12CTL0 = (SHT0_15 | MSC);
+	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
+
+	// sample-hold = SC bit, ADC clock source = SMCLK, clock divider = 8, Repeat single channel mode
+	ADC12CTL1 = (SHS_0 | SHP | ADC12SSEL_3 | CONSEQ_2 | ADC12DIV_7);
+
+	// Selects input channel A3, and chooses external reference
+	ADC12MCTL0 |=  SREF_7;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Enters the chosen LPM for the desired time.
+//!
+//!
+//! \param uiDelay, ucLowPowerMode
+///////////////////////////////////////////////////////////
+void vThermo_LPMDelay(unsigned int uiDelay, unsigned char ucLowPowerMode)
+{
+
+	TBCTL = (TBSSEL_2 | ID_3 | TBCLR);
+	TBCCR1 = uiDelay;
+	TBCCTL1 &= ~CCIFG;
+	TBCCTL1 |= CCIE;
+	TBCTL |= MC_2;
+
+	switch (ucLowPowerMode) {
+		case 0:
+			LPM0;
+		break;
+
+		case 1:
+			LPM1;
+		break;
+
+		case 2:
+			LPM2;
+		break;
+
+		case 3:
+			LPM3;
+		break;
+
+		default:
+			LPM0;
+		break;
+
+	}
+
+	TBCCTL1 = 0x00;
+	TBCTL = 0x00;
+}
+
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Sets the mains synchronous sampling mode
+//!
+//! The mode holds for every reading that follows, including the zero and
+//! thermistor readings.
+//!
+//! \param ucMains, THERMO_MAINS_NONE, THERMO_MAINS_50HZ or THERMO_MAINS_60HZ;
+//! ucPeriods, the number of mains periods to spread the samples over
+//! \return 0 on success, 1 for a bad mode
+//!
+////////////////////////////////////////////////////////////
+unsigned char ucThermo_SetMainsSync(unsigned char ucMains, unsigned char ucPeriods)
+{
+	unsigned int uiInterval;
+
+	switch (ucMains)
+	{
+		case THERMO_MAINS_NONE:
+			uiInterval = 0;
+		break;
+
+		case THERMO_MAINS_50HZ:
+			uiInterval = THERMO_50HZ_INTERVAL;
+		break;
+
+		case THERMO_MAINS_60HZ:
+			uiInterval = THERMO_60HZ_INTERVAL;
+		break;
+
+		default:
+			return 1;
+	}
+
+	if (uiInterval != 0)
+	{
+		if (ucPeriods == 0 || ucPeriods > THERMO_MAX_PERIODS)
+			return 1;
+
+		uiInterval *= ucPeriods;
+	}
+
+	g_uiThermo_SyncInterval = uiInterval;
+
+	return 0;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Runs conversions on the Timer_B OUT1 trigger until the ISR wakes
+//!
+//! The input must be selected, the ADC turned on and the ISR enabled.
+//! Timer_B runs from SMCLK, which is derived from the calibrated DCO.
+//!
+//! \param uiInterval, SMCLK ticks between conversions; uiSampleHold, the
+//! SHT0 bits, the sample must fit the interval
+//!
+////////////////////////////////////////////////////////////
+static void vThermo_ConvertTimed(unsigned int uiInterval, unsigned int uiSampleHold)
+{
+	unsigned int uiCtl0;
+
+	// Every sample waits for its trigger
+	uiCtl0 = ADC12CTL0;
+	ADC12CTL0 = (uiCtl0 & ~(MSC | SHT0_15)) | uiSampleHold;
+	ADC12CTL1 |= SHS_3;
+
+	// OUT1 rises at every roll over of TBCCR0
+	TBCCR0 = uiInterval - 1;
+	TBCCR1 = uiInterval >> 1;
+	TBCCTL1 = OUTMOD_7;
+	TBCTL = (TBSSEL_2 | ID_0 | TBCLR);
+
+	// Arm the ADC, then start the trigger
+	ADC12CTL0 |= ENC;
+	TBCTL |= MC_1;
+
+	// Sleep until the ISR has what it needs
+	LPM1;
+
+	TBCTL = 0x00;
+	TBCCTL1 = 0x00;
+
+	// Back to software triggers
+	ADC12CTL0 &= ~ENC;
+	ADC12CTL1 &= ~SHS_3;
+	ADC12CTL0 = uiCtl0;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Clears the accumulator and starts a sequence of conversions
+//!
+//! The input must be selected and the ADC turned on.  Returns once the ISR
+//! has folded in NUM_SAMPLES conversions.
+//!
+//! Free running, the conversions follow each other as fast as the sample
+//! and hold time allows.  In a mains synchronous mode Timer_B OUT1 triggers
+//! each conversion, so the samples sit at evenly spaced phases of whole
+//! mains periods and the hum sums to zero.
+//!
+////////////////////////////////////////////////////////////
+static void vThermo_Convert(void)
+{
+	// Clear the accumulator
+	gui_ADCSum = 0;
+	gui_ADCMin = 0xFFFF;
+	gui_ADCMax = 0;
+
+	// Reset the sample index
+	guc_ADCSampleIndex = 0;
+
+	// Clear interrupt flag and enable interrupts for mem0
+	ADC12IFG = 0x00;
+	ADC12IE |= BIT0;
+
+	if (g_uiThermo_SyncInterval == 0)
+	{
+		// Start conversions
+		ADC12CTL0 |= (ADC12SC | ENC);
+
+		// Sleep until conversion is complete
+		LPM1;
+		return;
+	}
+
+	vThermo_ConvertTimed(g_uiThermo_SyncInterval, THERMO_SYNC_SHT);
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Converts the references for a ratiometric reading
+//!
+//! VeREF+ and VeREF- are converted under SREF_7 like the readings, that is
+//! against themselves.  Ideally they read full scale and 0.  What they read
+//! instead is the gain and offset error of the ADC at its present
+//! temperature, which the scaling in uiThermo_Filter() takes out.  A drift of
+//! the external reference itself does not show in them and is not
+//! corrected.  Does nothing unless the ratiometric mode is on.
+//!
+////////////////////////////////////////////////////////////
+static void vThermo_ConvertReferences(void)
+{
+	if (g_ucThermo_Ratiometric == 0)
+		return;
+
+	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
+	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
+
+	ADC12MCTL0 |= INCH_8;				//VeREF+
+	vThermo_Convert();
+	ADC12CTL0 &= ~(ADC12SC | ENC);
+	ADC12MCTL0 &= ~INCH_8;
+	g_uiThermo_RefHigh = (gui_ADCSum - gui_ADCMin - gui_ADCMax + (1 << (TRIM_SHIFT - 1))) >> TRIM_SHIFT;
+
+	ADC12MCTL0 |= INCH_9;				//VeREF-
+	vThermo_Convert();
+	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
+	ADC12MCTL0 &= ~INCH_9;
+	g_uiThermo_RefLow = (gui_ADCSum - gui_ADCMin - gui_ADCMax + (1 << (TRIM_SHIFT - 1))) >> TRIM_SHIFT;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Turns the ratiometric mode on or off
+//!
+//! With the mode on, every channel and zero reading converts the references
+//! first and is scaled to them instead of the factory ADC_GainFactor and
+//! ADC_Offset.  This tracks the ADC's own gain and offset as the temperature
+//! of the part moves, see vThermo_ConvertReferences().  The application
+//! reads the zero again under the mode, once per scan of the channels.
+//!
+//! \param ucOn, nonzero to turn the mode on
+//!
+////////////////////////////////////////////////////////////
+void vThermo_SetRatiometric(unsigned char ucOn)
+{
+	g_ucThermo_Ratiometric = ucOn;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Returns nonzero if the ratiometric mode is on
+//!
+////////////////////////////////////////////////////////////
+unsigned char ucThermo_GetRatiometric(void)
+{
+	return g_ucThermo_Ratiometric;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Divides the sum of a sequence by NUM_SAMPLES, rounded
+//!
+//! There is no hardware multiplier, so for 10 samples the quotient is
+//! estimated with shifts and adds (sum x 0.8 / 8) and corrected by one step
+//! instead of calling the runtime divide.  Other sample counts divide.
+//!
+//! \param uiSum, the sum of the samples
+//! \return the mean
+//!
+////////////////////////////////////////////////////////////
+static unsigned int uiThermo_DivSamples(unsigned int uiSum)
+{
+#if NUM_SAMPLES == 10
+	unsigned int uiQuot;
+
+	uiSum += NUM_SAMPLES / 2;
+
+	uiQuot = (uiSum >> 1) + (uiSum >> 2);
+	uiQuot += uiQuot >> 4;
+	uiQuot += uiQuot >> 8;
+	uiQuot >>= 3;
+
+	// The estimate is at most one low
+	if (uiSum - ((uiQuot << 3) + (uiQuot << 1)) > 9)
+		uiQuot++;
+
+	return uiQuot;
+#else
+	return (uiSum + NUM_SAMPLES / 2) / NUM_SAMPLES;
+#endif
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Applies the filter to the accumulated sequence
+//!
+//! The calibration is linear, so it is applied once to the filtered value
+//! instead of to each sample.  The channel selects the merged calibration.
+//!
+//! \param ucFilter, the THERMO_FILTER; ucChannel, the channel whose
+//! low-pass state to use, 0 for none
+//! \return the calibrated ticks
+//!
+////////////////////////////////////////////////////////////
+static unsigned int uiThermo_Filter(unsigned char ucFilter, unsigned char ucChannel)
+{
+	unsigned int uiADCTicks;
+	unsigned int *puiState;
+	unsigned char ucCal;
+	signed long lTemp;
+
+	// A calibration capture is measured against the factory calibration
+	ucCal = g_ucThermo_Capture ? 0 : ucChannel;
+
+	if (ucFilter == THERMO_FILTER_MEAN)
+	{
+		uiADCTicks = uiThermo_DivSamples(gui_ADCSum);
+	}
+	else
+	{
+		// Drop the lowest and the highest sample, a single spike is one of them
+		uiADCTicks = (gui_ADCSum - gui_ADCMin - gui_ADCMax + (1 << (TRIM_SHIFT - 1))) >> TRIM_SHIFT;
+
+		// Follow the trimmed mean of the successive reads of the channel
+		if (ucFilter == THERMO_FILTER_IIR && ucChannel != 0)
+		{
+			puiState = &g_uiaThermo_IIR[ucChannel - 1];
+
+			if (*puiState == 0)
+				*puiState = uiADCTicks << 4;
+			else
+				*puiState += (signed int) (((signed long) (uiADCTicks << 4) - (signed long) *puiState) >> THERMO_IIR_SHIFT);
+
+			uiADCTicks = (*puiState + 8) >> 4;
+		}
+	}
+
+	if (g_ucThermo_Ratiometric && g_uiThermo_RefHigh > g_uiThermo_RefLow)
+	{
+		// Scale to the span between the references converted with this reading
+		lTemp = (signed long) uiADCTicks - g_uiThermo_RefLow;
+		if (lTemp < 0)
+			lTemp = 0;
+
+		// THERMO_FULL_SCALE is 2^12 - 1, the span is only known at run time
+		lTemp = ((lTemp << 12) - lTemp + ((g_uiThermo_RefHigh - g_uiThermo_RefLow) >> 1)) / (g_uiThermo_RefHigh - g_uiThermo_RefLow);
+
+		// The references replace the factory calibration only
+		if (ucCal != 0)
+		{
+			lTemp = (signed long) (((unsigned long) (unsigned int) lTemp * g_uiaThermo_CalGain[ucCal - 1] + (1UL << (GAIN_SHIFT - 1))) >> GAIN_SHIFT);
+			lTemp += g_iaThermo_CalOffset[ucCal - 1];
+		}
+	}
+	else
+	{
+		// The factory and the channel calibration in one step
+		// An unsigned 16 x 16 multiply is the cheapest the runtime offers
+		lTemp = (signed long) (((unsigned long) uiADCTicks * g_uiaThermo_Gain[ucCal] + (1UL << (GAIN_SHIFT - 1))) >> GAIN_SHIFT);
+		lTemp += g_iaThermo_Offset[ucCal];
+	}
+
+	if (lTemp < 0)
+		lTemp = 0;
+
+	return (unsigned int) lTemp;
+}
+
+
+/////////////////////////////////////////////////////////////
+//!
+//! \brief Reads the requested thermocouple channel
+//!
+//! \param ucChannel, the channel 1 to 4; ucFilter, the THERMO_FILTER
+//! \return uiADCTicks
+//!
+////////////////////////////////////////////////////////////
+unsigned int uiThermo_ReadChannel(unsigned char ucChannel, unsigned char ucFilter)
+{
+	unsigned int uiADCTicks;
+	unsigned char ucChannelIdx;
+
+	ucChannelIdx = ucChannel-1;
+	vThermo_ConvertReferences();
+	ZERO_EN &= ~ZERO_PIN;				//Disable Zero ref
+	EN_CH &= ~g_ucaThermo_ChEnable[ucChannelIdx];					//Enables channel 0
+	vThermo_LPMDelay(62500, 1);  		//Delay to make sure the reading is independent from last
+	ADC12MCTL0 |= INCH_3;				//Put on the right ADC input
+	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
+	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
+
+	vThermo_Convert();
+
+	// Disable conversions
+	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
+
+	// Clear input channel for mem0
+	ADC12MCTL0 &= ~INCH_3;
+
+	ZERO_EN |= ZERO_PIN;				//Enable Zero ref
+	EN_CH |= g_ucaThermo_ChEnable[ucChannelIdx];					//Disable channel 0
+
+	uiADCTicks = uiThermo_Filter(ucFilter, ucChannel);
+
+	return uiADCTicks;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Folds the factory calibration into every channel calibration
+//!
+//! An erased factory word counts as a gain of 1 and an offset of 0.  The
+//! channel gain is limited to THERMO_CAL_MAX_GAIN, so the merged gain of a
+//! factory gain near 1 fits 16 bits.
+//!
+////////////////////////////////////////////////////////////
+static void vThermo_MergeCalibration(void)
+{
+	unsigned int uiFactoryGain;
+	signed int iFactoryOffset;
+	unsigned char ucIdx;
+
+	uiFactoryGain = THERMO_CAL_UNITY;
+	iFactoryOffset = 0;
+
+	if (*ADC_GainFactor != 0xFFFF)
+	{
+		uiFactoryGain = *ADC_GainFactor;
+		iFactoryOffset = *ADC_Offset;
+	}
+
+	g_uiaThermo_Gain[0] = uiFactoryGain;
+	g_iaThermo_Offset[0] = iFactoryOffset;
+
+	// ((x * Gf + Of) * Gc + Oc) = x * (Gf * Gc) + (Of * Gc + Oc)
+	for (ucIdx = 0; ucIdx < 4; ucIdx++)
+	{
+		g_uiaThermo_Gain[ucIdx + 1] = (unsigned int) (((unsigned long) uiFactoryGain * g_uiaThermo_CalGain[ucIdx] + (1UL << (GAIN_SHIFT - 1))) >> GAIN_SHIFT);
+		g_iaThermo_Offset[ucIdx + 1] = (signed int) ((((signed long) iFactoryOffset * g_uiaThermo_CalGain[ucIdx] + (1L << (GAIN_SHIFT - 1))) >> GAIN_SHIFT) + g_iaThermo_CalOffset[ucIdx]);
+	}
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Loads the channel calibration from flash
+//!
+//! Called at startup.  A board that was never calibrated in the field runs
+//! on the factory calibration alone.
+//!
+////////////////////////////////////////////////////////////
+void vThermo_LoadCalibration(void)
+{
+	uint16 uiaCal[CAL_WORDS];
+	unsigned char ucIdx;
+
+	if (ucFlash_GetCalibration(uiaCal) != 0)
+	{
+		for (ucIdx = 0; ucIdx < 4; ucIdx++)
+		{
+			uiaCal[ucIdx * 2] = THERMO_CAL_UNITY;
+			uiaCal[ucIdx * 2 + 1] = 0;
+		}
+	}
+
+	for (ucIdx = 0; ucIdx < 4; ucIdx++)
+	{
+		g_uiaThermo_CalGain[ucIdx] = uiaCal[ucIdx * 2];
+		g_iaThermo_CalOffset[ucIdx] = (int16) uiaCal[ucIdx * 2 + 1];
+	}
+
+	vThermo_MergeCalibration();
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Sets and stores the calibration of a channel
+//!
+//! The other channels keep theirs.  If the flash write fails the stored
+//! calibration is loaded again.
+//!
+//! \param ucChannel, the channel 1 to 4; uiGain, the gain x 2^15; iOffset,
+//! the offset in ticks
+//! \return 0 on success, 1 for a bad channel or gain or a failed write
+//!
+////////////////////////////////////////////////////////////
+unsigned char ucThermo_SetCalibration(unsigned char ucChannel, unsigned int uiGain, signed int iOffset)
+{
+	uint16 uiaCal[CAL_WORDS];
+	unsigned char ucIdx;
+
+	if (ucChannel == 0 || ucChannel > 4)
+		return 1;
+
+	if (uiGain < THERMO_CAL_MIN_GAIN || uiGain > THERMO_CAL_MAX_GAIN)
+		return 1;
+
+	g_uiaThermo_CalGain[ucChannel - 1] = uiGain;
+	g_iaThermo_CalOffset[ucChannel - 1] = iOffset;
+
+	for (ucIdx = 0; ucIdx < 4; ucIdx++)
+	{
+		uiaCal[ucIdx * 2] = g_uiaThermo_CalGain[ucIdx];
+		uiaCal[ucIdx * 2 + 1] = (uint16) g_iaThermo_CalOffset[ucIdx];
+	}
+
+	if (ucFlash_SetCalibration(uiaCal) != 0)
+	{
+		vThermo_LoadCalibration();
+		return 1;
+	}
+
+	vThermo_MergeCalibration();
+
+	return 0;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Returns the calibration of a channel
+//!
+//! \param ucChannel, the channel 1 to 4; puiGain, the gain x 2^15; piOffset,
+//! the offset in ticks
+//!
+////////////////////////////////////////////////////////////
+void vThermo_GetCalibration(unsigned char ucChannel, unsigned int *puiGain, signed int *piOffset)
+{
+	if (ucChannel == 0 || ucChannel > 4)
+	{
+		*puiGain = THERMO_CAL_UNITY;
+		*piOffset = 0;
+		return;
+	}
+
+	*puiGain = g_uiaThermo_CalGain[ucChannel - 1];
+	*piOffset = g_iaThermo_CalOffset[ucChannel - 1];
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Captures one point of a two point calibration
+//!
+//! The CP applies a known input to the channel and gives the reading it
+//! should produce.  The channel is read with the factory calibration only
+//! and the filter of THERMO_FILTER_TRIMMED.  Capturing a point of another
+//! channel drops the points taken so far.  The ADC must be initialized.
+//!
+//! \param ucChannel, the channel 1 to 4; ucPoint, 0 for the low point or
+//! 1 for the high point; uiTarget, the reading the input should give
+//! \return 0 on success, 1 for a bad channel or point
+//!
+////////////////////////////////////////////////////////////
+unsigned char ucThermo_CapturePoint(unsigned char ucChannel, unsigned char ucPoint, unsigned int uiTarget)
+{
+	if (ucChannel == 0 || ucChannel > 4 || ucPoint > 1)
+		return 1;
+
+	if (ucChannel != g_ucThermo_CalChannel)
+	{
+		g_ucThermo_CalChannel = ucChannel;
+		g_ucThermo_CalPoints = 0;
+	}
+
+	g_ucThermo_Capture = 1;
+	g_uiaThermo_CalRead[ucPoint] = uiThermo_ReadChannel(ucChannel, THERMO_FILTER_TRIMMED);
+	g_ucThermo_Capture = 0;
+
+	g_uiaThermo_CalTarget[ucPoint] = uiTarget;
+	g_ucThermo_CalPoints |= (1 << ucPoint);
+
+	return 0;
+}
+
+
+////////////////////////////////////////////////////////////
+//!
+//! \brief Computes the calibration of the captured points and stores it
+//!
+//! The gain maps the span between the two readings onto the span between the
+//! two targets and the offset puts the low point on its target.  The points
+//! are dropped either way.
+//!
+//! \param ucChannel, the channel 1 to 4, the one the points were taken on
+//! \return 0 on success, 1 if a point is missing, the readings are closer
+//! than THERMO_CAL_MIN_SPAN, the gain is out of range or the write failed
+//!
+////////////////////////////////////////////////////////////
+unsigned char ucThermo_StoreCapture(unsigned char ucChannel)
+{
+	signed long lReadSpan;
+	signed long lTargetSpan;
+	signed long lGain;
+	signed long lOffset;
+
+	if (ucChannel != g_ucThermo_CalChannel || g_ucThermo_CalPoints != 0x03)
+		return 1;
+
+	g_ucThermo_CalChannel = 0;
+	g_ucThermo_CalPoints = 0;
+
+	lReadSpan = (signed long) g_uiaThermo_CalRead[1] - g_uiaThermo_CalRead[0];
+	lTargetSpan = (signed long) g_uiaThermo_CalTarget[1] - g_uiaThermo_CalTarget[0];
+
+	if (lReadSpan < THERMO_CAL_MIN_SPAN || lTargetSpan <= 0)
+		return 1;
+
+	lGain = ((lTargetSpan << GAIN_SHIFT) + (lReadSpan >> 1)) / lReadSpan;
+
+	if (lGain < THERMO_CAL_MIN_GAIN || lGain > THERMO_CAL_MAX_GAIN)
+		return 1;
+
+	lOffset = (signed long) g_uiaThermo_CalTarget[0] - (((signed long) g_uiaThermo_CalRead[0] * lGain + (1L << (GAIN_SHIFT - 1))) >> GAIN_SHIFT);
+
+	return ucThermo_SetCalibration(ucChannel, (unsigned int) lGain, (signed int) lOffset);
+}
+
+
+/////////////////////////////////////////////////////////////
+//!
+//! \brief Runs a burst capture on a thermocouple channel
+//!
+//! Every raw conversion goes to ucBurst_Sample() until it ends the capture,
+//! which bounds the time spent here.  The ADC must be initialized.
+//!
+//! \param ucChannel, the channel 1 to 4; uiInterval, SMCLK ticks between
+//! samples, long enough for THERMO_BURST_SHT and the ISR
+//!
+////////////////////////////////////////////////////////////
+void vThermo_Burst(unsigned char ucChannel, unsigned int uiInterval)
+{
+	unsigned char ucChannelIdx;
+
+	ucChannelIdx = ucChannel-1;
+	ZERO_EN &= ~ZERO_PIN;				//Disable Zero ref
+	EN_CH &= ~g_ucaThermo_ChEnable[ucChannelIdx];	//Enable the channel
+	vThermo_LPMDelay(62500, 1);  		//Delay to make sure the reading is independent from last
+	ADC12MCTL0 |= INCH_3;				//Put on the right ADC input
+	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
+	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
+
+	// Hand the samples to the burst instead of the accumulator
+	g_ucThermo_Burst = 1;
+	ADC12IFG = 0x00;
+	ADC12IE |= BIT0;
+
+	vThermo_ConvertTimed(uiInterval, THERMO_BURST_SHT);
+
+	g_ucThermo_Burst = 0;
+
+	// Disable conversions
+	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
+
+	// Clear input channel for mem0
+	ADC12MCTL0 &= ~INCH_3;
+
+	ZERO_EN |= ZERO_PIN;				//Enable Zero ref
+	EN_CH |= g_ucaThermo_ChEnable[ucChannelIdx];	//Disable the channel
+}
+
+
+/////////////////////////////////////////////////////////////
+//!
+//! \brief Classifies a reading of a thermocouple channel
+//!
+//! An open loop drives the amplifier to the upper rail and a short to
+//! ground drives it to the lower rail.  A thermocouple at the cold junction
+//! temperature reads the zero reading, so it is never taken for a short.
+//! The result is cached for ucThermo_GetHealth().
+//!
+//! \param ucChannel, the channel 1 to 4; uiADCTicks, the reading
+//! \return the THERMO_HEALTH code
+//!
+////////////////////////////////////////////////////////////
+unsigned char ucThermo_ClassifyReading(unsigned char ucChannel, unsigned int uiADCTicks)
+{
+	unsigned char ucHealth;
+
+	if (uiADCTicks >= THERMO_OPEN_TICKS)
+		ucHealth = THERMO_HEALTH_OPEN;
+	else if (uiADCTicks <= THERMO_SHORTED_TICKS)
+		ucHealth = THERMO_HEALTH_SHORTED;
+	else
+		ucHealth = THERMO_HEALTH_CONNECTED;
+
+	g_ucaThermo_Health[ucChannel - 1] = ucHealth;
+
+	return ucHealth;
+}
+
+
+/////////////////////////////////////////////////////////////
+//!
+//! \brief Probes a thermocouple channel
+//!
+//! Takes a single uncalibrated conversion after THERMO_PROBE_SETTLE in place
+//! of the full settle and the NUM_SAMPLES average of uiThermo_ReadChannel().
+//! That is enough to see the rails.  The ADC must be initialized.
+//!
+//! \param ucChannel, the channel 1 to 4
+//! \return the THERMO_HEALTH code
+//!
+////////////////////////////////////////////////////////////
+unsigned char ucThermo_ProbeChannel(unsigned char ucChannel)
+{
+	unsigned int uiADCTicks;
+	unsigned char ucChannelIdx;
+
+	ucChannelIdx = ucChannel-1;
+	ZERO_EN &= ~ZERO_PIN;				//Disable Zero ref
+	EN_CH &= ~g_ucaThermo_ChEnable[ucChannelIdx];	//Enable the channel
+	vThermo_LPMDelay(THERMO_PROBE_SETTLE, 1);
+	ADC12MCTL0 |= INCH_3;				//Put on the right ADC input
+	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
+	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
+
+	// Poll for the first conversion, the ISR is not needed for one sample
+	ADC12IE &= ~BIT0;
+	ADC12IFG = 0x00;
+	ADC12CTL0 |= (ADC12SC | ENC);
+	HAL_WAIT_FLAG(ADC12IFG, BIT0);
+	uiADCTicks = ADC12MEM0;
+
+	// Disable conversions
+	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
+
+	// Clear input channel for mem0
+	ADC12MCTL0 &= ~INCH_3;
+
+	ZERO_EN |= ZERO_PIN;				//Enable Zero ref
+	EN_CH |= g_ucaThermo_ChEnable[ucChannelIdx];	//Disable the channel
+
+	return ucThermo_ClassifyReading(ucChannel, uiADCTicks);
+}
+
+
+/////////////////////////////////////////////////////////////
+//!
+//! \brief Returns the cached classification of a channel
+//!
+//! \param ucChannel, the channel 1 to 4
+//! \return the THERMO_HEALTH code
+//!
+////////////////////////////////////////////////////////////
+unsigned char ucThermo_GetHealth(unsigned char ucChannel)
+{
+	if (ucChannel == 0 || ucChannel > 4)
+		return THERMO_HEALTH_UNKNOWN;
+
+	return g_ucaThermo_Health[ucChannel - 1];
+}
+
+
+///////////////////////////////////////////////////////////
+//!
+//! \brief Reads the thermocouple offset
+//!
+//! In the ratiometric mode the references are converted first.
+//!
+//! \param none
+//!
+//! \return stores the offset reading in gui_ZeroReading
+//!
+////////////////////////////////////////////////////////////
+void vZeroReading()
+{
+	vThermo_ConvertReferences();
+	ADC12MCTL0 |= INCH_3;				//Put on the right ADC input
+	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
+	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
+	vThermo_LPMDelay(62500, 1);  		//Delay to make sure the reading is independent from last
+	vThermo_LPMDelay(62500, 1);  		//Delay to make sure the reading is independent from last
+
+	vThermo_Convert();
+
+	// Disable conversions and shutdown ADC
+	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
+
+	// Clear input channel for MEM0
+	ADC12MCTL0 &= ~INCH_3;
+
+	gui_ZeroReading = uiThermo_Filter(THERMO_FILTER_DEFAULT, 0);
+}
+
+
+//////////////////////////////////////////////////////////
+//!
+//! \brief Reads the thermistor voltage
+//!
+//! \param none
+//!
+//! \return stores the thermistor reading in gui_ThermistorReading
+//!
+///////////////////////////////////////////////////////////
+void vThermistorReading()
+{
+	CJC_EN &= ~CJC_PIN;					//Enable thermistor
+	ADC12MCTL0 |= INCH_7;				//turn on right ADC input
+	ADC12CTL0 |= SHT0_7;
+	ADC12CTL0 |= ADC12ON;				//Turn on the ADC
+	ADC12CTL1 |= CSTARTADD_0;			//Sets MEM0 as the register to write to
+
+	// Rise time for thermistor is approximately 3 ms at 24 degrees C , we give it some slack
+	vThermo_LPMDelay(10000, 1);
+
+	vThermo_Convert();
+
+	// Disable thermister
+	CJC_EN |= CJC_PIN;
+
+	// Disable conversions and shutdown ADC
+	ADC12CTL0 &= ~(ADC12SC | ENC | ADC12ON);
+
+	// Deselect the channel for mem0
+	ADC12MCTL0 &= ~INCH_7;
+
+	gui_ThermistorReading = uiThermo_Filter(THERMO_FILTER_DEFAULT, 0);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Triggers when an ADC reading is complete and brings the board out of LPM when
+//!				 conversions are complete
+//!
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+HAL_ISR(ADC12_VECTOR, ADC_Conversion)
+{
+	unsigned int uiSample;
+
+	DIAG_ISR_ENTER();
+
+	switch (HAL_EVEN_IN_RANGE(ADC12IV, 34))
+	{
+		case ADC12IV_NONE:
+		break;
+		case ADC12IV_ADC12OVIFG:
+		break;
+		case ADC12IV_ADC12TOVIFG:
+		break;
+		case ADC12IV_ADC12IFG0:
+			// Fold the sample into the accumulator
+			uiSample = ADC12MEM0;
+
+			// A burst takes every sample as it is
+			if (g_ucThermo_Burst)
+			{
+				if (ucBurst_Sample(uiSample))
+				{
+					ADC12IE &= ~BIT0;
+					__bic_SR_register_on_exit(LPM3_bits);
+				}
+				break;
+			}
+
+			gui_ADCSum += uiSample;
+			if (uiSample < gui_ADCMin)
+				gui_ADCMin = uiSample;
+			if (uiSample > gui_ADCMax)
+				gui_ADCMax = uiSample;
+			guc_ADCSampleIndex++; // Increment results index
+
+			// If we have reached the desired number of conversions then wake the CPU
+			if (guc_ADCSampleIndex == NUM_SAMPLES)
+			{
+				// Reset the sample index
+				guc_ADCSampleIndex = 0;
+				ADC12IE &= ~BIT0;
+				__bic_SR_register_on_exit(LPM3_bits);
+			}
+		break;
+		case ADC12IV_ADC12IFG1:
+		break;
+		case ADC12IV_ADC12IFG2:
+		break;
+		case ADC12IV_ADC12IFG3:
+		break;
+		case ADC12IV_ADC12IFG4:
+		break;
+		case ADC12IV_ADC12IFG5:
+		break;
+		case ADC12IV_ADC12IFG6:
+		break;
+		case ADC12IV_ADC12IFG7:
+		break;
+		case ADC12IV_ADC12IFG8:
+		break;
+		case ADC12IV_ADC12IFG9:
+		break;
+		case ADC12IV_ADC12IFG10:
+		break;
+		case ADC12IV_ADC12IFG11:
+		break;
+		case ADC12IV_ADC12IFG12:
+		break;
+		case ADC12IV_ADC12IFG13:
+		break;
+		case ADC12IV_ADC12IFG14:
+		break;
+		case ADC12IV_ADC12IFG15:
+		break;
+
+	}
+
+	DIAG_ISR_EXIT();
+}
+
+//! @}
+
@@ -1,123 +1,274 @@
-///////////////////////////////////////////////////////////////////////////////
-//! \file Thermo.h
-//! \brief Header file for the thermo application code
-//!
-//! This file provides all of the defines and function prototypes for the
-//! \ref SPTC
-//!
-//! @addtogroup SPTC
-//! The thermo application code runs an SPTC to allow temperature readings to be taken
-//! @{
-//!
-///////////////////////////////////////////////////////////////////////////////
-//*****************************************************************************
-// By: Nicholas Rowe
-//     Wireless Networks Research Lab
-//     Dept. of Electrical Engineering, CEFNS
-//     Northern Arizona University
-//
-//*****************************************************************************
-#ifndef SP_ST_1_THERMO_H_
-#define SP_ST_1_THERMO_H_
-
-//! \name VREF_Port
-//! these defines allow the VREF port to be addressed by the VREF port name
-//! \def VREF_PIN
-//! \brief Defines the port which the VREF pin is on
-#define VREF_PIN BIT1
-//! \def VREF_EN
-//! \brief set up the output port name for VREF
-#define VREF_EN P5OUT
-//! \def VREF_EN_DIR
-//! \brief sets up the DIR port name for VREF
-#define VREF_EN_DIR P5DIR
-//! \def VREF_EN_SEL
-//! \brief sets up the SEL port name for VREF
-#define VREF_EN_SEL P5SEL
-
-//! \name CJC_port
-//! These defines set up the cold junction compensator circuitry
-//! \def CJC_PIN
-//! \brief defines the name for the CJC_PIN port number
-#define CJC_PIN BIT0
-//! \def CJC_EN
-//! \brief defines the name for CJC output port
-#define CJC_EN P5OUT
-//! \def CJC_EN_DIR
-//! \brief defines the name for the CJC DIR port number
-#define CJC_EN_DIR P5DIR
-//! \def CJC_EN_SEL
-//! \brief defines the name for the CJC SEL port number
-#define CJC_EN_SEL P5SEL
-
-//! \name ZERO_port
-//! These defines set up the Zero/offset port
-//! \def Zero_PIN
-//! \brief defines the name for the Zero_PIN port number
-#define ZERO_PIN BIT3
-//! \def Zero_EN
-//! \brief defines the name for the Zero output enable port number
-#define ZERO_EN P5OUT
-//! \def Zero_EN_DIR
-//! \brief defines the name for the Zero DIR port number
-#define ZERO_EN_DIR P5DIR
-//! \def Zero_EN_SEL
-//! \brief defines the name for the Zero select port number
-#define ZERO_EN_SEL P5SEL
-
-//! \name TC_port
-//! These defines set up the CH4-CH1 port for the thermocouples
-//! \def CH4_ENABLE_BIT
-//! \brief defines the name for the CH4 EN pin
-#define CH4_ENABLE_BIT BIT6
-//! \def CH3_ENABLE_BIT
-//! \brief defines the name for the CH3 EN pin
-#define CH3_ENABLE_BIT BIT5
-//! \def CH2_ENABLE_BIT
-//! \brief defines the name for the CH2 EN pin
-#define CH2_ENABLE_BIT BIT4
-//! \def CH1_ENABLE_BIT
-//! \brief defines the name for the CH1 EN pin
-#define CH1_ENABLE_BIT BIT3
-
-//! \def EN_CH
-//! \brief defines the name for the TC EN port
-#define EN_CH P4OUT
-//! \def EN_CH_DIR
-//! \brief defines the name for the TC port direction
-#define EN_CH_DIR P4DIR
-//! \def EN_CH_SEL
-//! \brief defines the name for the TC port select
-#define EN_CH_SEL P4SEL
-
-//! \name ADC_INPUT PORT
-//! These defines set up the ADC input port
-//! \def TC_CH_PORT
-//! \brief defines the name for the adc input port
-#define TC_CH_PORT P6OUT
-//! \def TC_CH_DIR
-//! \brief defines the name for the adc input port direction
-#define TC_CH_DIR P6DIR
-//! \def TC_CH_SEL
-//! \brief defines the name for the adc input port select
-#define TC_CH_SEL P6SEL
-
-
-//! @name Initalization Functions
-//! These functions handle board initialization
-//! @{
-void vPortNMemInit();
-void vADCInit();
-//! @}
-
-//! @name Sensor Functions
-//! These functions handle taking data readings
-//! @{
-unsigned int uiThermo_ReadChannel(unsigned char ucChannel);
-void vZeroReading(); //just the offset with no thermocouple in series
-void vThermistorReading();
-//! @}
-
-
-#endif /* SP_ST_1_THERMO_H_ */
-//! @}
+///////////////////////////////////////////////////////////////////////////////
+//! \file Thermo.h
+//! \brief Header file for the thermo application code
+//!
+//! This file provides all of the defines and function prototypes for the
+//! \ref SPTC
+//!
+//! @addtogroup SPTC
+//! The thermo application code runs an SPTC to allow temperature readings to be taken
+//! @{
+//!
+///////////////////////////////////////////////////////////////////////////////
+//*****************************************************************************
+// By: Nicholas Rowe
+//     Wireless Networks Research Lab
+//     Dept. of Electrical Engineering, CEFNS
+//     Northern Arizona University
+//
+//*****************************************************************************
+#ifndef SP_ST_1_THERMO_H_
+#define SP_ST_1_THERMO_H_
+
+//! \name VREF_Port
+//! these defines allow the VREF port to be addressed by the VREF port name
+//! \def VREF_PIN
+//! \brief Defines the port which the VREF pin is on
+#define VREF_PIN BIT1
+//! \def VREF_EN
+//! \brief set up the output port name for VREF
+#define VREF_EN P5OUT
+//! \def VREF_EN_DIR
+//! \brief sets up the DIR port name for VREF
+#define VREF_EN_DIR P5DIR
+//! \def VREF_EN_SEL
+//! \brief sets up the SEL port name for VREF
+#define VREF_EN_SEL P5SEL
+
+//! \name CJC_port
+//! These defines set up the cold junction compensator circuitry
+//! \def CJC_PIN
+//! \brief defines the name for the CJC_PIN port number
+#define CJC_PIN BIT0
+//! \def CJC_EN
+//! \brief defines the name for CJC output port
+#define CJC_EN P5OUT
+//! \def CJC_EN_DIR
+//! \brief defines the name for the CJC DIR port number
+#define CJC_EN_DIR P5DIR
+//! \def CJC_EN_SEL
+//! \brief defines the name for the CJC SEL port number
+#define CJC_EN_SEL P5SEL
+
+//! \name ZERO_port
+//! These defines set up the Zero/offset port
+//! \def Zero_PIN
+//! \brief defines the name for the Zero_PIN port number
+#define ZERO_PIN BIT3
+//! \def Zero_EN
+//! \brief defines the name for the Zero output enable port number
+#define ZERO_EN P5OUT
+//! \def Zero_EN_DIR
+//! \brief defines the name for the Zero DIR port number
+#define ZERO_EN_DIR P5DIR
+//! \def Zero_EN_SEL
+//! \brief defines the name for the Zero select port number
+#define ZERO_EN_SEL P5SEL
+
+//! \name TC_port
+//! These defines set up the CH4-CH1 port for the thermocouples
+//! \def CH4_ENABLE_BIT
+//! \brief defines the name for the CH4 EN pin
+#define CH4_ENABLE_BIT BIT6
+//! \def CH3_ENABLE_BIT
+//! \brief defines the name for the CH3 EN pin
+#define CH3_ENABLE_BIT BIT5
+//! \def CH2_ENABLE_BIT
+//! \brief defines the name for the CH2 EN pin
+#define CH2_ENABLE_BIT BIT4
+//! \def CH1_ENABLE_BIT
+//! \brief defines the name for the CH1 EN pin
+#define CH1_ENABLE_BIT BIT3
+
+//! \def EN_CH
+//! \brief defines the name for the TC EN port
+#define EN_CH P4OUT
+//! \def EN_CH_DIR
+//! \brief defines the name for the TC port direction
+#define EN_CH_DIR P4DIR
+//! \def EN_CH_SEL
+//! \brief defines the name for the TC port select
+#define EN_CH_SEL P4SEL
+
+//! \name ADC_INPUT PORT
+//! These defines set up the ADC input port
+//! \def TC_CH_PORT
+//! \brief defines the name for the adc input port
+#define TC_CH_PORT P6OUT
+//! \def TC_CH_DIR
+//! \brief defines the name for the adc input port direction
+#define TC_CH_DIR P6DIR
+//! \def TC_CH_SEL
+//! \brief defines the name for the adc input port select
+#define TC_CH_SEL P6SEL
+
+//! @name Channel Health
+//! The classification of a thermocouple channel, cached per channel
+//! @{
+//! \def THERMO_HEALTH_UNKNOWN
+//! \brief The channel has not been probed yet
+#define THERMO_HEALTH_UNKNOWN		0x00
+//! \def THERMO_HEALTH_CONNECTED
+//! \brief The reading is off both rails
+#define THERMO_HEALTH_CONNECTED		0x01
+//! \def THERMO_HEALTH_OPEN
+//! \brief The amplifier sits on the upper rail, the loop is open
+#define THERMO_HEALTH_OPEN			0x02
+//! \def THERMO_HEALTH_SHORTED
+//! \brief The amplifier sits on the lower rail, the input is shorted low
+#define THERMO_HEALTH_SHORTED		0x03
+//! @}
+
+//! @name Channel Probe
+//! A single conversion after a short settle classifies a channel
+//! @{
+//! \def THERMO_PROBE_SETTLE
+//! \brief Settle time of a probe in Timer_B ticks (SMCLK / 8), 5 ms
+#define THERMO_PROBE_SETTLE			2500
+//! \def THERMO_OPEN_TICKS
+//! \brief Readings at or above this are on the upper rail
+#define THERMO_OPEN_TICKS			4000
+//! \def THERMO_SHORTED_TICKS
+//! \brief Readings at or below this are on the lower rail
+#define THERMO_SHORTED_TICKS		16
+//! @}
+
+//! @name Sample Filters
+//! How the NUM_SAMPLES conversions of a reading are combined
+//! @{
+//! \def THERMO_FILTER_MEAN
+//! \brief Plain mean of all samples
+#define THERMO_FILTER_MEAN			0x00
+//! \def THERMO_FILTER_TRIMMED
+//! \brief Mean without the lowest and the highest sample
+#define THERMO_FILTER_TRIMMED		0x01
+//! \def THERMO_FILTER_IIR
+//! \brief Trimmed mean through a first order low-pass across the reads of
+//! the channel
+#define THERMO_FILTER_IIR			0x02
+//! \def THERMO_FILTER_DEFAULT
+//! \brief The filter of a reading no parameter asks for, the plain mean the
+//! board has always reported
+#define THERMO_FILTER_DEFAULT		THERMO_FILTER_MEAN
+//! \def THERMO_FILTER_EXTENDED
+//! \brief Set in the filter parameter of a channel command when the mains
+//! sync, period and ratiometric parameters follow.  Without it any further
+//! parameters are ignored, as they were before those modes existed.
+#define THERMO_FILTER_EXTENDED		0x80
+//! \def THERMO_IIR_SHIFT
+//! \brief The low-pass moves 1 / 2^THERMO_IIR_SHIFT of the way per read
+#define THERMO_IIR_SHIFT			2
+//! @}
+
+//! @name Mains Synchronous Sampling
+//! Spreads the samples of a reading over whole mains periods
+//! @{
+//! \def THERMO_MAINS_NONE
+//! \brief Free running conversions
+#define THERMO_MAINS_NONE			0x00
+//! \def THERMO_MAINS_50HZ
+#define THERMO_MAINS_50HZ			0x01
+//! \def THERMO_MAINS_60HZ
+#define THERMO_MAINS_60HZ			0x02
+//! \def THERMO_SMCLK_HZ
+//! \brief SMCLK, the calibrated 16 MHz DCO divided by 4
+#define THERMO_SMCLK_HZ				4000000UL
+//! \def THERMO_SAMPLES
+//! \brief The number of conversions in a reading
+#define THERMO_SAMPLES				10
+//! \def THERMO_50HZ_INTERVAL
+//! \brief SMCLK ticks between samples for one 20 ms period
+#define THERMO_50HZ_INTERVAL		((unsigned int) ((THERMO_SMCLK_HZ / 50 + THERMO_SAMPLES / 2) / THERMO_SAMPLES))
+//! \def THERMO_60HZ_INTERVAL
+//! \brief SMCLK ticks between samples for one 16.67 ms period
+#define THERMO_60HZ_INTERVAL		((unsigned int) ((THERMO_SMCLK_HZ / 60 + THERMO_SAMPLES / 2) / THERMO_SAMPLES))
+//! \def THERMO_MAX_PERIODS
+//! \brief The most periods whose interval fits Timer_B
+#define THERMO_MAX_PERIODS			8
+//! \def THERMO_SYNC_SHT
+//! \brief Sample and hold time in a synchronous mode, 256 ADC clocks (512 us)
+#define THERMO_SYNC_SHT				SHT0_8
+//! @}
+
+//! \def THERMO_BURST_SHT
+//! \brief Sample and hold time of a burst capture, 16 ADC clocks (32 us)
+#define THERMO_BURST_SHT			SHT0_2
+
+//! \def THERMO_FULL_SCALE
+//! \brief The ticks of an input at VeREF+
+#define THERMO_FULL_SCALE			4095
+
+//! @name Channel Calibration
+//! A two point calibration per channel on top of the factory calibration,
+//! stored in flash
+//! @{
+//! \def THERMO_CAL_UNITY
+//! \brief A gain of 1, the gains are x 2^15
+#define THERMO_CAL_UNITY			0x8000
+//! \def THERMO_CAL_MIN_GAIN
+//! \brief The lowest channel gain accepted, 0.5
+#define THERMO_CAL_MIN_GAIN			0x4000
+//! \def THERMO_CAL_MAX_GAIN
+//! \brief The highest channel gain accepted, 1.5
+#define THERMO_CAL_MAX_GAIN			0xC000
+//! \def THERMO_CAL_MIN_SPAN
+//! \brief The least ticks between the readings of the two points
+#define THERMO_CAL_MIN_SPAN			256
+//! @}
+
+//! @name Calibration Operations
+//! The first payload byte of a CALIBRATE message, the second is the channel
+//! @{
+//! \def THERMO_CAL_OP_READ
+//! \brief Report the calibration of the channel
+#define THERMO_CAL_OP_READ			0x00
+//! \def THERMO_CAL_OP_LOW
+//! \brief Capture the low point, the target follows MSB first
+#define THERMO_CAL_OP_LOW			0x01
+//! \def THERMO_CAL_OP_HIGH
+//! \brief Capture the high point, the target follows MSB first
+#define THERMO_CAL_OP_HIGH			0x02
+//! \def THERMO_CAL_OP_STORE
+//! \brief Compute the calibration of the two points and store it
+#define THERMO_CAL_OP_STORE			0x03
+//! \def THERMO_CAL_OP_SET
+//! \brief Store the gain and the offset that follow, MSB first
+#define THERMO_CAL_OP_SET			0x04
+//! \def THERMO_CAL_OP_CLEAR
+//! \brief Go back to the factory calibration
+#define THERMO_CAL_OP_CLEAR			0x05
+//! \def THERMO_CAL_REPLY_LEN
+//! \brief The reply holds the operation, the channel, the gain and the offset
+#define THERMO_CAL_REPLY_LEN		6
+//! @}
+
+//! @name Initalization Functions
+//! These functions handle board initialization
+//! @{
+void vPortNMemInit();
+void vADCInit();
+//! @}
+
+//! @name Sensor Functions
+//! These functions handle taking data readings
+//! @{
+unsigned int uiThermo_ReadChannel(unsigned char ucChannel, unsigned char ucFilter);
+unsigned char ucThermo_ProbeChannel(unsigned char ucChannel);
+unsigned char ucThermo_ClassifyReading(unsigned char ucChannel, unsigned int uiADCTicks);
+unsigned char ucThermo_GetHealth(unsigned char ucChannel);
+unsigned char ucThermo_SetMainsSync(unsigned char ucMains, unsigned char ucPeriods);
+void vThermo_SetRatiometric(unsigned char ucOn);
+unsigned char ucThermo_GetRatiometric(void);
+void vThermo_LoadCalibration(void);
+unsigned char ucThermo_SetCalibration(unsigned char ucChannel, unsigned int uiGain, signed int iOffset);
+void vThermo_GetCalibration(unsigned char ucChannel, unsigned int *puiGain, signed int *piOffset);
+unsigned char ucThermo_CapturePoint(unsigned char ucChannel, unsigned char ucPoint, unsigned int uiTarget);
+unsigned char ucThermo_StoreCapture(unsigned char ucChannel);
+void vThermo_Burst(unsigned char ucChannel, unsigned int uiInterval);
+void vZeroReading(); //just the offset with no thermocouple in series
+void vThermistorReading();
+//! @}
+
+
+#endif /* SP_ST_1_THERMO_H_ */
+//! @}
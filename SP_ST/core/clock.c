@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file clock.c
+//! \brief This module keeps the free running ACLK timebase
+//!
+//! TAR gives the low half of the count and TIMERA1_ISR counts the high half
+//! on every TAIFG.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup clock Timebase
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "clock.h"
+
+//! \var g_uiCLOCK_Overflows
+//! \brief The high half of the count, incremented by TIMERA1_ISR
+volatile uint16 g_uiCLOCK_Overflows;
+
+//! \var g_ulCLOCK_Sync
+//! \brief The count at the latest TIME_SYNC
+static uint32 g_ulCLOCK_Sync;
+
+//! \var g_uiCLOCK_Rate
+//! \brief ACLK ticks per second
+static uint16 g_uiCLOCK_Rate = CLOCK_RATE_NOMINAL;
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Starts counting the Timer_A overflows
+//!
+//! Must follow vCOMM_Init(), which starts Timer_A.  The time of the last
+//! reset counts as the sync until the first TIME_SYNC.
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vCLOCK_Init(void)
+{
+	g_uiCLOCK_Overflows = 0;
+	g_ulCLOCK_Sync = 0;
+
+	TACTL &= ~TAIFG;
+	TACTL |= TAIE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the 32 bit tick count
+//!
+//! TAR is clocked from ACLK, asynchronous to MCLK, so it is read until two
+//! reads agree.  An overflow that is pending because interrupts are off
+//! belongs to a small TAR.
+//!   \param none
+//!   \return ACLK ticks since vCLOCK_Init()
+///////////////////////////////////////////////////////////////////////////////
+uint32 ulCLOCK_Now(void)
+{
+	uint16 uiHigh;
+	uint16 uiLow;
+	uint8 ucPending;
+
+	do {
+		uiHigh = g_uiCLOCK_Overflows;
+
+		do {
+			uiLow = TAR;
+		}
+		while (uiLow != TAR);
+
+		ucPending = ((TACTL & TAIFG) != 0);
+	}
+	while (uiHigh != g_uiCLOCK_Overflows);
+
+	if (ucPending && uiLow < 0x8000)
+		uiHigh++;
+
+	return ((uint32) uiHigh << 16) | uiLow;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Marks the start of the time base of the CP
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vCLOCK_Sync(void)
+{
+	g_ulCLOCK_Sync = ulCLOCK_Now();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sets the measured ACLK rate
+//!   \param uiRate ACLK ticks per second, 0 leaves the rate as it is
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vCLOCK_SetRate(uint16 uiRate)
+{
+	if (uiRate != 0)
+		g_uiCLOCK_Rate = uiRate;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the ACLK rate in use
+//!   \param none
+//!   \return ACLK ticks per second
+///////////////////////////////////////////////////////////////////////////////
+uint16 uiCLOCK_GetRate(void)
+{
+	return g_uiCLOCK_Rate;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Converts a tick count to milliseconds, rounded
+//!
+//! The whole seconds are split off first so the product fits 32 bits.
+//!   \param ulTicks ACLK ticks
+//!   \return Milliseconds
+///////////////////////////////////////////////////////////////////////////////
+uint32 ulCLOCK_ToMillis(uint32 ulTicks)
+{
+	uint32 ulSeconds;
+	uint16 uiRemainder;
+
+	ulSeconds = ulTicks / g_uiCLOCK_Rate;
+	uiRemainder = (uint16) (ulTicks - ulSeconds * g_uiCLOCK_Rate);
+
+	return ulSeconds * 1000 + ((uint32) uiRemainder * 1000 + (g_uiCLOCK_Rate >> 1)) / g_uiCLOCK_Rate;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the time of a tick count on the time base of the CP
+//!   \param ulTicks A count from ulCLOCK_Now()
+//!   \return Milliseconds since the latest TIME_SYNC
+///////////////////////////////////////////////////////////////////////////////
+uint32 ulCLOCK_SinceSync(uint32 ulTicks)
+{
+	return ulCLOCK_ToMillis(ulTicks - g_ulCLOCK_Sync);
+}
+
+//! @}
+//! @}
@@ -0,0 +1,55 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file clock.h
+//! \brief Header file for the timebase module
+//!
+//! This file provides all of the defines and function prototypes for the
+//! \ref clock Module.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup clock Timebase
+//! The timebase counts ACLK ticks on the free running Timer_A that the
+//! \ref comm Module uses for its bus timeout.  The TAIFG overflows extend TAR
+//! to 32 bits, so the count runs on in LPM3 at no extra cost.
+//!
+//! ACLK comes from the VLO, which is only known to within a factor of two.
+//! The application measures the actual rate with vCLOCK_SetRate(), and every
+//! conversion to milliseconds uses it.
+//!
+//! The CP sends TIME_SYNC to mark the start of its time base on the SP.
+//! Timed reports give the milliseconds since the latest TIME_SYNC, so the CP
+//! can place the readings of every SP on its own clock without polling them
+//! in step.
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+//! \def CLOCK_RATE_NOMINAL
+//! \brief ACLK ticks per second of a 12 kHz VLO divided by 4
+#define CLOCK_RATE_NOMINAL	3000
+
+//! \def CLOCK_SYNC_LEN
+//! \brief The TIME_SYNC payload, an optional 4 byte tag of the CP
+#define CLOCK_SYNC_LEN		4
+
+extern volatile uint16 g_uiCLOCK_Overflows;
+
+// clock.c function prototypes
+//! @name clock module Functions
+//! These functions keep the free running timebase
+//! @{
+void vCLOCK_Init(void);
+uint32 ulCLOCK_Now(void);
+void vCLOCK_Sync(void);
+void vCLOCK_SetRate(uint16 uiRate);
+uint16 uiCLOCK_GetRate(void);
+uint32 ulCLOCK_ToMillis(uint32 ulTicks);
+uint32 ulCLOCK_SinceSync(uint32 ulTicks);
+//! @}
+
+#endif /*CLOCK_H_*/
+//! @}
+//! @}
@@ -1,520 +1,1336 @@
-///////////////////////////////////////////////////////////////////////////////
-//! \file comm.c
-//! \brief This modules implements a software I2C on any two Digital I/O pins
-//!
-//! This module uses Port 2 to implement a software I2C on any two defined
-//! digital I/O pin. Note that the serial clock (SCL) pin must be interrupt capable.
-//!
-//! @addtogroup core
-//! @{
-//!
-//! @addtogroup comm Software I2C
-//! The software I2C module allows the user to define a I2C interface on
-//! any two GPIO pins, provided that the SCL pin is interrupt capable.
-//! @{
-///////////////////////////////////////////////////////////////////////////////
-//*****************************************************************************
-// By: Kenji Yamamoto
-//     Wireless Networks Research Lab
-//     Dept. of Electrical Engineering, CEFNS
-//     Northern Arizona University
-//
-// Edited By: Christopher Porter
-//*****************************************************************************
-
-#include <msp430x23x.h>
-#include "core.h"
-#include "comm.h"
-#include "crc.h"
-
-//******************  Control and Indication Variables  *********************//
-//! @name Control and Indication Variables
-//! These variables are used to indicate to the system the current status
-//! of the \ref comm Module and to store the baud rate timer information.
-//! @{
-//! \var volatile uint8 g_ucCOMM_Flags
-//! \brief This 8-bit field indicates the status of the COMM module.
-volatile uint8 g_ucCOMM_Flags;
-
-//! \var uint16 g_unCOMM_BaudRateControl
-//! \brief This is the value used to control the baud rate.
-//!
-//! This value is the number of timer ticks corresponding to one bit period
-//! for the baud rate. It should be set from the \ref comm_baud
-//! "Baud Rate Defines".
-uint16 g_unCOMM_BaudRateControl;
-
-//! \var uint16 g_unCOMM_BaudRateDelayControl
-//! \brief This is the value used to delay from the start bit
-//!
-//! This value is the number of timer ticks to wait from the beginning of the
-//! start bit to the middle of the first data bit. It should be set from the
-//! \ref comm_baud_delay "Baud Rate Start Delays".
-uint16 g_unCOMM_BaudRateDelayControl;
-//! @}
-
-//******************  RX Variables  *****************************************//
-//! @name Receive Variables
-//! These variables are used in the receiving of data on the \ref comm Module.
-//! @{
-//! \var volatile uint8 g_ucaRXBuffer[MAXMSGLEN]
-//! \brief The software UART RX Buffer
-volatile uint8 g_ucaRXBuffer[MAXMSGLEN];
-
-//! \var volatile uint8 g_ucRXBufferIndex
-//! \brief This index into g_ucaRXBuffer showing the current write position.
-volatile uint8 g_ucRXBufferIndex;
-
-//! \var uint8 g_ucRXBitsLeft
-//! \brief The number of bits left to be received for the current byte.
-uint8 g_ucRXBitsLeft;
-
-//! \var uint8 g_ucRXParityBit
-//! \brief Even Parity for bit banging uart
-uint8 ucRXParityBit;
-//! @}
-
-
-//******************  Functions  ********************************************//
-///////////////////////////////////////////////////////////////////////////////
-//! \brief This sets up the hardware resources for doing software UART
-//!
-//! Since we are doing UART without the USCI, we use TimerA and it's interrupt
-//! to control the baud rate. The SDA and SCL pins are completely controllable
-//! at compile time. The software UART expects 1 start bit, 8 data bits and
-//! 1 stop bit.
-//!
-//! To ensure correct operation of the software UART, the \ref comm_pins
-//! "Comm Pin Defines" must be set correctly.
-//!   \param ucBaud The baud rate define to use
-//!   \return None
-//!   \sa vCOMM_SendByte(), TIMERA0_ISR()
-///////////////////////////////////////////////////////////////////////////////
-void vCOMM_Init()
-{
-	// We set the directionality of the SDA and SCL pins based on the defines
-	P_SDA_DIR &= ~SDA_PIN;
-	P_SCL_DIR &= ~SCL_PIN;
-
-	// Clear the RX buffer and reset index
-	g_ucRXBufferIndex = MAXMSGLEN;
-	while (g_ucRXBufferIndex) {
-		g_ucRXBufferIndex--;
-		g_ucaRXBuffer[g_ucRXBufferIndex] = 0xFF;
-	}
-	g_ucRXBufferIndex = 0x00;
-
-	// Set up for falling edge interrupts on SCL
-	P_SCL_IES |= SCL_PIN;
-	P_SCL_IFG &= ~SCL_PIN;
-
-	// Set up falling edge interrupt on the SDA line (to handle start condition)
-	P_SDA_IES |= SDA_PIN;
-	P_SDA_IFG &= ~SDA_PIN;
-
-	// Enable interrupts on the dedicated interrupt line
-	P_INT_IES &= ~INT_PIN;
-	P_INT_IFG &= ~INT_PIN;
-	P_INT_IE |= INT_PIN;
-
-	g_ucCOMM_Flags = COMM_RUNNING;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//! \brief Waits for the start signal from the CP board
-//!
-//! Officially the start condition does not include pulling the clock line low,
-//! but the clock needs to be low before entering the send and receive bytes
-//! functions.
-//!
-//!          __________________________
-//! SCL _____|                         |____
-//!           _________________
-//! SDA _____|                 |_____________
-//!
-//!   \param None
-//!   \return 1 if start condition received else 0
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucCOMM_WaitForStartCondition(void)
-{
-	// Clear the flag
-	g_ucCOMM_Flags &= ~COMM_START_CONDITION;
-
-	// Enable interrupts on the SDA line
-	P_SDA_IFG &= ~SDA_PIN;
-	P_SDA_IE |= SDA_PIN;
-
-	// Wait in deep sleep
-	LPM3;
-
-	// Disable interrupts on the SDA line
-	P_SDA_IE &= ~SDA_PIN;
-
-	// Prepare for communication if the start condition flag is set
-	if (g_ucCOMM_Flags & COMM_START_CONDITION) {
-
-		// Clear the flag
-		g_ucCOMM_Flags &= ~COMM_START_CONDITION;
-
-		// Enable interrupts on the falling edge of the clock line
-		P_SCL_IFG &= ~SCL_PIN;
-		P_SCL_IES |= SCL_PIN;
-
-		// Wait for the clock to go low then clear the flag
-		while (!(P_SCL_IFG & SCL_PIN));
-		P_SCL_IFG &= ~SCL_PIN;
-
-		return 1;
-	}
-
-	return 0;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//! \brief Sends a byte via the software I2C
-//!
-//! This function has been optimized for speed and therefore appears cumbersome
-//! by most coding standards.  Switch case statements, while more elegant, generate
-//! jump tables in assembly which take several cycles before executing a particular case.
-//! They have been replace with if statements which only require 2 or 3 instructions.
-//!
-//!   \param ucTXChar The 8-bit value to send
-//!   \return None
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucCOMM_SendByte(uint8 ucTXChar)
-{
-	uint8 ucParityBit;
-	uint8 ucBitIdx;
-	uint8 ucTXBitsLeft;
-	uint8 ucAck;
-	uint16 uiTXChar;
-	uint8 ucSDABit;
-	uint8 ucSCLBit;
-
-	// If we are already busy, return
-	if (g_ucCOMM_Flags & COMM_TX_BUSY)
-		return COMM_ERROR;
-
-	// Indicate in the status register that we are now busy
-	g_ucCOMM_Flags |= COMM_TX_BUSY;
-
-	// Local declarations of this bits place the values in registers - accessing them is faster.
-	ucSDABit = (uint8)SDA_PIN;
-	ucSCLBit = (uint8)SCL_PIN;
-
-	// Calculate the parity bit prior to transmission
-	ucParityBit = 0;
-	for (ucBitIdx = 0; ucBitIdx < 8; ucBitIdx++) {
-		ucParityBit ^= ((ucTXChar >> ucBitIdx) & 0x01);
-	}
-
-	// Combine the data and parity into one variable (more time saving)
-	uiTXChar = (uint16)(ucTXChar | (ucParityBit << 8));
-
-	// Reset the bit count
-	ucTXBitsLeft = 9;
-
-	// Enable interrupts on the falling edge of the clock line
-	P_SCL_IFG &= ~ucSCLBit;
-	P_SCL_IES |= ucSCLBit;
-
-	// Set the direction of the data line to output
-	P_SDA_DIR |= ucSDABit;
-
-	// Transmission loop which controls the UART timing for byte transmission
-	do{
-
-		// For data bits, mask to get correct value and the shift for next time
-		if (uiTXChar & 0x01)
-			P_SDA_OUT |= ucSDABit;
-		else
-			P_SDA_OUT &= ~ucSDABit;
-
-		// Decrement the total bit count and shift byte
-		ucTXBitsLeft--;
-		uiTXChar >>= 1;
-
-		// Wait for the next falling clock
-		while (!(P_SCL_IFG & ucSCLBit));
-		P_SCL_IFG &= ~ucSCLBit;
-
-	}while (ucTXBitsLeft != 0);
-
-	// Next bit is ack so switch the direction of the SDA pin
-	P_SDA_DIR &= ~ucSDABit;
-
-	// Switch clock edge interrupt
-	P_SCL_IES &= ~ucSCLBit;
-
-	// Wait for the next rising clock
-	while (!(P_SCL_IFG & ucSCLBit));
-	P_SCL_IFG &= ~ucSCLBit;
-
-	// Last bit is ack bit, return to idle state
-	ucAck = (P_SDA_IN & ucSDABit);
-
-	// Switch clock edge interrupt
-	P_SCL_IES |= ucSCLBit;
-
-	// Wait for the next clock
-	while (!(P_SCL_IFG & ucSCLBit));
-	P_SCL_IFG &= ~ucSCLBit;
-
-	g_ucCOMM_Flags &= ~COMM_TX_BUSY;
-
-	if (ucAck == 1)
-		return COMM_ACK_ERR;
-	else
-		return COMM_OK;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//! \brief Receives a byte via the software I2C
-//!
-//! This function has been optimized for speed and therefore appears cumbersome
-//! by most coding standards.  Switch case statements, while more elegant, generate
-//! jump tables in assembly which take several cycles before executing a particular case.
-//! They have been replace with if statements which only require 2 or 3 instructions.
-//!
-//!   \param none
-//!   \return error code
-//!   \sa vCOMM_Init()
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucCOMM_ReceiveByte(void)
-{
-	uint8 ucRXBitsLeft;
-	uint8 ucParityBit; // The calculated parity bit
-	uint8 ucRxParityBit; // The received parity bit
-	uint8 ucRXByte;
-
-	// If we are already busy, return
-	if (g_ucCOMM_Flags & COMM_RX_BUSY)
-		return COMM_ERROR;
-
-	// Indicate in the status register that we are now busy
-	g_ucCOMM_Flags |= COMM_RX_BUSY;
-
-	// Init the parity bit and the bit count
-	ucParityBit = 0;
-	ucRXBitsLeft = 8;
-
-	// Enable interrupts on rising edges of the SCL line
-	P_SCL_IFG &= ~SCL_PIN;
-	P_SCL_IES &= ~SCL_PIN;
-
-	// Set the direction of the data line to input
-	P_SDA_DIR &= ~SDA_PIN;
-
-	do {
-		// Wait for the next clock
-		while (!(P_SCL_IFG & SCL_PIN));
-		P_SCL_IFG &= ~SCL_PIN;
-
-		// Shift over for the next bit
-		ucRXByte >>= 1;
-
-		// Sample the data line
-		if (P_SDA_IN & SDA_PIN) {
-			ucRXByte |= 0x80;
-			ucParityBit++;
-		}
-		else {
-			ucRXByte &= ~0x80;
-		}
-
-	}while (--ucRXBitsLeft != 0);
-
-	// Wait for the next rising clock
-	while (!(P_SCL_IFG & SCL_PIN));
-	P_SCL_IFG &= ~SCL_PIN;
-
-	// Sample the parity bit
-	if (P_SDA_IN & SDA_PIN)
-		ucRxParityBit = 1;
-	else
-		ucRxParityBit = 0;
-
-	// Set the interrupt edge select for falling
-	P_SCL_IES |= SCL_PIN;
-
-	// Wait for the next falling clock
-	while (!(P_SCL_IFG & SCL_PIN));
-	P_SCL_IFG &= ~SCL_PIN;
-
-	ucParityBit = ucParityBit % 2;
-	// If the calculated and received parity bits match then send ack, else nack
-	if (ucParityBit == ucRxParityBit) {
-		P_SDA_OUT &= ~SDA_PIN;
-	}
-	else {
-		P_SDA_OUT |= SDA_PIN;
-	}
-
-	// Next bit is ack so switch the direction of the SDA pin
-	P_SDA_DIR |= SDA_PIN;
-
-	// Wait for the next falling clock clock
-	while (!(P_SCL_IFG & SCL_PIN));
-	P_SCL_IFG &= ~SCL_PIN;
-
-	// Switch direction back to input
-	P_SDA_DIR &= ~SDA_PIN;
-
-	g_ucCOMM_Flags &= ~COMM_RX_BUSY;
-
-	// Set the parity error flag
-	if (ucParityBit != ucRxParityBit)
-		g_ucCOMM_Flags |= COMM_PARITY_ERR;
-
-	g_ucaRXBuffer[g_ucRXBufferIndex] = ucRXByte;
-	g_ucRXBufferIndex++; // Increment index for next byte
-
-	return COMM_OK;
-
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//! \brief Shuts off the software modules
-//!
-//! This shuts down TimerA and disables all of the interrupts used
-//!   \param None
-//!   \return None
-//!   \sa vCOMM_Init()
-///////////////////////////////////////////////////////////////////////////////
-void vCOMM_Shutdown(void)
-{
-
-	// Disable RX interrupt
-	P_SCL_IE &= ~SCL_PIN;
-	g_ucCOMM_Flags &= ~COMM_RUNNING;
-
-	//Let SDA drop
-	P_SDA_OUT &= ~SDA_PIN;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Waits for a message on the serial line
-//!
-//!
-//! \param none
-//! \return none
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucCOMM_WaitForMessage(void)
-{
-
-uint8 ucRXMessageSize;
-
- // Set the size of the received message to the minimum
-	ucRXMessageSize = SP_HEADERSIZE;
-
-	// Wait to receive the message
-	do {
-
-		if (ucCOMM_ReceiveByte()) {
-			return COMM_ERROR;
-		}
-
-		// If we have received the header of the message, update the RX message to
-		// the size of the message received
-		if (g_ucRXBufferIndex == SP_HEADERSIZE) {
-			ucRXMessageSize = g_ucaRXBuffer[MSG_LEN_IDX] + CRC_SZ;
-
-			// Range check the g_ucRXMessageSize variable
-			if (ucRXMessageSize > MAXMSGLEN || ucRXMessageSize < SP_HEADERSIZE)
-				return COMM_ERROR;
-		}
-
-	}
-	while (g_ucRXBufferIndex != ucRXMessageSize);
-
-	// No message received
-	if (g_ucRXBufferIndex == 0) {
-		return COMM_ERROR;
-	}
-
-	//success
-	return 0;
-
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//! \brief Sends a data message on the serial port
-//!
-//! This function sends the data message pointed to by \e p_DataMessage on the
-//! software UART line
-//!   \param p_DataMessage Pointer to the message to send
-//!   \return None
-///////////////////////////////////////////////////////////////////////////////.
-void vCOMM_SendMessage(volatile uint8 * pBuff, uint8 ucLength)
-{
-	uint8 ucLoopCount;
-	uint8 ucErrorCount;
-
-	// Clear error count
-	ucErrorCount = 0;
-
-	// add the CRC bytes to the length
-	ucLength += CRC_SZ;
-
-	// Compute the CRC of the message
-	ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_SEND, pBuff, ucLength);
-
-	for (ucLoopCount = 0x00; ucLoopCount < ucLength; ucLoopCount++) {
-
-		// Attempt to send a byte
-		if (ucCOMM_SendByte(*pBuff++) != COMM_OK) {
-
-			// If there is an error then increment the error count
-			ucErrorCount++;
-
-			// Decrement the loop count to attempt to resend the byte
-			ucLoopCount--;
-
-			// If the error count reaches 5 then consider this a failure
-			if (ucErrorCount == 5)
-				break;
-		}
-	}
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//! \brief Grabs the raw chars from buffer and formats into a data message
-//!
-//! This function takes the characters from \e g_ucaRXBuffer and
-//! stores them in the data message pointed to by \e message.
-//!   \param message Pointer to the message
-//!   \return The error code indicating the status after call
-//!   \sa comm.h msg.h
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucCOMM_GrabMessageFromBuffer(volatile uint8 * pucBuff)
-{
-	uint8 ucLoopCount;
-	uint8 ucLength;
-
-	if (g_ucRXBufferIndex < SP_HEADERSIZE)
-		return COMM_BUFFER_UNDERFLOW;
-
-	// Read the length of the message
-	ucLength = g_ucaRXBuffer[MSG_LEN_IDX];
-
-	// If the message is to long return error
-	if (ucLength > MAXMSGLEN)
-		return COMM_BUFFER_UNDERFLOW;
-
-	// Check the CRC of the message
-	if (!ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_REC, g_ucaRXBuffer, g_ucaRXBuffer[MSG_LEN_IDX] + CRC_SZ))
-		return COMM_ERROR;
-
-	for (ucLoopCount = 0x00; ucLoopCount < ucLength; ucLoopCount++)
-		*pucBuff++ = g_ucaRXBuffer[ucLoopCount];
-
-	// Reset the RX index
-	g_ucRXBufferIndex = 0x00;
-
-	return COMM_OK;
-}
-
-//! @}
-//! @}
-
+///////////////////////////////////////////////////////////////////////////////
+//! \file comm.c
+//! \brief This modules implements a software I2C on any two Digital I/O pins
+//!
+//! This module uses Port 2 to implement a software I2C on any two defined
+//! digital I/O pin. Note that the serial clock (SCL) pin must be interrupt capable.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup comm Software I2C
+//! The software I2C module allows the user to define a I2C interface on
+//! any two GPIO pins, provided that the SCL pin is interrupt capable.
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+//*****************************************************************************
+// By: Kenji Yamamoto
+//     Wireless Networks Research Lab
+//     Dept. of Electrical Engineering, CEFNS
+//     Northern Arizona University
+//
+// Edited By: Christopher Porter
+//*****************************************************************************
+
+#include "hal.h"
+#include "core.h"
+#include "comm.h"
+#include "crc.h"
+
+//******************  Control and Indication Variables  *********************//
+//! @name Control and Indication Variables
+//! These variables are used to indicate to the system the current status
+//! of the \ref comm Module and to store the baud rate timer information.
+//! @{
+//! \var volatile uint8 g_ucCOMM_Flags
+//! \brief This 8-bit field indicates the status of the COMM module.
+volatile uint8 g_ucCOMM_Flags;
+
+//! \var uint16 g_unCOMM_BaudRateControl
+//! \brief This is the value used to control the baud rate.
+//!
+//! This value is the number of timer ticks corresponding to one bit period
+//! for the baud rate. It should be set from the \ref comm_baud
+//! "Baud Rate Defines".
+uint16 g_unCOMM_BaudRateControl;
+
+//! \var uint16 g_unCOMM_BaudRateDelayControl
+//! \brief This is the value used to delay from the start bit
+//!
+//! This value is the number of timer ticks to wait from the beginning of the
+//! start bit to the middle of the first data bit. It should be set from the
+//! \ref comm_baud_delay "Baud Rate Start Delays".
+uint16 g_unCOMM_BaudRateDelayControl;
+//! @}
+
+//******************  RX Variables  *****************************************//
+//! @name Receive Variables
+//! These variables are used in the receiving of data on the \ref comm Module.
+//! @{
+//! \var volatile uint8 g_ucaRXBuffer[MAXMSGLEN]
+//! \brief The software UART RX Buffer
+volatile uint8 g_ucaRXBuffer[MAXMSGLEN];
+
+//! \var volatile uint8 g_ucRXBufferIndex
+//! \brief This index into g_ucaRXBuffer showing the current write position.
+volatile uint8 g_ucRXBufferIndex;
+
+//! \var uint8 g_ucRXBitsLeft
+//! \brief The number of bits left to be received for the current byte.
+uint8 g_ucRXBitsLeft;
+
+//! \var uint8 g_ucRXParityBit
+//! \brief Even Parity for bit banging uart
+uint8 ucRXParityBit;
+//! @}
+
+//******************  Bit Macros  *******************************************//
+//! @name Bit Macros
+//! One bit of a byte on the wire.  Unrolled eight times per byte so every
+//! mask is a constant and no loop counter or shift is needed between edges.
+//! @{
+//! \def COMM_TX_BIT
+//! \brief Drives SDA from \e ucMask of \e ucValue and waits for the falling clock
+#define COMM_TX_BIT(ucValue, ucMask)			\
+	{											\
+		if ((ucValue) & (ucMask))				\
+			P_SDA_OUT |= SDA_PIN;				\
+		else									\
+			P_SDA_OUT &= ~SDA_PIN;				\
+		HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);		\
+		P_SCL_IFG &= ~SCL_PIN;					\
+	}
+
+//! \def COMM_RX_BIT
+//! \brief Waits for the rising clock and ORs \e ucMask into \e ucValue if SDA is high
+#define COMM_RX_BIT(ucValue, ucMask)			\
+	{											\
+		HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);		\
+		P_SCL_IFG &= ~SCL_PIN;					\
+		if (P_SDA_IN & SDA_PIN)					\
+			(ucValue) |= (ucMask);				\
+	}
+
+//! \def COMM_PARITY
+//! \brief Even parity of a byte, XOR folded to a nibble and looked up
+#define COMM_PARITY(ucByte)		(g_ucaCOMM_NibbleParity[((ucByte) ^ ((ucByte) >> 4)) & 0x0F])
+//! @}
+
+//! \var g_ucaCOMM_NibbleParity
+//! \brief Parity of the values 0 to 15
+static const uint8 g_ucaCOMM_NibbleParity[16] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
+
+//! \var g_ucCOMM_LinkMode
+//! \brief The negotiated COMM_LINK bits
+static uint8 g_ucCOMM_LinkMode = 0;
+
+//******************  Transmit Engine Variables  ****************************//
+//! @name Transmit Engine Variables
+//! State of the interrupt driven transmit engine, shared with PORT2_ISR().
+//! The phase is the data bit on SDA (0 to 7) or one of the COMM_TX_PHASE
+//! values.
+//! @{
+#define COMM_TX_PHASE_PARITY	8	//!< Parity bit on SDA
+#define COMM_TX_PHASE_ACK		9	//!< SDA released, waiting for the rising ack clock
+#define COMM_TX_PHASE_ACK_END	10	//!< Ack sampled, waiting for the falling ack clock
+#define COMM_TX_PHASE_DONE		11	//!< Frame complete
+
+//! \var g_pucCOMM_TxData
+//! \brief The byte being sent
+static volatile uint8 * g_pucCOMM_TxData;
+
+//! \var g_ucCOMM_TxLeft
+//! \brief Bytes left to send, including the current one
+static volatile uint8 g_ucCOMM_TxLeft;
+
+//! \var g_ucCOMM_TxShift
+//! \brief The data bits of the current byte not yet on SDA
+static volatile uint8 g_ucCOMM_TxShift;
+
+//! \var g_ucCOMM_TxParity
+//! \brief The parity bit of the current byte
+static volatile uint8 g_ucCOMM_TxParity;
+
+//! \var g_ucCOMM_TxPhase
+static volatile uint8 g_ucCOMM_TxPhase;
+
+//! \var g_ucCOMM_TxAck
+//! \brief SDA as sampled on the rising ack clock, zero for an ack
+static volatile uint8 g_ucCOMM_TxAck;
+
+//! \var g_ucCOMM_TxErrors
+//! \brief Nacks received in the current frame
+static volatile uint8 g_ucCOMM_TxErrors;
+
+//! \var g_ucCOMM_TxBurst
+//! \brief Nonzero if the current frame is a burst frame
+static volatile uint8 g_ucCOMM_TxBurst;
+
+//! \var g_ucCOMM_TxResult
+//! \brief COMM_OK, COMM_ACK_ERR or COMM_TIMEOUT_ERR once the frame is done
+static volatile uint8 g_ucCOMM_TxResult;
+//! @}
+
+//! \var uint16 g_uiaCOMM_Stats[COMM_STAT_COUNT]
+//! \brief The link statistics, indexed by the COMM_STAT defines
+uint16 g_uiaCOMM_Stats[COMM_STAT_COUNT] = {0};
+
+
+//******************  Functions  ********************************************//
+///////////////////////////////////////////////////////////////////////////////
+//! \brief This sets up the hardware resources for doing software UART
+//!
+//! Since we are doing UART without the USCI, we use TimerA and it's interrupt
+//! to control the baud rate. The SDA and SCL pins are completely controllable
+//! at compile time. The software UART expects 1 start bit, 8 data bits and
+//! 1 stop bit.
+//!
+//! To ensure correct operation of the software UART, the \ref comm_pins
+//! "Comm Pin Defines" must be set correctly.
+//!   \param ucBaud The baud rate define to use
+//!   \return None
+//!   \sa vCOMM_SendByte(), TIMERA0_ISR()
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_Init()
+{
+	// We set the directionality of the SDA and SCL pins based on the defines
+	P_SDA_DIR &= ~SDA_PIN;
+	P_SCL_DIR &= ~SCL_PIN;
+
+	// Clear the RX buffer and reset index
+	g_ucRXBufferIndex = MAXMSGLEN;
+	while (g_ucRXBufferIndex) {
+		g_ucRXBufferIndex--;
+		g_ucaRXBuffer[g_ucRXBufferIndex] = 0xFF;
+	}
+	g_ucRXBufferIndex = 0x00;
+
+	// Set up for falling edge interrupts on SCL
+	P_SCL_IES |= SCL_PIN;
+	P_SCL_IFG &= ~SCL_PIN;
+
+	// Set up falling edge interrupt on the SDA line (to handle start condition)
+	P_SDA_IES |= SDA_PIN;
+	P_SDA_IFG &= ~SDA_PIN;
+
+	// The dedicated interrupt line stays an input until the ready line mode
+	// is negotiated.  It has no interrupt handler, so its interrupt is left off.
+	P_INT_OUT &= ~INT_PIN;
+	P_INT_DIR &= ~INT_PIN;
+	P_INT_IE &= ~INT_PIN;
+	P_INT_IFG &= ~INT_PIN;
+
+	// Timer_A free runs from ACLK as the bus timeout base
+	TACCTL1 = 0;
+	TACTL = TASSEL_1 | ID_0 | MC_2 | TACLR;
+
+	g_ucCOMM_Flags = COMM_RUNNING;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Starts the bus timeout
+//!
+//! TAR is clocked from ACLK, asynchronous to MCLK, so it is read until two
+//! reads agree.
+//!   \param uiTicks ACLK ticks until the timeout expires
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_ArmTimeout(uint16 uiTicks)
+{
+	uint16 uiNow;
+
+	do {
+		uiNow = TAR;
+	}
+	while (uiNow != TAR);
+
+	TACCR1 = uiNow + uiTicks;
+	TACCTL1 = CCIE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Stops the bus timeout
+//!   \param None
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_DisarmTimeout(void)
+{
+	TACCTL1 = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the negotiated link mode
+//!   \param None
+//!   \return The COMM_LINK bits in effect
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucCOMM_GetLinkMode(void)
+{
+	return g_ucCOMM_LinkMode;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Switches the link mode
+//!
+//! Called once the reply to a LINK_MODE message has been sent, so the reply
+//! still goes out in the old mode.  Unsupported bits are ignored.
+//!   \param ucMode The requested COMM_LINK bits
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_SetLinkMode(uint8 ucMode)
+{
+	g_ucCOMM_LinkMode = ucMode & COMM_LINK_SUPPORTED;
+
+	// The interrupt line is only driven in the ready line mode, starting ready
+	P_INT_OUT &= ~INT_PIN;
+	if (g_ucCOMM_LinkMode & COMM_LINK_READY_LINE)
+		P_INT_DIR |= INT_PIN;
+	else
+		P_INT_DIR &= ~INT_PIN;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Tells the CP that the SP is busy
+//!
+//! Drives the interrupt line high.  Outside of the ready line mode the pin
+//! is an input and the write has no effect.
+//!   \param None
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_SignalBusy(void)
+{
+	P_INT_OUT |= INT_PIN;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Tells the CP that the SP is ready for the next clock
+//!   \param None
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_SignalReady(void)
+{
+	P_INT_OUT &= ~INT_PIN;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Waits for the start signal from the CP board
+//!
+//! Officially the start condition does not include pulling the clock line low,
+//! but the clock needs to be low before entering the send and receive bytes
+//! functions.
+//!
+//!          __________________________
+//! SCL _____|                         |____
+//!           _________________
+//! SDA _____|                 |_____________
+//!
+//!   \param None
+//!   \return 1 if start condition received else 0
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucCOMM_WaitForStartCondition(void)
+{
+	// Clear the flags, a new transaction starts with a clean slate
+	g_ucCOMM_Flags &= ~(COMM_START_CONDITION | COMM_TIMEOUT);
+
+	// Nothing partial survives into the next transaction
+	vCOMM_DisarmTimeout();
+	vCOMM_ResetRX();
+	P_SDA_DIR &= ~SDA_PIN;
+
+	// Listening for the CP is being ready
+	vCOMM_SignalReady();
+
+	// Enable interrupts on the SDA line
+	P_SDA_IFG &= ~SDA_PIN;
+	P_SDA_IE |= SDA_PIN;
+
+	// Wait in deep sleep
+	LPM3;
+
+	// Disable interrupts on the SDA line
+	P_SDA_IE &= ~SDA_PIN;
+
+	// Prepare for communication if the start condition flag is set
+	if (g_ucCOMM_Flags & COMM_START_CONDITION) {
+
+		// Clear the flag
+		g_ucCOMM_Flags &= ~COMM_START_CONDITION;
+
+		// Enable interrupts on the falling edge of the clock line
+		P_SCL_IFG &= ~SCL_PIN;
+		P_SCL_IES |= SCL_PIN;
+
+		// Wait for the clock to go low then clear the flag
+		vCOMM_ArmTimeout(COMM_BYTE_TIMEOUT_TICKS);
+		HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+		P_SCL_IFG &= ~SCL_PIN;
+
+		// A glitch on SDA is not a start condition
+		if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+			g_uiaCOMM_Stats[COMM_STAT_TIMEOUT]++;
+			return 0;
+		}
+
+		return 1;
+	}
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sends a byte via the software I2C
+//!
+//! This function has been optimized for speed and therefore appears cumbersome
+//! by most coding standards.  The bits are unrolled with COMM_TX_BIT so every
+//! bit test is against a constant mask and the pins are addressed through
+//! constants the constant generator supplies.  The parity is folded from the
+//! nibble table before the first edge.
+//!
+//!   \param ucTXChar The 8-bit value to send
+//!   \return COMM_OK, COMM_ACK_ERR if the CP did not acknowledge,
+//!   COMM_TIMEOUT_ERR if the CP stopped clocking, or COMM_ERROR
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucCOMM_SendByte(uint8 ucTXChar)
+{
+	uint8 ucAck;
+	uint8 ucParityBit;
+
+	// If we are already busy, return
+	if (g_ucCOMM_Flags & COMM_TX_BUSY)
+		return COMM_ERROR;
+
+	// Indicate in the status register that we are now busy
+	g_ucCOMM_Flags |= COMM_TX_BUSY;
+
+	// Calculate the parity bit prior to transmission
+	ucParityBit = COMM_PARITY(ucTXChar);
+
+	// Enable interrupts on the falling edge of the clock line
+	P_SCL_IFG &= ~SCL_PIN;
+	P_SCL_IES |= SCL_PIN;
+
+	// Set the direction of the data line to output
+	P_SDA_DIR |= SDA_PIN;
+
+	// Data bits, LSB first
+	COMM_TX_BIT(ucTXChar, BIT0);
+	COMM_TX_BIT(ucTXChar, BIT1);
+	COMM_TX_BIT(ucTXChar, BIT2);
+	COMM_TX_BIT(ucTXChar, BIT3);
+	COMM_TX_BIT(ucTXChar, BIT4);
+	COMM_TX_BIT(ucTXChar, BIT5);
+	COMM_TX_BIT(ucTXChar, BIT6);
+	COMM_TX_BIT(ucTXChar, BIT7);
+
+	// Even parity bit
+	COMM_TX_BIT(ucParityBit, BIT0);
+
+	// Next bit is ack so switch the direction of the SDA pin
+	P_SDA_DIR &= ~SDA_PIN;
+
+	// Switch clock edge interrupt
+	P_SCL_IES &= ~SCL_PIN;
+
+	// Wait for the next rising clock
+	HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+	P_SCL_IFG &= ~SCL_PIN;
+
+	// Last bit is ack bit, return to idle state
+	ucAck = (P_SDA_IN & SDA_PIN);
+
+	// Switch clock edge interrupt
+	P_SCL_IES |= SCL_PIN;
+
+	// Wait for the next clock
+	HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+	P_SCL_IFG &= ~SCL_PIN;
+
+	g_ucCOMM_Flags &= ~COMM_TX_BUSY;
+
+	// The CP stopped clocking, the bits above ran out on the timer
+	if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+		vCOMM_DisarmTimeout();
+		P_SDA_DIR &= ~SDA_PIN;
+		return COMM_TIMEOUT_ERR;
+	}
+
+	g_uiaCOMM_Stats[COMM_STAT_BYTES_TX]++;
+
+	if (ucAck) {
+		g_uiaCOMM_Stats[COMM_STAT_ACK_ERR]++;
+		return COMM_ACK_ERR;
+	}
+	else
+		return COMM_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Vets one header byte as it arrives
+//!
+//! Refuses types that vCORE_Run() does not serve, lengths that cannot fit
+//! the RX buffer and versions outside of major version 1.  The flags byte is
+//! not checked.
+//!   \param ucIdx The index of the byte in the frame
+//!   \param ucByte The received byte
+//!   \return Nonzero if the frame must be refused
+///////////////////////////////////////////////////////////////////////////////
+static uint8 ucCOMM_RejectHeaderByte(uint8 ucIdx, uint8 ucByte)
+{
+	switch (ucIdx) {
+		case MSG_TYP_IDX:
+			return (ucByte >= CORE_RX_TYPE_COUNT || !g_ucaCORE_RXTypes[ucByte]);
+
+		case MSG_LEN_IDX:
+			return (ucByte < SP_HEADERSIZE || ucByte > MAXMSGLEN - CRC_SZ);
+
+		case MSG_VER_IDX:
+			return (ucByte < SP_VERSION_MIN || ucByte > SP_VERSION_MAX);
+
+		default:
+			return 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Receives a byte via the software I2C
+//!
+//! This function has been optimized for speed and therefore appears cumbersome
+//! by most coding standards.  The bits are unrolled with COMM_RX_BIT so each
+//! one is a single OR of a constant mask.  The parity is checked once, in the
+//! half clock between the parity bit and the ack bit.  With
+//! COMM_LINK_HEADER_NACK the header bytes are also vetted, in the low half of
+//! the ack clock, and a bad one is nacked at once.
+//!
+//!   \param none
+//!   \return COMM_OK, COMM_HEADER_ERR if the frame was refused,
+//!   COMM_TIMEOUT_ERR or COMM_ERROR
+//!   \sa vCOMM_Init()
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucCOMM_ReceiveByte(void)
+{
+	uint8 ucRxParityBit; // The received parity bit
+	uint8 ucNack; // Nonzero if the parity check failed
+	uint8 ucReject; // Nonzero if the header byte was refused
+	uint8 ucRXByte;
+
+	// If we are already busy, return
+	if (g_ucCOMM_Flags & COMM_RX_BUSY)
+		return COMM_ERROR;
+
+	// Indicate in the status register that we are now busy
+	g_ucCOMM_Flags |= COMM_RX_BUSY;
+
+	ucRXByte = 0;
+	ucRxParityBit = 0;
+
+	// Enable interrupts on rising edges of the SCL line
+	P_SCL_IFG &= ~SCL_PIN;
+	P_SCL_IES &= ~SCL_PIN;
+
+	// Set the direction of the data line to input
+	P_SDA_DIR &= ~SDA_PIN;
+
+	// Data bits, LSB first
+	COMM_RX_BIT(ucRXByte, BIT0);
+	COMM_RX_BIT(ucRXByte, BIT1);
+	COMM_RX_BIT(ucRXByte, BIT2);
+	COMM_RX_BIT(ucRXByte, BIT3);
+	COMM_RX_BIT(ucRXByte, BIT4);
+	COMM_RX_BIT(ucRXByte, BIT5);
+	COMM_RX_BIT(ucRXByte, BIT6);
+	COMM_RX_BIT(ucRXByte, BIT7);
+
+	// Parity bit
+	COMM_RX_BIT(ucRxParityBit, BIT0);
+
+	// Set the interrupt edge select for falling
+	P_SCL_IES |= SCL_PIN;
+
+	// Check the parity while the clock is high
+	ucNack = COMM_PARITY(ucRXByte) ^ ucRxParityBit;
+
+	// Wait for the next falling clock
+	HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+	P_SCL_IFG &= ~SCL_PIN;
+
+	// Vet the header bytes while the CP holds the ack clock low
+	ucReject = 0;
+	if (g_ucRXBufferIndex < SP_HEADERSIZE && (g_ucCOMM_LinkMode & COMM_LINK_HEADER_NACK))
+		ucReject = ucCOMM_RejectHeaderByte(g_ucRXBufferIndex, ucRXByte);
+
+	// If the calculated and received parity bits match then send ack, else nack
+	if (ucNack | ucReject)
+		P_SDA_OUT |= SDA_PIN;
+	else
+		P_SDA_OUT &= ~SDA_PIN;
+
+	// Next bit is ack so switch the direction of the SDA pin
+	P_SDA_DIR |= SDA_PIN;
+
+	// Wait for the next falling clock clock
+	HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+	P_SCL_IFG &= ~SCL_PIN;
+
+	// Switch direction back to input
+	P_SDA_DIR &= ~SDA_PIN;
+
+	g_ucCOMM_Flags &= ~COMM_RX_BUSY;
+
+	// The CP stopped clocking, the byte is not valid
+	if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+		vCOMM_DisarmTimeout();
+		return COMM_TIMEOUT_ERR;
+	}
+
+	g_uiaCOMM_Stats[COMM_STAT_BYTES_RX]++;
+
+	// The CP stops on the nack, nothing of the frame is kept
+	if (ucReject) {
+		g_uiaCOMM_Stats[COMM_STAT_HEADER_REJECT]++;
+		vCOMM_ResetRX();
+		return COMM_HEADER_ERR;
+	}
+
+	// Set the parity error flag
+	if (ucNack) {
+		g_ucCOMM_Flags |= COMM_PARITY_ERR;
+		g_uiaCOMM_Stats[COMM_STAT_PARITY_ERR]++;
+	}
+
+	g_ucaRXBuffer[g_ucRXBufferIndex] = ucRXByte;
+	g_ucRXBufferIndex++; // Increment index for next byte
+
+	return COMM_OK;
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Receives a whole frame in burst mode
+//!
+//! The bytes are 8 clocks each with no parity or ack.  After the last byte
+//! the CRC is checked while the CP holds SCL low, and the result is driven
+//! on the frame ack clock.  A bad frame drops the link to the standard mode,
+//! the CP does the same when it sees the nack.
+//!
+//! The timeout is armed once for the whole frame, re-arming between bytes
+//! would not fit the half clock.
+//!
+//!   \param none
+//!   \return COMM_OK, COMM_HEADER_ERR if the frame was nacked or
+//!   COMM_TIMEOUT_ERR
+///////////////////////////////////////////////////////////////////////////////
+static uint8 ucCOMM_ReceiveBurstFrame(void)
+{
+	uint8 ucRXByte;
+	uint8 ucRXMessageSize;
+	uint8 ucNack;
+
+	ucRXMessageSize = SP_HEADERSIZE;
+
+	vCOMM_ArmTimeout(COMM_FRAME_TIMEOUT_TICKS);
+
+	// Sample on rising edges of the SCL line
+	P_SCL_IFG &= ~SCL_PIN;
+	P_SCL_IES &= ~SCL_PIN;
+	P_SDA_DIR &= ~SDA_PIN;
+
+	do {
+		ucRXByte = 0;
+
+		COMM_RX_BIT(ucRXByte, BIT0);
+		COMM_RX_BIT(ucRXByte, BIT1);
+		COMM_RX_BIT(ucRXByte, BIT2);
+		COMM_RX_BIT(ucRXByte, BIT3);
+		COMM_RX_BIT(ucRXByte, BIT4);
+		COMM_RX_BIT(ucRXByte, BIT5);
+		COMM_RX_BIT(ucRXByte, BIT6);
+		COMM_RX_BIT(ucRXByte, BIT7);
+
+		g_ucaRXBuffer[g_ucRXBufferIndex++] = ucRXByte;
+
+		// The length is known once the header is in
+		if (g_ucRXBufferIndex == SP_HEADERSIZE) {
+			ucRXMessageSize = g_ucaRXBuffer[MSG_LEN_IDX] + CRC_SZ;
+
+			// The frame cannot be followed.  SDA is left released, so the
+			// CP reads a nack on its ack clock.
+			if (ucCOMM_RejectHeaderByte(MSG_LEN_IDX, g_ucaRXBuffer[MSG_LEN_IDX])) {
+				g_uiaCOMM_Stats[COMM_STAT_HEADER_REJECT]++;
+				vCOMM_DisarmTimeout();
+				g_uiaCOMM_Stats[COMM_STAT_BURST_FALLBACK]++;
+				g_ucCOMM_LinkMode &= ~COMM_LINK_BURST;
+				vCOMM_ResetRX();
+				return COMM_HEADER_ERR;
+			}
+		}
+	}
+	while (g_ucRXBufferIndex != ucRXMessageSize && !(g_ucCOMM_Flags & COMM_TIMEOUT));
+
+	g_uiaCOMM_Stats[COMM_STAT_BYTES_RX] += g_ucRXBufferIndex;
+
+	// Wait for the falling clock after the last data bit
+	P_SCL_IES |= SCL_PIN;
+	HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+	P_SCL_IFG &= ~SCL_PIN;
+
+	if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+		vCOMM_DisarmTimeout();
+		g_ucCOMM_LinkMode &= ~COMM_LINK_BURST;
+		return COMM_TIMEOUT_ERR;
+	}
+
+	// Vet the rest of the header, then check the CRC, while the CP holds the
+	// clock low.  A refused header costs no CRC.
+	ucNack = ucCOMM_RejectHeaderByte(MSG_TYP_IDX, g_ucaRXBuffer[MSG_TYP_IDX])
+			| ucCOMM_RejectHeaderByte(MSG_VER_IDX, g_ucaRXBuffer[MSG_VER_IDX]);
+
+	if (ucNack)
+		g_uiaCOMM_Stats[COMM_STAT_HEADER_REJECT]++;
+	else if (!ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_REC, g_ucaRXBuffer, ucRXMessageSize)) {
+		ucNack = TRUE;
+		g_uiaCOMM_Stats[COMM_STAT_CRC_ERR]++;
+	}
+
+	// Frame ack clock
+	if (ucNack)
+		P_SDA_OUT |= SDA_PIN;
+	else
+		P_SDA_OUT &= ~SDA_PIN;
+
+	P_SDA_DIR |= SDA_PIN;
+
+	HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+	P_SCL_IFG &= ~SCL_PIN;
+
+	P_SDA_DIR &= ~SDA_PIN;
+
+	vCOMM_DisarmTimeout();
+
+	if (ucNack) {
+		g_uiaCOMM_Stats[COMM_STAT_BURST_FALLBACK]++;
+		g_ucCOMM_LinkMode &= ~COMM_LINK_BURST;
+		vCOMM_ResetRX();
+		return COMM_HEADER_ERR;
+	}
+
+	// ucCOMM_GrabMessageFromBuffer() need not check it again
+	g_ucCOMM_Flags |= COMM_CRC_CHECKED;
+
+	return COMM_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sends a whole frame in burst mode
+//!
+//! The bytes are 8 clocks each with no parity or ack.  The CP checks the CRC
+//! and acknowledges the frame on one extra clock.
+//!
+//!   \param pBuff Pointer to the frame to send
+//!   \param ucLength Length of the frame including the CRC bytes
+//!   \return COMM_OK, COMM_ACK_ERR if the CP rejected the frame or
+//!   COMM_TIMEOUT_ERR
+///////////////////////////////////////////////////////////////////////////////
+static uint8 ucCOMM_SendBurstFrame(volatile uint8 * pBuff, uint8 ucLength)
+{
+	uint8 ucTXChar;
+	uint8 ucAck;
+
+	vCOMM_ArmTimeout(COMM_FRAME_TIMEOUT_TICKS);
+
+	g_uiaCOMM_Stats[COMM_STAT_BYTES_TX] += ucLength;
+
+	// Drive SDA, change it after falling edges
+	P_SCL_IFG &= ~SCL_PIN;
+	P_SCL_IES |= SCL_PIN;
+	P_SDA_DIR |= SDA_PIN;
+
+	do {
+		ucTXChar = *pBuff++;
+
+		COMM_TX_BIT(ucTXChar, BIT0);
+		COMM_TX_BIT(ucTXChar, BIT1);
+		COMM_TX_BIT(ucTXChar, BIT2);
+		COMM_TX_BIT(ucTXChar, BIT3);
+		COMM_TX_BIT(ucTXChar, BIT4);
+		COMM_TX_BIT(ucTXChar, BIT5);
+		COMM_TX_BIT(ucTXChar, BIT6);
+		COMM_TX_BIT(ucTXChar, BIT7);
+	}
+	while (--ucLength && !(g_ucCOMM_Flags & COMM_TIMEOUT));
+
+	// Release SDA for the frame ack clock
+	P_SDA_DIR &= ~SDA_PIN;
+
+	P_SCL_IES &= ~SCL_PIN;
+	HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+	P_SCL_IFG &= ~SCL_PIN;
+
+	ucAck = (P_SDA_IN & SDA_PIN);
+
+	P_SCL_IES |= SCL_PIN;
+	HAL_WAIT_FLAG(P_SCL_IFG, SCL_PIN);
+	P_SCL_IFG &= ~SCL_PIN;
+
+	vCOMM_DisarmTimeout();
+
+	if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+		g_ucCOMM_LinkMode &= ~COMM_LINK_BURST;
+		return COMM_TIMEOUT_ERR;
+	}
+
+	if (ucAck) {
+		g_uiaCOMM_Stats[COMM_STAT_ACK_ERR]++;
+		return COMM_ACK_ERR;
+	}
+
+	return COMM_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Shuts off the software modules
+//!
+//! This shuts down TimerA and disables all of the interrupts used
+//!   \param None
+//!   \return None
+//!   \sa vCOMM_Init()
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_Shutdown(void)
+{
+
+	// Disable RX interrupt
+	P_SCL_IE &= ~SCL_PIN;
+	g_ucCOMM_Flags &= ~COMM_RUNNING;
+
+	// Stop the timeout base
+	vCOMM_DisarmTimeout();
+	TACTL = MC_0;
+
+	//Let SDA drop
+	P_SDA_OUT &= ~SDA_PIN;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Waits for a message on the serial line
+//!
+//! A frame the SP nacked is abandoned by the CP, which then waits for no
+//! reply.  The caller must not answer it.
+//!
+//! \param none
+//! \return COMM_OK, COMM_HEADER_ERR if the frame was nacked,
+//! COMM_TIMEOUT_ERR or COMM_ERROR
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucCOMM_WaitForMessage(void)
+{
+
+uint8 ucRXMessageSize;
+uint8 ucResult;
+
+ // Set the size of the received message to the minimum
+	ucRXMessageSize = SP_HEADERSIZE;
+
+	// A transaction that already timed out is not resumed
+	if (g_ucCOMM_Flags & COMM_TIMEOUT)
+		return COMM_TIMEOUT_ERR;
+
+	// Ready for the next frame of a window
+	vCOMM_SignalReady();
+
+	if (g_ucCOMM_LinkMode & COMM_LINK_BURST) {
+		ucResult = ucCOMM_ReceiveBurstFrame();
+
+		if (ucResult == COMM_OK) {
+			vCOMM_SignalBusy();
+			return COMM_OK;
+		}
+
+		if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+			g_uiaCOMM_Stats[COMM_STAT_TIMEOUT]++;
+			vCOMM_ResetRX();
+			return COMM_TIMEOUT_ERR;
+		}
+
+		return ucResult;
+	}
+
+	// Wait to receive the message
+	do {
+
+		// The CP may pause before a frame, but not inside one
+		if (g_ucRXBufferIndex == 0)
+			vCOMM_ArmTimeout(COMM_FRAME_TIMEOUT_TICKS);
+		else
+			vCOMM_ArmTimeout(COMM_BYTE_TIMEOUT_TICKS);
+
+		ucResult = ucCOMM_ReceiveByte();
+
+		if (ucResult) {
+			vCOMM_DisarmTimeout();
+
+			if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+				g_uiaCOMM_Stats[COMM_STAT_TIMEOUT]++;
+				vCOMM_ResetRX();
+				return COMM_TIMEOUT_ERR;
+			}
+
+			// The CP stopped on the nack
+			if (ucResult == COMM_HEADER_ERR)
+				return COMM_HEADER_ERR;
+
+			return COMM_ERROR;
+		}
+
+		// If we have received the header of the message, update the RX message to
+		// the size of the message received.  With COMM_LINK_HEADER_NACK
+		// ucCOMM_ReceiveByte() has already range checked the length.
+		if (g_ucRXBufferIndex == SP_HEADERSIZE) {
+			ucRXMessageSize = g_ucaRXBuffer[MSG_LEN_IDX] + CRC_SZ;
+
+			if (ucCOMM_RejectHeaderByte(MSG_LEN_IDX, g_ucaRXBuffer[MSG_LEN_IDX])) {
+				vCOMM_DisarmTimeout();
+				g_uiaCOMM_Stats[COMM_STAT_HEADER_REJECT]++;
+				vCOMM_ResetRX();
+				return COMM_ERROR;
+			}
+		}
+
+	}
+	while (g_ucRXBufferIndex != ucRXMessageSize);
+
+	vCOMM_DisarmTimeout();
+
+	// No message received
+	if (g_ucRXBufferIndex == 0) {
+		return COMM_ERROR;
+	}
+
+	// Busy until the reply is ready or the SP listens again
+	vCOMM_SignalBusy();
+
+	//success
+	return 0;
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Puts the first bit of the current byte on SDA
+//!
+//! Called with SCL low, before the rising edge the CP samples the bit on.
+//!   \param None
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+static void vCOMM_TxLoadByte(void)
+{
+	uint8 ucTXChar;
+
+	ucTXChar = *g_pucCOMM_TxData;
+
+	g_ucCOMM_TxParity = COMM_PARITY(ucTXChar);
+
+	if (ucTXChar & BIT0)
+		P_SDA_OUT |= SDA_PIN;
+	else
+		P_SDA_OUT &= ~SDA_PIN;
+
+	g_ucCOMM_TxShift = ucTXChar >> 1;
+	g_ucCOMM_TxPhase = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Ends the frame of the transmit engine
+//!
+//! Releases the bus and lets PORT2_ISR() wake the sender, which returns the
+//! outcome.
+//!   \param ucResult COMM_OK, COMM_ACK_ERR or COMM_TIMEOUT_ERR
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+static void vCOMM_TxFinish(uint8 ucResult)
+{
+	P_SCL_IE &= ~SCL_PIN;
+	P_SDA_DIR &= ~SDA_PIN;
+
+	g_ucCOMM_TxResult = ucResult;
+	g_ucCOMM_TxPhase = COMM_TX_PHASE_DONE;
+	g_ucCOMM_Flags &= ~COMM_TX_BUSY;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Handles the falling edge that ends an ack clock
+//!
+//! A standard frame moves to the next byte, or sends the same byte again
+//! after a nack, as vCOMM_SendFrame() does.  A burst frame is complete.
+//!   \param None
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+static void vCOMM_TxAckDone(void)
+{
+	if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+		vCOMM_TxFinish(COMM_TIMEOUT_ERR);
+		return;
+	}
+
+	if (!g_ucCOMM_TxBurst)
+		g_uiaCOMM_Stats[COMM_STAT_BYTES_TX]++;
+
+	if (g_ucCOMM_TxAck) {
+		g_uiaCOMM_Stats[COMM_STAT_ACK_ERR]++;
+
+		if (g_ucCOMM_TxBurst || ++g_ucCOMM_TxErrors == 5) {
+			vCOMM_TxFinish(COMM_ACK_ERR);
+			return;
+		}
+	}
+	else {
+		if (g_ucCOMM_TxBurst || --g_ucCOMM_TxLeft == 0) {
+			vCOMM_TxFinish(COMM_OK);
+			return;
+		}
+
+		g_pucCOMM_TxData++;
+	}
+
+	vCOMM_ArmTimeout(COMM_BYTE_TIMEOUT_TICKS);
+
+	vCOMM_TxLoadByte();
+	P_SDA_DIR |= SDA_PIN;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sends a frame with the interrupt driven transmit engine
+//!
+//! The bits are clocked out by PORT2_ISR() on the SCL edges while the CPU
+//! sleeps in LPM0.  Standard frames retry a nacked byte up to 5 times per
+//! frame.  Burst frames end in a frame ack and are not retried here.
+//!
+//! The interrupt entry and the state machine take about 60 cycles per edge,
+//! so the CP must keep SCL at or below COMM_IRQ_TX_MAX_SCL_KHZ.
+//!
+//!   \param pBuff Pointer to the frame to send
+//!   \param ucLength Length of the frame including the CRC bytes
+//!   \return COMM_OK, COMM_ACK_ERR, COMM_TIMEOUT_ERR or COMM_ERROR
+///////////////////////////////////////////////////////////////////////////////
+static uint8 ucCOMM_SendFrameIRQ(volatile uint8 * pBuff, uint8 ucLength)
+{
+	if (g_ucCOMM_Flags & COMM_TX_BUSY)
+		return COMM_ERROR;
+
+	g_ucCOMM_Flags |= COMM_TX_BUSY;
+
+	g_pucCOMM_TxData = pBuff;
+	g_ucCOMM_TxLeft = ucLength;
+	g_ucCOMM_TxErrors = 0;
+	g_ucCOMM_TxBurst = g_ucCOMM_LinkMode & COMM_LINK_BURST;
+
+	// The burst timeout covers the whole frame, as in the polled mode
+	vCOMM_ArmTimeout(COMM_FRAME_TIMEOUT_TICKS);
+
+	__disable_interrupt();
+
+	vCOMM_TxLoadByte();
+	P_SDA_DIR |= SDA_PIN;
+
+	// Interrupt on falling edges of the clock line
+	P_SCL_IES |= SCL_PIN;
+	P_SCL_IFG &= ~SCL_PIN;
+	P_SCL_IE |= SCL_PIN;
+
+	// Sleep until PORT2_ISR() finishes the frame
+	while (g_ucCOMM_Flags & COMM_TX_BUSY) {
+		__bis_SR_register(LPM0_bits + GIE);
+		__disable_interrupt();
+	}
+
+	__enable_interrupt();
+
+	vCOMM_DisarmTimeout();
+
+	switch (g_ucCOMM_TxResult) {
+		case COMM_OK:
+			g_uiaCOMM_Stats[COMM_STAT_FRAMES_TX]++;
+			break;
+
+		case COMM_TIMEOUT_ERR:
+			g_uiaCOMM_Stats[COMM_STAT_TIMEOUT]++;
+			g_ucCOMM_LinkMode &= ~COMM_LINK_BURST;
+			break;
+
+		default:
+			if (!g_ucCOMM_TxBurst)
+				g_uiaCOMM_Stats[COMM_STAT_TX_ABORT]++;
+			break;
+	}
+
+	return g_ucCOMM_TxResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Port 2 interrupt service routine, the transmit engine
+//!
+//! Runs on the SCL edges while ucCOMM_SendFrameIRQ() sleeps.  Each falling
+//! edge puts the next bit on SDA.  The ack is sampled on a rising edge.
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+HAL_ISR(PORT2_VECTOR, PORT2_ISR)
+{
+	DIAG_ISR_ENTER();
+
+	if ((P_SCL_IFG & SCL_PIN) && (P_SCL_IE & SCL_PIN)) {
+		P_SCL_IFG &= ~SCL_PIN;
+
+		switch (g_ucCOMM_TxPhase) {
+			case COMM_TX_PHASE_ACK:
+				// Rising edge of the ack clock
+				g_ucCOMM_TxAck = P_SDA_IN & SDA_PIN;
+				P_SCL_IES |= SCL_PIN;
+				g_ucCOMM_TxPhase = COMM_TX_PHASE_ACK_END;
+				break;
+
+			case COMM_TX_PHASE_ACK_END:
+				vCOMM_TxAckDone();
+				break;
+
+			case COMM_TX_PHASE_PARITY:
+				// Release SDA for the ack, the CP drives it on the next clock
+				P_SDA_DIR &= ~SDA_PIN;
+				P_SCL_IES &= ~SCL_PIN;
+				g_ucCOMM_TxPhase = COMM_TX_PHASE_ACK;
+				break;
+
+			case 7:
+				if (!g_ucCOMM_TxBurst) {
+					if (g_ucCOMM_TxParity)
+						P_SDA_OUT |= SDA_PIN;
+					else
+						P_SDA_OUT &= ~SDA_PIN;
+
+					g_ucCOMM_TxPhase = COMM_TX_PHASE_PARITY;
+					break;
+				}
+
+				g_uiaCOMM_Stats[COMM_STAT_BYTES_TX]++;
+
+				if (--g_ucCOMM_TxLeft != 0 && !(g_ucCOMM_Flags & COMM_TIMEOUT)) {
+					// Burst bytes follow each other directly
+					g_pucCOMM_TxData++;
+					vCOMM_TxLoadByte();
+				}
+				else {
+					// Release SDA for the frame ack
+					P_SDA_DIR &= ~SDA_PIN;
+					P_SCL_IES &= ~SCL_PIN;
+					g_ucCOMM_TxPhase = COMM_TX_PHASE_ACK;
+				}
+				break;
+
+			default:
+				// Data bits 1 to 7
+				if (g_ucCOMM_TxShift & BIT0)
+					P_SDA_OUT |= SDA_PIN;
+				else
+					P_SDA_OUT &= ~SDA_PIN;
+
+				g_ucCOMM_TxShift >>= 1;
+				g_ucCOMM_TxPhase++;
+				break;
+		}
+
+		if (g_ucCOMM_TxPhase == COMM_TX_PHASE_DONE)
+			__bic_SR_register_on_exit(LPM0_bits);
+	}
+
+	DIAG_ISR_EXIT();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sends a data message on the serial port
+//!
+//! This function sends the data message pointed to by \e p_DataMessage on the
+//! software UART line
+//!   \param p_DataMessage Pointer to the message to send
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////.
+void vCOMM_SendMessage(volatile uint8 * pBuff, uint8 ucLength)
+{
+	// add the CRC bytes to the length
+	ucLength += CRC_SZ;
+
+	// Compute the CRC of the message
+	ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_SEND, pBuff, ucLength);
+
+	vCOMM_SendFrame(pBuff, ucLength);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sends a frame which already carries its CRC
+//!
+//! Used directly for frames that were assembled ahead of time so nothing but
+//! the bit clocking is left to do when the CP asks for them.
+//!   \param pBuff Pointer to the frame to send
+//!   \param ucLength Length of the frame including the CRC bytes
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_SendFrame(volatile uint8 * pBuff, uint8 ucLength)
+{
+	uint8 ucLoopCount;
+	uint8 ucErrorCount;
+
+	// A transaction that already timed out is not resumed
+	if (g_ucCOMM_Flags & COMM_TIMEOUT)
+		return;
+
+	// The reply is staged, let the CP clock it
+	vCOMM_SignalReady();
+
+	if (g_ucCOMM_LinkMode & COMM_LINK_IRQ_TX) {
+		// The engine clocks burst frames too.  A nacked burst frame goes again
+		// in the standard mode, as below.
+		if (ucCOMM_SendFrameIRQ(pBuff, ucLength) == COMM_ACK_ERR && (g_ucCOMM_LinkMode & COMM_LINK_BURST)) {
+			g_uiaCOMM_Stats[COMM_STAT_BURST_FALLBACK]++;
+			g_ucCOMM_LinkMode &= ~COMM_LINK_BURST;
+			ucCOMM_SendFrameIRQ(pBuff, ucLength);
+		}
+		return;
+	}
+
+	if (g_ucCOMM_LinkMode & COMM_LINK_BURST) {
+		switch (ucCOMM_SendBurstFrame(pBuff, ucLength)) {
+			case COMM_OK:
+				g_uiaCOMM_Stats[COMM_STAT_FRAMES_TX]++;
+				return;
+
+			case COMM_TIMEOUT_ERR:
+				g_uiaCOMM_Stats[COMM_STAT_TIMEOUT]++;
+				return;
+
+			default:
+				// The CP nacked the frame and dropped to the standard mode,
+				// the frame goes again in that mode
+				g_uiaCOMM_Stats[COMM_STAT_BURST_FALLBACK]++;
+				g_ucCOMM_LinkMode &= ~COMM_LINK_BURST;
+				break;
+		}
+	}
+
+	// Clear error count
+	ucErrorCount = 0;
+
+	for (ucLoopCount = 0x00; ucLoopCount < ucLength; ucLoopCount++) {
+
+		// The CP may take a while to start clocking the reply, not to finish it
+		if (ucLoopCount == 0)
+			vCOMM_ArmTimeout(COMM_FRAME_TIMEOUT_TICKS);
+		else
+			vCOMM_ArmTimeout(COMM_BYTE_TIMEOUT_TICKS);
+
+		// Attempt to send a byte
+		if (ucCOMM_SendByte(pBuff[ucLoopCount]) != COMM_OK) {
+
+			// Nobody is clocking, retrying is pointless
+			if (g_ucCOMM_Flags & COMM_TIMEOUT) {
+				g_uiaCOMM_Stats[COMM_STAT_TIMEOUT]++;
+				return;
+			}
+
+			// If there is an error then increment the error count
+			ucErrorCount++;
+
+			// Decrement the loop count to attempt to resend the byte
+			ucLoopCount--;
+
+			// If the error count reaches 5 then consider this a failure, the
+			// frame was not sent
+			if (ucErrorCount == 5) {
+				vCOMM_DisarmTimeout();
+				g_uiaCOMM_Stats[COMM_STAT_TX_ABORT]++;
+				return;
+			}
+		}
+	}
+
+	vCOMM_DisarmTimeout();
+
+	g_uiaCOMM_Stats[COMM_STAT_FRAMES_TX]++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Grabs the raw chars from buffer and formats into a data message
+//!
+//! This function takes the characters from \e g_ucaRXBuffer and
+//! stores them in the data message pointed to by \e message.
+//!   \param message Pointer to the message
+//!   \return The error code indicating the status after call
+//!   \sa comm.h msg.h
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucCOMM_GrabMessageFromBuffer(volatile uint8 * pucBuff)
+{
+	uint8 ucLoopCount;
+	uint8 ucLength;
+
+	if (g_ucRXBufferIndex < SP_HEADERSIZE)
+		return COMM_BUFFER_UNDERFLOW;
+
+	// Read the length of the message
+	ucLength = g_ucaRXBuffer[MSG_LEN_IDX];
+
+	// If the message is to long return error
+	if (ucLength > MAXMSGLEN)
+		return COMM_BUFFER_UNDERFLOW;
+
+	// Check the CRC of the message, unless a burst frame already had it checked
+	if (g_ucCOMM_Flags & COMM_CRC_CHECKED)
+		g_ucCOMM_Flags &= ~COMM_CRC_CHECKED;
+	else if (!ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_REC, g_ucaRXBuffer, g_ucaRXBuffer[MSG_LEN_IDX] + CRC_SZ)) {
+		g_uiaCOMM_Stats[COMM_STAT_CRC_ERR]++;
+		return COMM_ERROR;
+	}
+
+	g_uiaCOMM_Stats[COMM_STAT_FRAMES_RX]++;
+
+	for (ucLoopCount = 0x00; ucLoopCount < ucLength; ucLoopCount++)
+		*pucBuff++ = g_ucaRXBuffer[ucLoopCount];
+
+	// Reset the RX index
+	g_ucRXBufferIndex = 0x00;
+
+	return COMM_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Loads the passed buffer with the link statistics
+//!
+//! The counters are written MSB first in COMM_STAT order.
+//!   \param pucBuff Pointer to the destination in the message buffer
+//!   \return The number of bytes written
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucCOMM_FetchStats(volatile uint8 * pucBuff)
+{
+	uint8 ucIdx;
+
+	for (ucIdx = 0; ucIdx < COMM_STAT_COUNT; ucIdx++) {
+		*pucBuff++ = (uint8) (g_uiaCOMM_Stats[ucIdx] >> 8);
+		*pucBuff++ = (uint8) g_uiaCOMM_Stats[ucIdx];
+	}
+
+	return COMM_STAT_COUNT * 2;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Zeroes the link statistics
+//!   \param None
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_ClearStats(void)
+{
+	uint8 ucIdx;
+
+	for (ucIdx = 0; ucIdx < COMM_STAT_COUNT; ucIdx++)
+		g_uiaCOMM_Stats[ucIdx] = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Discards the contents of the RX buffer
+//!
+//! Used after a frame was rejected so that the next frame is received from
+//! the start of the buffer.
+//!   \param None
+//!   \return None
+///////////////////////////////////////////////////////////////////////////////
+void vCOMM_ResetRX(void)
+{
+	g_ucRXBufferIndex = 0x00;
+	g_ucCOMM_Flags &= ~(COMM_PARITY_ERR | COMM_CRC_CHECKED);
+}
+
+//! @}
+//! @}
+
@@ -1,177 +1,288 @@
-///////////////////////////////////////////////////////////////////////////////
-//! \file msg.h
-//! \brief The file contains the Messages module
-//!
-//! @addtogroup core
-//! @{
-//!
-//! @addtogroup msg Messages
-//! The Messages Module (msg.h) contains all of the data structures and defines
-//! to communicate back and forth between the SP Board boards and the brain
-//! board
-//! @{
-///////////////////////////////////////////////////////////////////////////////
-//*****************************************************************************
-// By: Kenji Yamamoto
-//     Wireless Networks Research Lab
-//     Dept Of Electrical Engineering, CEFNS
-//     Northern Arizona University
-//
-//*****************************************************************************
-
-#ifndef MSG_H_
-#define MSG_H_
-//****************  SP Board Data Messages  *********************************//
-//! @defgroup msg_data SP Board Data Message
-//! The SP Board Data Message is used to sent data back and forth between the
-//! SP Board and the CP Board. The request message is ALWAYS a data message, the
-//! return message can be a data message or a label message.
-//! @{
-#define SP_DATAMESSAGE_VERSION 120     //!< Version 1.20
-// Message Types
-//! @name Data Message Types
-//! These are the possible data message types.
-//! @{
-//! \def COMMAND_PKT
-//! \brief This packet contains the command from the CP Board to the SP Board on
-//! what functions to execute.
-//!
-//! The SP Board replies with a CONFIRM_COMMAND if the command is valid
-#define COMMAND_PKT   		0x01
-
-//! \def REPORT_DATA
-//! \brief This packet reports a transducer measurement to the CP Board
-//!
-//! This packet is only sent from the SP Board board to the CP Board. The
-//! transducer measurement is contained in data1 through data 8.
-//! The SP sends a 128 (1-8) bit or 32 (1-2) bit data packet, depending on the SP function
-#define REPORT_DATA     	0x02
-
-//! \def PROGRAM_CODE
-//! \brief This packet contains program code
-//!
-//! This packet is only sent from the real-time-data-center to the target. The
-//! packet contains a portion of a programming update.
-
-#define PROGRAM_CODE     	0x03
-
-//! \def REQUEST_DATA
-//! \brief This packet requests data from the SP Board board
-//!
-//! This packet is only sent from the CP Board to the SP Board.
-//! The SP will send a REPORT_DATA packet as a reply, either 32 bit or 128 bit
-//! packet depending on the SP function.
-#define REQUEST_DATA   		0x04
-
-//! \def REQUEST_LABEL
-//! \brief This packet asks the SP Board board to send a label message back
-//!
-//! The packet is sent from the CP Board to the SP Board and the CP Board will
-//! expect a SP_LabelMessage in return. At this time the data1 and
-//! data2 fields in the message contain do-not-care values.
-#define REQUEST_LABEL   	0x05
-
-//! \def ID_PKT
-//! \brief This packet identifies the SP Board board to the CP Board
-//!
-//! This packet is only ever sent when the SP Board starts up and should
-//! never be sent by the CP Board.
-#define ID_PKT          	0x06
-
-//! \def CONFIRM_COMMAND
-//! \brief This packet is used by the SP Board to confirm that the COMMAND_PKT
-//! sent by the CP Board is valid and that the commands will be executed.
-#define CONFIRM_COMMAND   0x07
-
-//! \def REPORT_ERROR
-//! \brief This packet is used by the SP Board to report an error to the CP.
-#define REPORT_ERROR   		0x08
-
-//! \def REQUEST_BSL_PW
-//! \brief This packet is used by the CP board to request the bootstrap loader password
-//!
-//! The SP will look into flash address 0xFFE0 to 0xFFFF and send the contents to the
-//! CP board.
-#define REQUEST_BSL_PW   	0x09
-
-//! \def INTERROGATE
-//! \brief This packet is used by the CP board to request the transducer information
-#define INTERROGATE   		0x0A
-
-//! \def SET_SERIALNUM
-//! \brief Used to set the serial number on the SP board from the CP.
-#define SET_SERIALNUM			0x0B
-
-//! \def REQUEST_SENSOR_TYPE
-//! \brief This packet is used by the CP board to command the acquisition of the sensor type
-#define COMMAND_SENSOR_TYPE			0x0C
-
-//! \def REQUEST_SENSOR_TYPE
-//! \brief This packet is used by the CP board to request the sensor type
-#define REQUEST_SENSOR_TYPE			0x0D
-//! @}
-
-//! \def MAXMSGLEN
-//! \brief maximum message size between CP and SP
-#define 	MAXMSGLEN			0x40
-
-//! \def SP_HEADERSIZE
-//! \brief The size of the header portion of the SP message
-#define SP_HEADERSIZE		4
-
-//! @name Message Indices
-//! \brief Indices for elements of a message
-//! @{
-//! \def MSG_TYP_IDX
-#define MSG_TYP_IDX			0
-//! \def MSG_LEN_IDX
-#define MSG_LEN_IDX			1
-//! \def MSG_VER_IDX
-#define MSG_VER_IDX			2
-//! \def MSG_FLAGS_IDX
-#define MSG_FLAGS_IDX		3
-//! \def MSG_PAYLD_IDX
-#define MSG_PAYLD_IDX		4
-//! @}
-
-//! \def SP_CORE_VERSION
-//! \brief This sensor number is for requesting the version string
-//!
-//! This sensor number should only EVER be used with REQUEST_LABEL packet.
-//! Otherwise the system will try to access an array index that does
-//! not exist, which will fault the hardware and lock up the software.
-#define SP_CORE_VERSION 0x10
-//! \def WRAPPER_VERSION
-//! \brief This sensor number is for requesting the wrapper version string
-//!
-//! This sensor number should only EVER be used with REQEUST_LABEL packet.
-//! Otherwise the system will try to access an array index that does not
-//! exist, which will fault the hardware and lock up the software.
-#define WRAPPER_VERSION 0x11
-
-//****************  SP Board Label Message  *********************************//
-//! @defgroup msg_label SP Board Label Message
-//! The SP Board Label Message is used to send labels (byte strings) to the
-//! CP board. The label message is only ever sent in reponse to a
-//! LABEL_REQUEST Data Message. (See \ref msg_data).
-//! @{
-#define SP_LABELMESSAGE_VERSION 102        //!< v1.02
-// Message Types
-//! \name Label Message Types
-//! These are the possible Label Message types
-//! @{
-//! \def REPORT_LABEL
-//! \brief This packet contains a label indicated by the sensor number.
-//!
-//! This type of label packet is only sent by the SP Board board in response
-//! to a LABEL_REQUEST Data Message. It has a different packet length and
-//! is longer than a Data Message and therefore can be receieved as a
-//! Data Message in error.
-#define REPORT_LABEL             0x0A
-//! @}
-
-
-#endif /*MSG_H_*/
-//! @}
-//! @}
-
+///////////////////////////////////////////////////////////////////////////////
+//! \file msg.h
+//! \brief The file contains the Messages module
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup msg Messages
+//! The Messages Module (msg.h) contains all of the data structures and defines
+//! to communicate back and forth between the SP Board boards and the brain
+//! board
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+//*****************************************************************************
+// By: Kenji Yamamoto
+//     Wireless Networks Research Lab
+//     Dept Of Electrical Engineering, CEFNS
+//     Northern Arizona University
+//
+//*****************************************************************************
+
+#ifndef MSG_H_
+#define MSG_H_
+//****************  SP Board Data Messages  *********************************//
+//! @defgroup msg_data SP Board Data Message
+//! The SP Board Data Message is used to sent data back and forth between the
+//! SP Board and the CP Board. The request message is ALWAYS a data message, the
+//! return message can be a data message or a label message.
+//! @{
+#define SP_DATAMESSAGE_VERSION 120     //!< Version 1.20
+
+//! \def SP_DATAMESSAGE_VERSION_PACKED
+//! \brief Version 1.21, REPORT_DATA with packed 12-bit values
+//!
+//! A CP that sends REQUEST_DATA with this version in MSG_VER_IDX receives a
+//! REPORT_DATA of the same version.  Its payload is a presence bitmap byte
+//! (bit n set for data generator n), the 12-bit values of those generators
+//! packed MSB first two to every three bytes, and then any generators that
+//! do not hold 12-bit values in the version 1.20 [ID, length, data] form.
+#define SP_DATAMESSAGE_VERSION_PACKED 121
+
+//! \def SP_DATAMESSAGE_VERSION_TIMED
+//! \brief Version 1.22, REPORT_DATA with the time of each reading
+//!
+//! A CP that sends REQUEST_DATA with this version receives a REPORT_DATA of
+//! the same version.  Its payload starts with the time the frame was built,
+//! 4 bytes MSB first in milliseconds since the latest TIME_SYNC.  Each data
+//! generator follows as [ID, length, data, age MSB, age LSB], where the age
+//! is the number of milliseconds the reading was taken before that time,
+//! 0xFFFF if it is that old or older.
+#define SP_DATAMESSAGE_VERSION_TIMED 122
+
+//! @name Accepted Versions
+//! With COMM_LINK_HEADER_NACK negotiated, and in burst mode, the SP refuses
+//! a frame whose version byte is outside of major version 1 as soon as the
+//! byte arrives.
+//! @{
+//! \def SP_VERSION_MIN
+#define SP_VERSION_MIN		100
+//! \def SP_VERSION_MAX
+#define SP_VERSION_MAX		199
+//! @}
+// Message Types
+//! @name Data Message Types
+//! These are the possible data message types.
+//! @{
+//! \def COMMAND_PKT
+//! \brief This packet contains the command from the CP Board to the SP Board on
+//! what functions to execute.
+//!
+//! The SP Board replies with a CONFIRM_COMMAND if the command is valid
+#define COMMAND_PKT   		0x01
+
+//! \def REPORT_DATA
+//! \brief This packet reports a transducer measurement to the CP Board
+//!
+//! This packet is only sent from the SP Board board to the CP Board. The
+//! transducer measurement is contained in data1 through data 8.
+//! The SP sends a 128 (1-8) bit or 32 (1-2) bit data packet, depending on the SP function
+#define REPORT_DATA     	0x02
+
+//! \def PROGRAM_CODE
+//! \brief This packet contains program code
+//!
+//! This packet is only sent from the real-time-data-center to the target. The
+//! packet contains a portion of a programming update.
+
+#define PROGRAM_CODE     	0x03
+
+//! \def REQUEST_DATA
+//! \brief This packet requests data from the SP Board board
+//!
+//! This packet is only sent from the CP Board to the SP Board.
+//! The SP will send a REPORT_DATA packet as a reply, either 32 bit or 128 bit
+//! packet depending on the SP function.
+#define REQUEST_DATA   		0x04
+
+//! \def REQUEST_LABEL
+//! \brief This packet asks the SP Board board to send a label message back
+//!
+//! The packet is sent from the CP Board to the SP Board and the CP Board will
+//! expect a SP_LabelMessage in return. At this time the data1 and
+//! data2 fields in the message contain do-not-care values.
+#define REQUEST_LABEL   	0x05
+
+//! \def ID_PKT
+//! \brief This packet identifies the SP Board board to the CP Board
+//!
+//! This packet is only ever sent when the SP Board starts up and should
+//! never be sent by the CP Board.
+#define ID_PKT          	0x06
+
+//! \def CONFIRM_COMMAND
+//! \brief This packet is used by the SP Board to confirm that the COMMAND_PKT
+//! sent by the CP Board is valid and that the commands will be executed.
+#define CONFIRM_COMMAND   0x07
+
+//! \def REPORT_ERROR
+//! \brief This packet is used by the SP Board to report an error to the CP.
+#define REPORT_ERROR   		0x08
+
+//! \def REQUEST_BSL_PW
+//! \brief This packet is used by the CP board to request the bootstrap loader password
+//!
+//! The SP will look into flash address 0xFFE0 to 0xFFFF and send the contents to the
+//! CP board.
+#define REQUEST_BSL_PW   	0x09
+
+//! \def INTERROGATE
+//! \brief This packet is used by the CP board to request the transducer information
+#define INTERROGATE   		0x0A
+
+//! \def SET_SERIALNUM
+//! \brief Used to set the serial number on the SP board from the CP.
+#define SET_SERIALNUM			0x0B
+
+//! \def COMMAND_SENSOR_TYPE
+//! \brief This packet is used by the CP board to command the acquisition of the sensor type
+//!
+//! With a payload of one type per channel the types are stored in flash
+//! instead, and the SP answers with the types now in use or REPORT_ERROR.
+#define COMMAND_SENSOR_TYPE			0x0C
+
+//! \def REQUEST_SENSOR_TYPE
+//! \brief This packet is used by the CP board to request the sensor type
+//!
+//! The answer holds one type per channel followed by one health code per
+//! channel.
+#define REQUEST_SENSOR_TYPE			0x0D
+
+//! \def REQUEST_DIAGNOSTICS
+//! \brief This packet is used by the CP board to request the SP stack and RAM usage
+//!
+//! The SP replies with a REQUEST_DIAGNOSTICS packet carrying the report built
+//! by ucDIAG_FetchReport() followed by the link statistics from
+//! ucCOMM_FetchStats().  A request payload byte of COMM_STATS_CLEAR zeroes the
+//! statistics once they have been sent.
+#define REQUEST_DIAGNOSTICS			0x0E
+
+//! \def COMMAND_AND_REPORT
+//! \brief This packet carries a COMMAND_PKT command list and asks for the report in one transaction
+//!
+//! The SP executes the commands and replies with the REPORT_DATA (or
+//! REPORT_ERROR) that a following REQUEST_DATA would have returned, with
+//! CONFIRM_BIT set in the flags.  No CONFIRM_COMMAND is sent.  The version of
+//! the request selects the report format as for REQUEST_DATA.  The CP must
+//! allow for the sample duration of the commanded transducers before it
+//! clocks out the reply.
+#define COMMAND_AND_REPORT			0x0F
+
+//! \def XFER_READ
+//! \brief This packet is used by the CP board to read a window of segments of a transfer object
+//!
+//! The payload is [object, seq MSB, seq LSB, window].  The SP replies with
+//! up to window XFER_DATA frames back to back.  See \ref xfer.
+#define XFER_READ					0x10
+
+//! \def XFER_DATA
+//! \brief This packet carries one segment of a transfer object to the CP board
+#define XFER_DATA					0x11
+
+//! \def XFER_WRITE
+//! \brief This packet carries one segment of a transfer object to the SP board
+//!
+//! The CP sends a window of XFER_WRITE frames back to back and the SP
+//! answers the window with one XFER_ACK.  See \ref xfer.
+#define XFER_WRITE					0x12
+
+//! \def XFER_ACK
+//! \brief This packet acknowledges a window of XFER_WRITE frames
+//!
+//! The seq field holds the next segment the SP expects and the xfer flags
+//! field holds the transfer status.
+#define XFER_ACK					0x13
+
+//! \def LINK_MODE
+//! \brief This packet is used by the CP board to negotiate the link mode
+//!
+//! The payload byte holds the requested COMM_LINK bits (burst mode, ready
+//! line, interrupt driven transmit, header nack).  The SP replies with
+//! a LINK_MODE packet holding the bits it accepted, sent in the old mode.
+//! Both ends switch once the reply is through.  A CP that does not know the
+//! message never sends it, and the link stays in the standard mode.
+#define LINK_MODE					0x14
+
+//! \def CALIBRATE
+//! \brief This packet is used by the CP board to calibrate a channel of the SP
+//!
+//! The payload is handed to ucMain_Calibrate(), which defines the operations.
+//! The SP replies with a CALIBRATE packet carrying the result, or with
+//! REPORT_ERROR if the operation failed.
+#define CALIBRATE					0x15
+
+//! \def TIME_SYNC
+//! \brief This packet is used by the CP board to set the time base of the SP
+//!
+//! The SP takes the arrival of the packet as time 0 of the timed reports.
+//! It replies with a TIME_SYNC packet holding the 4 byte payload of the
+//! request, if any, and its measured ACLK rate in ticks per second, 2 bytes
+//! MSB first.  The CP sends it to every SP at once, or notes when it sent
+//! it to each, to put the readings of all of them on one clock.
+#define TIME_SYNC					0x16
+//! @}
+
+//! \def MAXMSGLEN
+//! \brief maximum message size between CP and SP
+#define 	MAXMSGLEN			0x40
+
+//! \def SP_HEADERSIZE
+//! \brief The size of the header portion of the SP message
+#define SP_HEADERSIZE		4
+
+//! @name Message Indices
+//! \brief Indices for elements of a message
+//! @{
+//! \def MSG_TYP_IDX
+#define MSG_TYP_IDX			0
+//! \def MSG_LEN_IDX
+#define MSG_LEN_IDX			1
+//! \def MSG_VER_IDX
+#define MSG_VER_IDX			2
+//! \def MSG_FLAGS_IDX
+#define MSG_FLAGS_IDX		3
+//! \def MSG_PAYLD_IDX
+#define MSG_PAYLD_IDX		4
+//! @}
+
+//! \def SP_CORE_VERSION
+//! \brief This sensor number is for requesting the version string
+//!
+//! This sensor number should only EVER be used with REQUEST_LABEL packet.
+//! Otherwise the system will try to access an array index that does
+//! not exist, which will fault the hardware and lock up the software.
+#define SP_CORE_VERSION 0x10
+//! \def WRAPPER_VERSION
+//! \brief This sensor number is for requesting the wrapper version string
+//!
+//! This sensor number should only EVER be used with REQEUST_LABEL packet.
+//! Otherwise the system will try to access an array index that does not
+//! exist, which will fault the hardware and lock up the software.
+#define WRAPPER_VERSION 0x11
+
+//****************  SP Board Label Message  *********************************//
+//! @defgroup msg_label SP Board Label Message
+//! The SP Board Label Message is used to send labels (byte strings) to the
+//! CP board. The label message is only ever sent in reponse to a
+//! LABEL_REQUEST Data Message. (See \ref msg_data).
+//! @{
+#define SP_LABELMESSAGE_VERSION 102        //!< v1.02
+// Message Types
+//! \name Label Message Types
+//! These are the possible Label Message types
+//! @{
+//! \def REPORT_LABEL
+//! \brief This packet contains a label indicated by the sensor number.
+//!
+//! This type of label packet is only sent by the SP Board board in response
+//! to a LABEL_REQUEST Data Message. It has a different packet length and
+//! is longer than a Data Message and therefore can be receieved as a
+//! Data Message in error.
+#define REPORT_LABEL             0x0A
+//! @}
+
+
+#endif /*MSG_H_*/
+//! @}
+//! @}
+
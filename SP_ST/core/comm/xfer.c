@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file xfer.c
+//! \brief This module segments objects larger than a message
+//!
+//! Reads are served from the application through ucMain_XferRead() one
+//! segment at a time.  Writes are reassembled in order and handed to
+//! ucMain_XferWrite().  The message buffer of the core is reused for every
+//! frame, so the module needs no RAM beyond the write state.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup xfer Multi-frame Transfer
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "crc.h"
+#include "xfer.h"
+
+//******************  Write State  ******************************************//
+//! @name Write State
+//! The position of the object being written.  It is kept between windows so
+//! that the CP can resume after an error.
+//! @{
+//! \var g_ucXFER_WriteObject
+//! \brief The object being written
+static uint8 g_ucXFER_WriteObject = 0;
+
+//! \var g_uiXFER_WriteSeq
+//! \brief The next segment number the SP expects
+static uint16 g_uiXFER_WriteSeq = 0;
+
+//! \var g_uiXFER_WriteOffset
+//! \brief The object offset of the next expected segment
+static uint16 g_uiXFER_WriteOffset = 0;
+
+//! \var g_ucXFER_WriteStatus
+//! \brief XFER_OK, or the error that stopped the write
+static uint8 g_ucXFER_WriteStatus = XFER_OK;
+//! @}
+
+//******************  Functions  ********************************************//
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Writes the XFER header fields of a frame
+//!
+//!   \param pucMsg Pointer to the message buffer
+//!   \param ucType The message type
+//!   \param ucObject The object number
+//!   \param uiSeq The segment number
+//!   \param ucXferFlags The xfer flags byte
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vXFER_BuildHeader(uint8 * pucMsg, uint8 ucType, uint8 ucObject, uint16 uiSeq, uint8 ucXferFlags)
+{
+	pucMsg[MSG_TYP_IDX] = ucType;
+	pucMsg[MSG_VER_IDX] = SP_DATAMESSAGE_VERSION;
+
+	if (ucMain_ShutdownAllowed() == 1)
+		pucMsg[MSG_FLAGS_IDX] = SHUTDOWN_BIT;
+	else
+		pucMsg[MSG_FLAGS_IDX] = 0;
+
+	pucMsg[XFER_OBJ_IDX] = ucObject;
+	pucMsg[XFER_SEQ_IDX] = (uint8) (uiSeq >> 8);
+	pucMsg[XFER_SEQ_IDX + 1] = (uint8) uiSeq;
+	pucMsg[XFER_FLAGS_IDX] = ucXferFlags;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sends a window of XFER_DATA frames
+//!
+//! The request names the object, the first segment and the window size.
+//! The window ends early at the last segment of the object.
+//!
+//!   \param pucMsg Pointer to the XFER_READ message, reused for the replies
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vXFER_HandleRead(uint8 * pucMsg)
+{
+	uint8 ucObject;
+	uint8 ucWindow;
+	uint8 ucLength;
+	uint8 ucXferFlags;
+	uint16 uiSeq;
+	uint16 uiOffset;
+
+	ucObject = pucMsg[XFER_OBJ_IDX];
+	uiSeq = ((uint16) pucMsg[XFER_SEQ_IDX] << 8) | pucMsg[XFER_SEQ_IDX + 1];
+	ucWindow = pucMsg[XFER_FLAGS_IDX] & XFER_WINDOW_MASK;
+
+	if (ucWindow == 0)
+		ucWindow = 1;
+
+	uiOffset = uiSeq * XFER_SEG_LEN;
+
+	do {
+		ucWindow--;
+
+		// The CP has gone away, the rest of the window is not wanted
+		if (g_ucCOMM_Flags & COMM_TIMEOUT)
+			return;
+
+		// The application fills the data field and returns the segment length
+		ucLength = ucMain_XferRead(ucObject, uiOffset, &pucMsg[XFER_DATA_IDX], XFER_SEG_LEN);
+
+		if (ucLength == XFER_NO_OBJECT) {
+			vCORE_Send_ErrorMsg(XFER_ERR_OBJECT);
+			return;
+		}
+
+		// A short segment is the end of the object, the window stops there
+		if (ucLength < XFER_SEG_LEN) {
+			ucWindow = 0;
+			ucXferFlags = XFER_FLAG_LAST;
+		}
+		else
+			ucXferFlags = ucWindow;
+
+		vXFER_BuildHeader(pucMsg, XFER_DATA, ucObject, uiSeq, ucXferFlags);
+		pucMsg[MSG_LEN_IDX] = XFER_DATA_IDX + ucLength;
+
+		vCOMM_SendMessage(pucMsg, pucMsg[MSG_LEN_IDX]);
+
+		uiSeq++;
+		uiOffset += ucLength;
+	}
+	while (ucWindow != 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Hands a received segment to the application if it is the next in order
+//!
+//!   \param pucMsg Pointer to a good XFER_WRITE message
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vXFER_StoreSegment(uint8 * pucMsg)
+{
+	uint16 uiSeq;
+	uint8 ucLength;
+
+	if (pucMsg[MSG_LEN_IDX] < XFER_DATA_IDX)
+		return;
+
+	uiSeq = ((uint16) pucMsg[XFER_SEQ_IDX] << 8) | pucMsg[XFER_SEQ_IDX + 1];
+
+	// Segment 0 starts the object over
+	if (uiSeq == 0) {
+		g_ucXFER_WriteObject = pucMsg[XFER_OBJ_IDX];
+		g_uiXFER_WriteSeq = 0;
+		g_uiXFER_WriteOffset = 0;
+		g_ucXFER_WriteStatus = XFER_OK;
+	}
+
+	// Go-back-N, anything but the expected segment is dropped
+	if (g_ucXFER_WriteStatus != XFER_OK || pucMsg[XFER_OBJ_IDX] != g_ucXFER_WriteObject || uiSeq != g_uiXFER_WriteSeq)
+		return;
+
+	ucLength = pucMsg[MSG_LEN_IDX] - XFER_DATA_IDX;
+
+	g_ucXFER_WriteStatus = ucMain_XferWrite(g_ucXFER_WriteObject, g_uiXFER_WriteOffset, &pucMsg[XFER_DATA_IDX], ucLength);
+
+	if (g_ucXFER_WriteStatus == XFER_OK) {
+		g_uiXFER_WriteSeq++;
+		g_uiXFER_WriteOffset += ucLength;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Receives a window of XFER_WRITE frames and acknowledges it
+//!
+//! The first frame of the window has already been received by the core.  The
+//! count of frames still to come is taken from each good frame.  A bad frame
+//! is counted as one frame so the SP stays in step with the CP.
+//!
+//!   \param pucMsg Pointer to the first XFER_WRITE message, reused for the rest
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vXFER_HandleWrite(uint8 * pucMsg)
+{
+	uint8 ucFramesLeft;
+
+	ucFramesLeft = pucMsg[XFER_FLAGS_IDX] & XFER_WINDOW_MASK;
+	vXFER_StoreSegment(pucMsg);
+
+	while (ucFramesLeft != 0) {
+		ucFramesLeft--;
+
+		// The CP has gone away, neither the window nor the ack can finish
+		if (g_ucCOMM_Flags & COMM_TIMEOUT)
+			return;
+
+		if (ucCOMM_WaitForMessage() == COMM_OK && ucCOMM_GrabMessageFromBuffer(pucMsg) == COMM_OK
+				&& pucMsg[MSG_TYP_IDX] == XFER_WRITE) {
+			ucFramesLeft = pucMsg[XFER_FLAGS_IDX] & XFER_WINDOW_MASK;
+			vXFER_StoreSegment(pucMsg);
+		}
+		else {
+			// Drop what was received of the bad frame
+			vCOMM_ResetRX();
+		}
+	}
+
+	// Tell the CP where to resume
+	vXFER_BuildHeader(pucMsg, XFER_ACK, g_ucXFER_WriteObject, g_uiXFER_WriteSeq, g_ucXFER_WriteStatus);
+	pucMsg[MSG_LEN_IDX] = XFER_DATA_IDX;
+
+	vCOMM_SendMessage(pucMsg, pucMsg[MSG_LEN_IDX]);
+}
+
+//! @}
+//! @}
@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file xfer.h
+//! \brief Header file for the multi-frame transfer module
+//!
+//! This file provides all of the defines and function prototypes for the
+//! \ref xfer Module.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup xfer Multi-frame Transfer
+//! The transfer module moves objects larger than MAXMSGLEN (history, tables,
+//! traces) between the CP and the application as a numbered sequence of
+//! segments.  The CP reads or writes a window of up to XFER_MAX_WINDOW
+//! segments per request.  The frames of a window are sent back to back, with
+//! no request/response turnaround between them.
+//!
+//! Every XFER frame has the same payload layout:
+//!
+//!   [object] [seq MSB] [seq LSB] [xfer flags] [up to XFER_SEG_LEN data bytes]
+//!
+//! The low nibble of the xfer flags holds the number of frames that follow in
+//! the window.  XFER_FLAG_LAST marks the final segment of the object.  The
+//! offset of a segment in its object is seq * XFER_SEG_LEN.  Every segment
+//! except the last is full, so objects are limited to 64 KB.
+//!
+//! Errors are recovered go-back-N style:
+//!   - Read: the CP checks the CRC and seq of each XFER_DATA frame.  After a
+//!     bad frame it asks again with XFER_READ from the first missing seq.
+//!   - Write: the SP stores segments in order only.  A bad or out of order
+//!     frame is dropped, and so is every frame after it in the window.  The
+//!     XFER_ACK at the end of the window carries the next seq the SP expects.
+//!     The CP resumes from there.  A write with seq 0 restarts the object.
+//!
+//! The SP checks the CRC of each frame, and builds and CRCs the next one,
+//! between frames.  The CP must leave XFER_FRAME_GAP_US between the frames of
+//! a window.
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef XFER_H_
+#define XFER_H_
+
+//! @name Transfer Frame Indices
+//! Indices of the transfer fields within an XFER message
+//! @{
+//! \def XFER_OBJ_IDX
+#define XFER_OBJ_IDX		MSG_PAYLD_IDX
+//! \def XFER_SEQ_IDX
+//! \brief MSB of the 16 bit segment number, the LSB follows
+#define XFER_SEQ_IDX		(MSG_PAYLD_IDX + 1)
+//! \def XFER_FLAGS_IDX
+#define XFER_FLAGS_IDX		(MSG_PAYLD_IDX + 3)
+//! \def XFER_DATA_IDX
+#define XFER_DATA_IDX		(MSG_PAYLD_IDX + 4)
+//! @}
+
+//! \def XFER_SEG_LEN
+//! \brief Number of object bytes carried by a full segment
+#define XFER_SEG_LEN		(MAXMSGLEN - CRC_SZ - XFER_DATA_IDX)
+
+//! @name Transfer Flags
+//! Bits of the xfer flags byte
+//! @{
+//! \def XFER_WINDOW_MASK
+//! \brief Number of frames still to come in the window (XFER_READ: window size)
+#define XFER_WINDOW_MASK	0x0F
+//! \def XFER_FLAG_LAST
+//! \brief This segment is the last of the object
+#define XFER_FLAG_LAST		0x80
+//! @}
+
+//! \def XFER_MAX_WINDOW
+//! \brief The most frames the CP may ask for with one XFER_READ
+#define XFER_MAX_WINDOW		XFER_WINDOW_MASK
+
+//! \def XFER_FRAME_GAP_US
+//! \brief Idle time the CP leaves between the frames of a window
+//!
+//! Covers the CRC of a full frame (about 80 cycles per byte at 16 MHz) plus the
+//! application callback.
+#define XFER_FRAME_GAP_US	500
+
+//! @name Transfer Status Codes
+//! Returned by the application callbacks and reported in the xfer flags byte
+//! of XFER_ACK
+//! @{
+//! \def XFER_OK
+#define XFER_OK				0x00
+//! \def XFER_ERR_OBJECT
+//! \brief The object does not exist or cannot be written
+#define XFER_ERR_OBJECT		0x01
+//! \def XFER_ERR_RANGE
+//! \brief The segment lies outside of the object
+#define XFER_ERR_RANGE		0x02
+//! \def XFER_ERR_WRITE
+//! \brief The application failed to store the segment
+#define XFER_ERR_WRITE		0x04
+//! \def XFER_NO_OBJECT
+//! \brief Returned by ucMain_XferRead() instead of a length for an unknown object
+#define XFER_NO_OBJECT		0xFF
+//! @}
+
+// xfer.c function prototypes
+//! @name Transfer Functions
+//! These functions are called by the core to serve XFER messages
+//! @{
+void vXFER_HandleRead(uint8 * pucMsg);
+void vXFER_HandleWrite(uint8 * pucMsg);
+//! @}
+
+#endif /*XFER_H_*/
+//! @}
+//! @}
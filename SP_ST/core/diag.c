@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file diag.c
+//! \brief This module measures stack and RAM usage at runtime
+//!
+//! The stack region is painted once at startup.  Reading back how much of the
+//! paint has been overwritten gives the high-water mark of the stack since
+//! the last reset.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup diag Diagnostics
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "diag.h"
+
+//! \var g_ucDIAG_ISRDepth
+//! \brief Number of interrupt service routines currently executing
+volatile uint8 g_ucDIAG_ISRDepth;
+
+//! \var g_ucDIAG_ISRMaxDepth
+//! \brief The deepest interrupt nesting seen since reset
+uint8 g_ucDIAG_ISRMaxDepth;
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the first word aligned address of the free RAM region
+//!
+//!   \param none
+//!   \return Pointer to the bottom of the painted region
+///////////////////////////////////////////////////////////////////////////////
+static uint16 * puiDIAG_RAMStart(void)
+{
+	return HAL_RAM_FREE_START;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Finds the lowest word the stack has ever written to
+//!
+//!   \param none
+//!   \return Pointer to the first word which no longer holds the paint
+///////////////////////////////////////////////////////////////////////////////
+static uint16 * puiDIAG_FirstUsedWord(void)
+{
+	uint16 *puiAddr;
+
+	puiAddr = puiDIAG_RAMStart();
+
+	// Walk up from the end of .bss until the paint is broken
+	while ((puiAddr < HAL_RAM_END) && (*puiAddr == DIAG_STACK_PAINT))
+		puiAddr++;
+
+	return puiAddr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Fills the unused RAM below the stack pointer with the paint pattern
+//!
+//! Must be called before interrupts are enabled.  Only the RAM below the
+//! current stack pointer is written so the frames of the callers survive.
+//!
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vDIAG_PaintStack(void)
+{
+	uint16 *puiAddr;
+	uint16 *puiStop;
+
+	puiAddr = puiDIAG_RAMStart();
+	puiStop = HAL_GET_SP();
+
+	while (puiAddr < puiStop)
+		*puiAddr++ = DIAG_STACK_PAINT;
+
+	g_ucDIAG_ISRDepth = 0;
+	g_ucDIAG_ISRMaxDepth = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the deepest the stack has been since reset
+//!
+//!   \param none
+//!   \return Stack high-water mark in bytes
+///////////////////////////////////////////////////////////////////////////////
+uint16 uiDIAG_GetStackHighWater(void)
+{
+	return (uint16) ((uint8 *) HAL_RAM_END - (uint8 *) puiDIAG_FirstUsedWord());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the amount of RAM the stack has never touched
+//!
+//!   \param none
+//!   \return Free RAM in bytes
+///////////////////////////////////////////////////////////////////////////////
+uint16 uiDIAG_GetFreeRAM(void)
+{
+	return (uint16) ((uint8 *) puiDIAG_FirstUsedWord() - (uint8 *) puiDIAG_RAMStart());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Loads the passed buffer with the diagnostics report
+//!
+//! The report is, MSB first:
+//!   - stack high-water mark in bytes (2)
+//!   - size of the RAM region shared by the stack and free RAM (2)
+//!   - free RAM in bytes (2)
+//!   - deepest interrupt nesting level (1)
+//!
+//!   \param pucBuff Pointer to the payload of the message buffer
+//!   \return The number of bytes written
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucDIAG_FetchReport(volatile uint8 * pucBuff)
+{
+	uint16 uiValue;
+
+	uiValue = uiDIAG_GetStackHighWater();
+	*pucBuff++ = (uint8) (uiValue >> 8);
+	*pucBuff++ = (uint8) uiValue;
+
+	uiValue = (uint16) ((uint8 *) HAL_RAM_END - (uint8 *) puiDIAG_RAMStart());
+	*pucBuff++ = (uint8) (uiValue >> 8);
+	*pucBuff++ = (uint8) uiValue;
+
+	uiValue = uiDIAG_GetFreeRAM();
+	*pucBuff++ = (uint8) (uiValue >> 8);
+	*pucBuff++ = (uint8) uiValue;
+
+	*pucBuff = g_ucDIAG_ISRMaxDepth;
+
+	return DIAG_REPORT_LEN;
+}
+
+//! @}
+//! @}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file diag.h
+//! \brief Header file for the diagnostics module
+//!
+//! This file provides all of the defines and function prototypes for the
+//! \ref diag Module.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup diag Diagnostics
+//! The diagnostics module measures how much of the 2 KB of RAM is actually
+//! used.  The free RAM between the end of .bss and the stack is painted with
+//! a known pattern at startup.  The deepest point the stack has reached is
+//! found later by looking for the first word that no longer holds the pattern.
+//!
+//! Static worst-case stack.  make stack in test/ computes it with stack.py
+//! from the call graph and the frames GCC writes with -fcallgraph-info=su,
+//! cross-built with msp430-elf-gcc.  Without that toolchain the figures
+//! below are the output of make stack-host: the same sources built for the
+//! host with gcc 12.2 -O2 and HAL_HOST.  The chain is the firmware's as the
+//! host compiler inlined it.  The frames are x86-64 frames, with 8 byte
+//! return addresses and pointers and 16 byte alignment, and include the
+//! register mock (puiHOST_Count) and the intrinsics (__bis_SR_register) of
+//! core/host.  They overstate the MSP430.  Replace them with the output of
+//! make stack once the toolchain is at hand, and again when a path changes.
+//!
+//!   main: 624 bytes
+//!     main                                48
+//!     vCORE_Run                          256
+//!     vXFER_HandleRead                    80
+//!     vCORE_Send_ErrorMsg                 80
+//!     vCOMM_SendMessage                   32
+//!     vCOMM_SendFrame.part.0              80
+//!     ucCOMM_SendFrameIRQ.part.0          32
+//!     __bis_SR_register                   16
+//!   PORT2_ISR, with 4 bytes of entry: 52 bytes
+//!     PORT2_ISR                           32
+//!     puiHOST_Count                       16
+//!   worst case: 676 bytes
+//!
+//! No interrupt sets GIE, so only one interrupt frame is ever on the stack.
+//!
+//! RAM budget of the 2 KB: .data and .bss of the host objects, without the
+//! register mock, take 1215 bytes with 4 byte ints.  Of that, 600 is the
+//! burst buffer (g_ucaBurst_Buffer), and 64 each are the RX buffer and the
+//! staged report frame.  The CCS project reserves 704 bytes for the stack
+//! (--stack_size in Debug/makefile), enough for the host worst case, and 80
+//! for the heap.  Even with the host figures that is 1999 bytes, so the
+//! linker flags any growth of .bss into the stack.  Debug/SP_ST.map is from
+//! an older build with the 80 byte reservation of the original project.
+//! The measured high-water mark from REQUEST_DIAGNOSTICS should be compared
+//! against these figures.
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef DIAG_H_
+#define DIAG_H_
+
+//! \def DIAG_STACK_PAINT
+//! \brief The pattern written to unused RAM at startup
+#define DIAG_STACK_PAINT	0xCDCD
+
+//! \def DIAG_REPORT_LEN
+//! \brief Length of the diagnostics report payload in bytes
+#define DIAG_REPORT_LEN		7
+
+//! @name ISR Nesting Macros
+//! Every interrupt handler that does real work brackets its body with these
+//! so the deepest interrupt nesting level can be reported.
+//! @{
+//! \def DIAG_ISR_ENTER
+//! \brief Called on entry to an interrupt service routine
+#define DIAG_ISR_ENTER()	{ if (++g_ucDIAG_ISRDepth > g_ucDIAG_ISRMaxDepth) g_ucDIAG_ISRMaxDepth = g_ucDIAG_ISRDepth; }
+//! \def DIAG_ISR_EXIT
+//! \brief Called on exit from an interrupt service routine
+#define DIAG_ISR_EXIT()		{ g_ucDIAG_ISRDepth--; }
+//! @}
+
+extern volatile uint8 g_ucDIAG_ISRDepth;
+extern uint8 g_ucDIAG_ISRMaxDepth;
+
+// diag.c function prototypes
+//! @name diag module Functions
+//! These functions measure stack and RAM usage
+//! @{
+void vDIAG_PaintStack(void);
+uint16 uiDIAG_GetStackHighWater(void);
+uint16 uiDIAG_GetFreeRAM(void);
+uint8 ucDIAG_FetchReport(volatile uint8 * pucBuff);
+//! @}
+
+#endif /*DIAG_H_*/
+//! @}
+//! @}
@@ -1,60 +1,96 @@
-///////////////////////////////////////////////////////////////////////////////
-//! \file flash.h
-//! \brief Header file for the flash module
-//!
-//!
-//! @addtogroup core
-//! @{
-
-#ifndef FLASH_H_
-#define FLASH_H_
-
-//! \def PROTECTFLASH
-//! \brief Value to be stored in the flash data word location to prevent erasure of flash
-#define PROTECTFLASH 	0x0000
-
-//! \def FLASHDATAWRD
-//! \brief location in memory that controls security options of flash memory
-#define FLASHDATAWRD 	0xFFDE
-
-//! \def BSLPWSTARTADDR
-//! \brief starting point in memory where the bootstrap loader password is stored
-#define BSLPWSTARTADDR	0xFFE0
-
-//! \def BSLPWDLEN
-//! \brief Length of the BSL password
-#define BSLPWDLEN			0x20
-
-//! \def INFO_SEGMENTLENGTH
-//! \brief Length of a segment in information memory
-#define INFO_SEGMENTLENGTH		64
-
-//! \def FLASH_INFO_B
-//! \brief The address of sector B of information memory
-#define FLASH_INFO_B	0x1080
-
-//! \def FLASH_INFO_C
-//! \brief The address of sector C of information memory
-#define FLASH_INFO_C	0x1040
-
-//! \def FLASH_INFO_D
-//! \brief The address of sector D of information memory
-#define FLASH_INFO_D	0x1000
-
-//! \def HID_ADDRESS
-//! \brief The address in info memory sector D
-#define HID_ADDRESS	0
-
-// flash.c function prototypes
-//! @name flash module Functions
-//! These functions handle controlling the on CPU flash memory module
-//! @{
-void vFlash_GetBSLPW(uint8 *p_ucBuff);
-void vFlash_DisIncorrect_BSLPW_Erase(void);
-void vFlash_GetHID(uint16 *uiHID);
-uint8 ucFlash_SetHID(uint16 *uiHID);
-//flash_dco_cal
-//! @}
-
-#endif /*FLASH_H_*/
-//! @}
+///////////////////////////////////////////////////////////////////////////////
+//! \file flash.h
+//! \brief Header file for the flash module
+//!
+//!
+//! @addtogroup core
+//! @{
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+//! \def PROTECTFLASH
+//! \brief Value to be stored in the flash data word location to prevent erasure of flash
+#define PROTECTFLASH 	0x0000
+
+//! \def FLASHDATAWRD
+//! \brief location in memory that controls security options of flash memory
+#define FLASHDATAWRD 	0xFFDE
+
+//! \def BSLPWSTARTADDR
+//! \brief starting point in memory where the bootstrap loader password is stored
+#define BSLPWSTARTADDR	0xFFE0
+
+//! \def BSLPWDLEN
+//! \brief Length of the BSL password
+#define BSLPWDLEN			0x20
+
+//! \def INFO_SEGMENTLENGTH
+//! \brief Length of a segment in information memory
+#define INFO_SEGMENTLENGTH		64
+
+//! \def FLASH_INFO_B
+//! \brief The address of sector B of information memory
+#define FLASH_INFO_B	0x1080
+
+//! \def FLASH_INFO_C
+//! \brief The address of sector C of information memory
+#define FLASH_INFO_C	0x1040
+
+//! \def FLASH_INFO_D
+//! \brief The address of sector D of information memory
+#define FLASH_INFO_D	0x1000
+
+//! \def HID_ADDRESS
+//! \brief The address in info memory sector D
+#define HID_ADDRESS	0
+
+//! \def SENSOR_TYPE_COUNT
+//! \brief The number of sensor types stored, one per channel
+#define SENSOR_TYPE_COUNT	4
+
+//! @name Channel Record
+//! The calibration and the sensor type of every channel are kept in one
+//! record in sector B, and a copy in sector C is written first.  A reset
+//! during an update always leaves one whole record, which the marker and the
+//! checksum tell apart.  Sector D holds only the HID, so it is never erased
+//! for a channel update.
+//!
+//! The record holds the marker, a word of CHAN_HAS bits, CAL_WORDS
+//! calibration words, TYPE_WORDS type words and the inverted sum of all the
+//! words before it.
+//! @{
+//! \def CHAN_MARKER
+//! \brief The first word of a channel record
+#define CHAN_MARKER		0xCA1C
+//! \def CAL_WORDS
+//! \brief The number of coefficient words, a gain and an offset per channel
+#define CAL_WORDS		(SENSOR_TYPE_COUNT * 2)
+//! \def TYPE_WORDS
+//! \brief The number of type words, two types to a word
+#define TYPE_WORDS		(SENSOR_TYPE_COUNT / 2)
+//! \def CHAN_HAS_CAL
+//! \brief The record holds a calibration
+#define CHAN_HAS_CAL	0x0001
+//! \def CHAN_HAS_TYPES
+//! \brief The record holds the sensor types
+#define CHAN_HAS_TYPES	0x0002
+//! @}
+
+// flash.c function prototypes
+//! @name flash module Functions
+//! These functions handle controlling the on CPU flash memory module
+//! @{
+void vFlash_GetBSLPW(uint8 *p_ucBuff);
+void vFlash_DisIncorrect_BSLPW_Erase(void);
+void vFlash_GetHID(uint16 *uiHID);
+uint8 ucFlash_SetHID(uint16 *uiHID);
+void vFlash_GetSensorTypes(uint8 *pucTypes);
+uint8 ucFlash_SetSensorTypes(uint8 *pucTypes);
+uint8 ucFlash_GetCalibration(uint16 *puiCal);
+uint8 ucFlash_SetCalibration(uint16 *puiCal);
+//flash_dco_cal
+//! @}
+
+#endif /*FLASH_H_*/
+//! @}
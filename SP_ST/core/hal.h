@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file hal.h
+//! \brief Header file for the hardware access boundary
+//!
+//! Every source file includes this header instead of the device header.  The
+//! few hardware accesses that cannot be written as plain register reads and
+//! writes go through the macros below, so the same sources also compile for
+//! the host against the mock register file in core/host.
+//!
+//! Three toolchains are supported:
+//!   - TI cl430 (the CCS project), the default.
+//!   - msp430-elf-gcc, detected by __GNUC__.  Used to run the firmware on an
+//!     instruction set simulator.  Link with the msp430f235.ld script from the
+//!     TI GCC support files, which provides the end and __stack symbols.
+//!     test/Makefile builds the cycle benchmarks this way with HAL_ISS also
+//!     defined (make bench-iss).
+//!   - The host compiler, selected with HAL_HOST.  A host build adds
+//!     core/host/msp430_host.c.  test/Makefile builds the whole firmware
+//!     this way with a device model behind the mock, and runs the unit
+//!     tests (make test) and the host benchmarks (make bench).
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup hal Hardware Access
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#if defined(HAL_HOST)
+  #include "host/msp430_host.h"
+#elif defined(__GNUC__)
+  #include <msp430.h>
+#else
+  #include <msp430x23x.h>
+#endif
+
+//! \def HAL_ISR
+//! \brief Defines the interrupt service routine \e name for vector \e vec
+//!
+//! On the host the routine is a plain function for the harness to call.
+#if defined(HAL_HOST)
+  #define HAL_ISR(vec, name)		void name(void)
+#elif defined(__GNUC__)
+  #define __interrupt				__attribute__((interrupt))
+  #define HAL_ISR(vec, name)		void __attribute__((interrupt(vec))) name(void)
+#else
+  #define HAL_PRAGMA(x)				_Pragma(#x)
+  #define HAL_ISR(vec, name)		HAL_PRAGMA(vector=vec) __interrupt void name(void)
+#endif
+
+//! \def HAL_EVEN_IN_RANGE
+//! \brief Tells cl430 that an interrupt vector register is even and bounded
+//!
+//! Lets the compiler build a jump table for the switch on the vector
+//! register.  Other compilers see the plain value.
+#if defined(HAL_HOST) || defined(__GNUC__)
+  #define HAL_EVEN_IN_RANGE(val, range)	(val)
+#else
+  #define HAL_EVEN_IN_RANGE(val, range)	__even_in_range(val, range)
+#endif
+
+//! \def HAL_WAIT_FLAG
+//! \brief Busy waits until a bit of a register is set
+//!
+//! On the host each pass runs the poll hook, which plays the part of the
+//! hardware that sets the bit.  The instruction set simulator has no CP or
+//! ADC, so with HAL_ISS the wait sets the bit itself and passes at once, the
+//! cost of an edge that was already there plus the bis (4 cycles).
+#if defined(HAL_HOST)
+  #define HAL_WAIT_FLAG(reg, bit)	while (!((reg) & (bit))) vHOST_Poll()
+#elif defined(HAL_ISS)
+  #define HAL_WAIT_FLAG(reg, bit)	do { (reg) |= (bit); } while (!((reg) & (bit)))
+#else
+  #define HAL_WAIT_FLAG(reg, bit)	while (!((reg) & (bit)))
+#endif
+
+//! \def HAL_WAIT_CLEAR
+//! \brief Busy waits until a bit of a register is cleared
+#if defined(HAL_HOST)
+  #define HAL_WAIT_CLEAR(reg, bit)	while ((reg) & (bit)) vHOST_Poll()
+#elif defined(HAL_ISS)
+  #define HAL_WAIT_CLEAR(reg, bit)	do { (reg) &= ~(bit); } while ((reg) & (bit))
+#else
+  #define HAL_WAIT_CLEAR(reg, bit)	while ((reg) & (bit))
+#endif
+
+//! \def HAL_PTR
+//! \brief Pointer to an absolute address (info flash, calibration data, vectors)
+#ifdef HAL_HOST
+  #define HAL_PTR(type, addr)		((type *) ((unsigned char *) g_uiaHOST_Memory + (unsigned int) (addr)))
+#else
+  #define HAL_PTR(type, addr)		((type *) (addr))
+#endif
+
+//! @name RAM Bounds
+//! The region shared by the stack and free RAM, as used by the \ref diag
+//! Module.  On the target it runs from the end of .bss to the top of the
+//! stack (symbols from lnk_msp430f235.cmd, the COFF ABI adds the leading
+//! underscore; GCC uses the symbols of its linker script).  On the host it
+//! is a static array.
+//! @{
+#if defined(HAL_HOST)
+  #define HAL_RAM_FREE_START		(&g_uiaHOST_Stack[0])
+  #define HAL_RAM_END				(&g_uiaHOST_Stack[HOST_STACK_WORDS])
+  #define HAL_GET_SP()				(&g_uiaHOST_Stack[HOST_STACK_WORDS])
+#elif defined(__GNUC__)
+  extern unsigned int end;
+  extern unsigned int __stack;
+  #define HAL_RAM_FREE_START		((unsigned int *) (((unsigned int) &end + 1) & ~0x0001))
+  #define HAL_RAM_END				(&__stack)
+  #define HAL_GET_SP()				((unsigned int *) __get_SP_register())
+#else
+  extern unsigned int _BSS_END;
+  extern unsigned int _STACK_END;
+  #define HAL_RAM_FREE_START		((unsigned int *) (((unsigned int) &_BSS_END + 1) & ~0x0001))
+  #define HAL_RAM_END				(&_STACK_END)
+  #define HAL_GET_SP()				((unsigned int *) __get_SP_register())
+#endif
+//! @}
+
+#endif /*HAL_H_*/
+//! @}
+//! @}
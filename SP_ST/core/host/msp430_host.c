@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file msp430_host.c
+//! \brief Storage for the mock register file used by host builds
+//!
+//! Only compiled into host builds.  The target project ignores the contents
+//! because HAL_HOST is not defined there.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup hal Hardware Access
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAL_HOST
+
+#include "hal.h"
+
+//! @name Mock Memory
+//! @{
+//! \var g_uiaHOST_Memory
+//! \brief The 64 KB address space seen through HAL_PTR
+unsigned short g_uiaHOST_Memory[0x8000];
+
+//! \var g_uiaHOST_Stack
+//! \brief The region the \ref diag Module paints and scans
+unsigned short g_uiaHOST_Stack[HOST_STACK_WORDS];
+//! @}
+
+//! \var g_pfnHOST_Poll
+//! \brief Harness hook run while the code waits on the hardware
+void (*g_pfnHOST_Poll)(void) = 0;
+
+//! \var g_ucHOST_Asleep
+//! \brief Set while the code sits in a low power mode
+volatile unsigned char g_ucHOST_Asleep;
+
+//! \var g_ucHOST_Awake
+//! \brief Set by an ISR that clears CPUOFF on exit
+volatile unsigned char g_ucHOST_Awake;
+
+volatile unsigned char P1IN, P1OUT, P1DIR, P1IFG, P1IES, P1IE, P1SEL, P1REN;
+volatile unsigned char P2IN, P2OUT, P2DIR, P2IFG, P2IES, P2IE, P2SEL, P2REN;
+volatile unsigned char P3IN, P3OUT, P3DIR, P3SEL, P3REN;
+volatile unsigned char P4IN, P4OUT, P4DIR, P4SEL, P4REN;
+volatile unsigned char P5IN, P5OUT, P5DIR, P5SEL, P5REN;
+volatile unsigned char P6IN, P6OUT, P6DIR, P6SEL, P6REN;
+
+volatile unsigned char DCOCTL, BCSCTL1, BCSCTL2, BCSCTL3;
+volatile unsigned int WDTCTL;
+volatile unsigned int FCTL1, FCTL2, FCTL3;
+
+volatile unsigned int ADC12CTL0, ADC12CTL1, ADC12IFG, ADC12IE, ADC12IV;
+volatile unsigned int ADC12MEM0, ADC12MEM1, ADC12MEM2, ADC12MEM3, ADC12MEM4, ADC12MEM5, ADC12MEM6, ADC12MEM7;
+volatile unsigned int ADC12MEM8, ADC12MEM9, ADC12MEM10, ADC12MEM11, ADC12MEM12, ADC12MEM13, ADC12MEM14, ADC12MEM15;
+volatile unsigned char ADC12MCTL0, ADC12MCTL1, ADC12MCTL2, ADC12MCTL3, ADC12MCTL4, ADC12MCTL5, ADC12MCTL6, ADC12MCTL7;
+volatile unsigned char ADC12MCTL8, ADC12MCTL9, ADC12MCTL10, ADC12MCTL11, ADC12MCTL12, ADC12MCTL13, ADC12MCTL14, ADC12MCTL15;
+
+volatile unsigned int TACTL, TAIV, TACCTL0, TACCTL1, TACCTL2, TACCR0, TACCR1, TACCR2;
+volatile unsigned int TBCTL, TBIV, TBCCTL0, TBCCTL1, TBCCTL2, TBCCR0, TBCCR1, TBCCR2;
+volatile unsigned int g_uiHOST_TAR, g_uiHOST_TBR;
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Puts the mock device in its power up state
+//!
+//! Flash reads as erased, the DCO calibration bytes are present and the
+//! flash controller is idle.
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vHOST_Reset(void)
+{
+	unsigned int uiIdx;
+
+	for (uiIdx = 0; uiIdx < 0x8000; uiIdx++)
+		g_uiaHOST_Memory[uiIdx] = 0xFFFF;
+
+	CALDCO_16MHZ = 0x8E;
+	CALBC1_16MHZ = 0x8F;
+
+	FCTL1 = 0x9600;
+	FCTL2 = 0x9642;
+	FCTL3 = 0x9600 | WAIT | LOCK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Advances the mock hardware and runs the harness hook once
+//!
+//! Flash operations complete at once, so the status bits of FCTL3 that the
+//! code writes over are restored here.
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vHOST_Poll(void)
+{
+	FCTL3 = (FCTL3 | WAIT) & ~BUSY;
+
+	if (g_pfnHOST_Poll)
+		g_pfnHOST_Poll();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Polls, then returns the register of a free running counter
+//!   \param puiReg The register
+//!   \return puiReg
+///////////////////////////////////////////////////////////////////////////////
+volatile unsigned int * puiHOST_Count(volatile unsigned int * puiReg)
+{
+	vHOST_Poll();
+
+	return puiReg;
+}
+
+//! @name Intrinsics
+//! Entering a low power mode polls until an ISR wakes the part.
+//! @{
+void __bis_SR_register(unsigned int uiBits)
+{
+	if (!(uiBits & CPUOFF))
+		return;
+
+	g_ucHOST_Asleep = 1;
+	g_ucHOST_Awake = 0;
+
+	do {
+		vHOST_Poll();
+	}
+	while (!g_ucHOST_Awake && g_pfnHOST_Poll);
+
+	g_ucHOST_Asleep = 0;
+}
+
+void __bic_SR_register_on_exit(unsigned int uiBits)
+{
+	if (uiBits & CPUOFF)
+		g_ucHOST_Awake = 1;
+}
+
+void __bic_SR_register(unsigned int uiBits) {}
+void __bis_SR_register_on_exit(unsigned int uiBits) {}
+void __delay_cycles(unsigned long ulCycles) {}
+void __no_operation(void) {}
+void __enable_interrupt(void) {}
+void __disable_interrupt(void) {}
+//! @}
+
+#endif /* HAL_HOST */
+//! @}
+//! @}
@@ -0,0 +1,321 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file msp430_host.h
+//! \brief Mock MSP430F235 register file for host builds
+//!
+//! Stands in for msp430x23x.h when HAL_HOST is defined.  Peripheral
+//! registers are plain variables, the flash and info memory are a 64 KB
+//! array, and the intrinsics do nothing.  A test harness simulates the
+//! hardware from the poll hook, which runs inside every HAL_WAIT_FLAG loop,
+//! on every read of a free running timer and while the part sleeps.  To
+//! deliver an interrupt, the hook sets the flag registers and calls the ISR
+//! directly.
+//!
+//! A low power mode is left once an ISR clears CPUOFF on exit.  Without a
+//! hook installed it is left after one poll, as nothing else could wake it.
+//!
+//! Only the registers and bits used by the SP-ST sources are provided.  Bit
+//! values match the TI device header.
+//!
+//! @addtogroup core
+//! @{
+//!
+//! @addtogroup hal Hardware Access
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef MSP430_HOST_H_
+#define MSP430_HOST_H_
+
+//! @name Compiler Keywords
+//! @{
+#define __interrupt
+//! @}
+
+//! @name Mock Memory
+//! @{
+//! \def HOST_STACK_WORDS
+//! \brief Size of the simulated stack/free RAM region (2 KB part)
+#define HOST_STACK_WORDS	0x0300
+
+extern unsigned short g_uiaHOST_Memory[0x8000];
+extern unsigned short g_uiaHOST_Stack[HOST_STACK_WORDS];
+//! @}
+
+//! @name Host Hooks
+//! @{
+extern void (*g_pfnHOST_Poll)(void);
+extern volatile unsigned char g_ucHOST_Asleep;
+extern volatile unsigned char g_ucHOST_Awake;
+void vHOST_Reset(void);
+void vHOST_Poll(void);
+volatile unsigned int * puiHOST_Count(volatile unsigned int * puiReg);
+//! @}
+
+//! @name Intrinsics
+//! @{
+void __bis_SR_register(unsigned int uiBits);
+void __bic_SR_register(unsigned int uiBits);
+void __bis_SR_register_on_exit(unsigned int uiBits);
+void __bic_SR_register_on_exit(unsigned int uiBits);
+void __delay_cycles(unsigned long ulCycles);
+void __no_operation(void);
+void __enable_interrupt(void);
+void __disable_interrupt(void);
+//! @}
+
+//! @name Status Register Bits
+//! @{
+#define GIE				0x0008
+#define CPUOFF			0x0010
+#define OSCOFF			0x0020
+#define SCG0			0x0040
+#define SCG1			0x0080
+
+#define LPM0_bits		(CPUOFF)
+#define LPM1_bits		(SCG0 + CPUOFF)
+#define LPM2_bits		(SCG1 + CPUOFF)
+#define LPM3_bits		(SCG1 + SCG0 + CPUOFF)
+#define LPM4_bits		(SCG1 + SCG0 + OSCOFF + CPUOFF)
+
+#define LPM0			__bis_SR_register(LPM0_bits + GIE)
+#define LPM1			__bis_SR_register(LPM1_bits + GIE)
+#define LPM2			__bis_SR_register(LPM2_bits + GIE)
+#define LPM3			__bis_SR_register(LPM3_bits + GIE)
+#define LPM4			__bis_SR_register(LPM4_bits + GIE)
+//! @}
+
+#define BIT0			0x01
+#define BIT1			0x02
+#define BIT2			0x04
+#define BIT3			0x08
+#define BIT4			0x10
+#define BIT5			0x20
+#define BIT6			0x40
+#define BIT7			0x80
+
+//! @name Port Registers
+//! @{
+extern volatile unsigned char P1IN, P1OUT, P1DIR, P1IFG, P1IES, P1IE, P1SEL, P1REN;
+extern volatile unsigned char P2IN, P2OUT, P2DIR, P2IFG, P2IES, P2IE, P2SEL, P2REN;
+extern volatile unsigned char P3IN, P3OUT, P3DIR, P3SEL, P3REN;
+extern volatile unsigned char P4IN, P4OUT, P4DIR, P4SEL, P4REN;
+extern volatile unsigned char P5IN, P5OUT, P5DIR, P5SEL, P5REN;
+extern volatile unsigned char P6IN, P6OUT, P6DIR, P6SEL, P6REN;
+//! @}
+
+//! @name Clock System
+//! @{
+extern volatile unsigned char DCOCTL, BCSCTL1, BCSCTL2, BCSCTL3;
+
+#define CALDCO_16MHZ	(*HAL_PTR(volatile unsigned char, 0x10F8))
+#define CALBC1_16MHZ	(*HAL_PTR(volatile unsigned char, 0x10F9))
+
+#define XT2OFF			0x80
+#define XTS				0x40
+#define DIVA_0			0x00
+#define DIVA_1			0x10
+#define DIVA_2			0x20
+#define DIVA_3			0x30
+#define SELM_0			0x00
+#define DIVM_0			0x00
+#define DIVS_0			0x00
+#define DIVS_1			0x02
+#define DIVS_2			0x04
+#define DIVS_3			0x06
+#define LFXT1S_2		0x20
+//! @}
+
+//! @name Watchdog
+//! @{
+extern volatile unsigned int WDTCTL;
+
+#define WDTPW			0x5A00
+#define WDTHOLD			0x0080
+#define WDTTMSEL		0x0010
+#define WDTCNTCL		0x0008
+#define WDTSSEL			0x0004
+#define WDTIS1			0x0002
+#define WDTIS0			0x0001
+//! @}
+
+//! @name Flash Controller
+//! @{
+extern volatile unsigned int FCTL1, FCTL2, FCTL3;
+
+#define FWKEY			0xA500
+#define ERASE			0x0002
+#define MERAS			0x0004
+#define WRT				0x0040
+#define BLKWRT			0x0080
+#define FSSEL0			0x0040
+#define FSSEL1			0x0080
+#define FN0				0x0001
+#define FN1				0x0002
+#define FN2				0x0004
+#define FN3				0x0008
+#define BUSY			0x0001
+#define KEYV			0x0002
+#define ACCVIFG			0x0004
+#define WAIT			0x0008
+#define LOCK			0x0010
+#define FAIL			0x0080
+//! @}
+
+//! @name ADC12
+//! @{
+extern volatile unsigned int ADC12CTL0, ADC12CTL1, ADC12IFG, ADC12IE, ADC12IV;
+extern volatile unsigned int ADC12MEM0, ADC12MEM1, ADC12MEM2, ADC12MEM3, ADC12MEM4, ADC12MEM5, ADC12MEM6, ADC12MEM7;
+extern volatile unsigned int ADC12MEM8, ADC12MEM9, ADC12MEM10, ADC12MEM11, ADC12MEM12, ADC12MEM13, ADC12MEM14, ADC12MEM15;
+extern volatile unsigned char ADC12MCTL0, ADC12MCTL1, ADC12MCTL2, ADC12MCTL3, ADC12MCTL4, ADC12MCTL5, ADC12MCTL6, ADC12MCTL7;
+extern volatile unsigned char ADC12MCTL8, ADC12MCTL9, ADC12MCTL10, ADC12MCTL11, ADC12MCTL12, ADC12MCTL13, ADC12MCTL14, ADC12MCTL15;
+
+#define ADC12SC			0x0001
+#define ENC				0x0002
+#define ADC12TOVIE		0x0004
+#define ADC12OVIE		0x0008
+#define ADC12ON			0x0010
+#define REFON			0x0020
+#define REF2_5V			0x0040
+#define MSC				0x0080
+#define SHT10			0x1000
+#define SHT11			0x2000
+#define SHT12			0x4000
+#define SHT13			0x8000
+#define SHT0_2			0x0200
+#define SHT0_7			0x0700
+#define SHT0_8			0x0800
+#define SHT0_9			0x0900
+#define SHT0_15			0x0F00
+#define SHT1_15			0xF000
+
+#define ADC12BUSY		0x0001
+#define CONSEQ0			0x0002
+#define CONSEQ1			0x0004
+#define ADC12SSEL0		0x0008
+#define ADC12SSEL1		0x0010
+#define ADC12DIV0		0x0020
+#define ADC12DIV1		0x0040
+#define ADC12DIV2		0x0080
+#define ISSH			0x0100
+#define SHP				0x0200
+#define SHS0			0x0400
+#define SHS1			0x0800
+#define CSTARTADD0		0x1000
+#define CSTARTADD1		0x2000
+#define CSTARTADD2		0x4000
+#define CSTARTADD3		0x8000
+#define CONSEQ_0		0x0000
+#define CONSEQ_1		0x0002
+#define CONSEQ_2		0x0004
+#define CONSEQ_3		0x0006
+#define ADC12SSEL_3		0x0018
+#define ADC12DIV_7		0x00E0
+#define SHS_0			0x0000
+#define SHS_1			0x0400
+#define SHS_2			0x0800
+#define SHS_3			0x0C00
+#define CSTARTADD_0		0x0000
+
+#define INCH0			0x01
+#define INCH1			0x02
+#define INCH2			0x04
+#define INCH3			0x08
+#define SREF0			0x10
+#define SREF1			0x20
+#define SREF2			0x40
+#define EOS				0x80
+#define INCH_0			0
+#define INCH_1			1
+#define INCH_2			2
+#define INCH_3			3
+#define INCH_4			4
+#define INCH_5			5
+#define INCH_6			6
+#define INCH_7			7
+#define INCH_8			8
+#define INCH_9			9
+#define INCH_10			10
+#define INCH_11			11
+#define SREF_0			0x00
+#define SREF_1			0x10
+#define SREF_2			0x20
+#define SREF_7			0x70
+
+#define ADC12IV_NONE		0
+#define ADC12IV_ADC12OVIFG	2
+#define ADC12IV_ADC12TOVIFG	4
+#define ADC12IV_ADC12IFG0		6
+#define ADC12IV_ADC12IFG1		8
+#define ADC12IV_ADC12IFG2		10
+#define ADC12IV_ADC12IFG3		12
+#define ADC12IV_ADC12IFG4		14
+#define ADC12IV_ADC12IFG5		16
+#define ADC12IV_ADC12IFG6		18
+#define ADC12IV_ADC12IFG7		20
+#define ADC12IV_ADC12IFG8		22
+#define ADC12IV_ADC12IFG9		24
+#define ADC12IV_ADC12IFG10	26
+#define ADC12IV_ADC12IFG11	28
+#define ADC12IV_ADC12IFG12	30
+#define ADC12IV_ADC12IFG13	32
+#define ADC12IV_ADC12IFG14	34
+#define ADC12IV_ADC12IFG15	36
+//! @}
+
+//! @name Timer_A and Timer_B
+//! @{
+extern volatile unsigned int TACTL, TAIV, TACCTL0, TACCTL1, TACCTL2, TACCR0, TACCR1, TACCR2;
+extern volatile unsigned int TBCTL, TBIV, TBCCTL0, TBCCTL1, TBCCTL2, TBCCR0, TBCCR1, TBCCR2;
+
+//! The counters run on between two reads, so each access polls first.  The
+//! harness keeps the count in the g_uiHOST variables.
+extern volatile unsigned int g_uiHOST_TAR, g_uiHOST_TBR;
+#define TAR				(*puiHOST_Count(&g_uiHOST_TAR))
+#define TBR				(*puiHOST_Count(&g_uiHOST_TBR))
+
+#define TAIFG			0x0001
+#define TAIE			0x0002
+#define TACLR			0x0004
+#define TBIFG			0x0001
+#define TBIE			0x0002
+#define TBCLR			0x0004
+#define MC_0			0x0000
+#define MC_1			0x0010
+#define MC_2			0x0020
+#define ID_0			0x0000
+#define ID_1			0x0040
+#define ID_2			0x0080
+#define ID_3			0x00C0
+#define TASSEL_1		0x0100
+#define TASSEL_2		0x0200
+#define TBSSEL_1		0x0100
+#define TBSSEL_2		0x0200
+
+#define CCIFG			0x0001
+#define COV				0x0002
+#define OUT				0x0004
+#define CCI				0x0008
+#define CCIE			0x0010
+#define OUTMOD_3		0x0060
+#define OUTMOD_7		0x00E0
+#define CAP				0x0100
+#define SCS				0x0800
+#define CCIS_1			0x1000
+#define CM_1			0x4000
+#define CM_2			0x8000
+#define CM_3			0xC000
+
+#define TA0IV			TAIV
+#define TB0IV			TBIV
+#define TA0IV_NONE		0
+#define TAIV_TACCR1		2
+#define TAIV_TACCR2		4
+#define TAIV_TAIFG		10
+#define TBIV_TBCCR1		2
+#define TBIV_TBCCR2		4
+#define TBIV_TBIFG		14
+//! @}
+
+#endif /*MSP430_HOST_H_*/
+//! @}
+//! @}
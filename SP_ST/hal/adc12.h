@@ -1,19 +1,19 @@
-/*
- * adc12.h
- *
- *  Created on: Jun 26, 2013
- *      Author: cp397
- */
-
-#ifndef ADC12_H_
-#define ADC12_H_
-
-
-//! @name ADC functions
-//! These functions are for controlling the ADC
-//! @{
-void vADC12_Init(void);
-void vADC12_Shutdown(void);
-//! @}
-
-#endif /* ADC12_H_ */
+/*
+ * adc12.h
+ *
+ *  Created on: Jun 26, 2013
+ *      Author: cp397
+ */
+
+#ifndef ADC12_H_
+#define ADC12_H_
+
+
+//! @name ADC functions
+//! These functions are for controlling the ADC
+//! @{
+void vADC12_Init(void);
+void vADC12_Shutdown(void);
+//! @}
+
+#endif /* ADC12_H_ */
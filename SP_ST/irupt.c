@@ -1,76 +1,108 @@
-/*
- * irupt.c
- *
- *  Created on: Jun 26, 2013
- *      Author: Christopher Porter
- */
-
-#include <msp430x23x.h>
-#include "core.h"
-#include "comm.h"
-
-// Timer B is used as a low-power delay module
-#pragma vector=TIMERB1_VECTOR
-__interrupt void TIMERB1_ISR(void)
-{
-	switch (TB0IV)
-	{
-	case TA0IV_NONE:
-		break;
-	case TBIV_TBCCR1:  // used for the low power mode delay in thermo.c
-		__bic_SR_register_on_exit(LPM4_bits);
-		break;
-	case TBIV_TBCCR2:
-		break;
-	}
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!   \brief Port 1 interrupt service routine
-//!
-//! Used for both transducer debugging and bit-banging
-//!
-//!   \param none
-//!   \return none
-///////////////////////////////////////////////////////////////////////////////
-#pragma vector=PORT1_VECTOR
-__interrupt void PORT1_ISR(void)
-{
-	if (P1IFG & SDA_PIN) {
-		P_SDA_IFG &= ~SDA_PIN;
-		__bic_SR_register_on_exit(LPM4_bits);
-	}
-
-}
-
-//Unused interrupts require a function at the vector to avoid the PC pointing to empty memory space
-#pragma vector=COMPARATORA_VECTOR
-__interrupt void COMPARATORA_ISR(void)
-{}
-
-#pragma vector=NMI_VECTOR
-__interrupt void NMI_ISR(void)
-{}
-
-#pragma vector=TIMERA1_VECTOR
-__interrupt void TIMERA1_ISR(void)
-{}
-
-#pragma vector=TIMERB0_VECTOR
-__interrupt void TIMERB0_ISR(void)
-{}
-
-#pragma vector=USCIAB0RX_VECTOR
-__interrupt void USCIAB0RX_ISR(void)
-{}
-
-#pragma vector=USCIAB0TX_VECTOR
-__interrupt void USCIAB0TX_ISR(void)
-{}
-
-#pragma vector=WDT_VECTOR
-__interrupt void WDT_ISR(void)
-{}
-
-
-
+/*
+ * irupt.c
+ *
+ *  Created on: Jun 26, 2013
+ *      Author: Christopher Porter
+ */
+
+#include "hal.h"
+#include "core.h"
+#include "comm.h"
+
+// Timer B is used as a low-power delay module
+HAL_ISR(TIMERB1_VECTOR, TIMERB1_ISR)
+{
+	DIAG_ISR_ENTER();
+
+	switch (TB0IV)
+	{
+	case TA0IV_NONE:
+		break;
+	case TBIV_TBCCR1:  // used for the low power mode delay in thermo.c
+		__bic_SR_register_on_exit(LPM4_bits);
+		break;
+	case TBIV_TBCCR2:
+		break;
+	}
+
+	DIAG_ISR_EXIT();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!   \brief Port 1 interrupt service routine
+//!
+//! Used for both transducer debugging and bit-banging
+//!
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+HAL_ISR(PORT1_VECTOR, PORT1_ISR)
+{
+	DIAG_ISR_ENTER();
+
+	if (P1IFG & SDA_PIN) {
+		P_SDA_IFG &= ~SDA_PIN;
+
+		// The edge is only enabled while waiting for a start condition.  A
+		// glitch is weeded out by the timeout on the SCL edge that follows.
+		g_ucCOMM_Flags |= COMM_START_CONDITION;
+
+		__bic_SR_register_on_exit(LPM4_bits);
+	}
+
+	DIAG_ISR_EXIT();
+
+}
+
+//Unused interrupts require a function at the vector to avoid the PC pointing to empty memory space
+HAL_ISR(COMPARATORA_VECTOR, COMPARATORA_ISR)
+{}
+
+HAL_ISR(NMI_VECTOR, NMI_ISR)
+{}
+
+///////////////////////////////////////////////////////////////////////////////
+//!   \brief Timer A1 interrupt service routine
+//!
+//! TACCR1 is the bus timeout.  Once it expires the SCL edge flag is set on
+//! every ACLK tick so the bit loops of the comm module run out on their own.
+//! The overflow of TAR counts the high half of the \ref clock timebase.
+//!
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+HAL_ISR(TIMERA1_VECTOR, TIMERA1_ISR)
+{
+	DIAG_ISR_ENTER();
+
+	switch (HAL_EVEN_IN_RANGE(TAIV, 10))
+	{
+	case TAIV_TACCR1:
+		g_ucCOMM_Flags |= COMM_TIMEOUT;
+		P_SCL_IFG |= SCL_PIN;
+		TACCR1 += 1;
+		break;
+	case TAIV_TAIFG:
+		g_uiCLOCK_Overflows++;
+		break;
+	default:
+		break;
+	}
+
+	DIAG_ISR_EXIT();
+}
+
+HAL_ISR(TIMERB0_VECTOR, TIMERB0_ISR)
+{}
+
+HAL_ISR(USCIAB0RX_VECTOR, USCIAB0RX_ISR)
+{}
+
+HAL_ISR(USCIAB0TX_VECTOR, USCIAB0TX_ISR)
+{}
+
+HAL_ISR(WDT_VECTOR, WDT_ISR)
+{}
+
+
+
@@ -86,7 +86,7 @@ MEMORY
 
 SECTIONS
 {
-    .bss        : {} > RAM                  /* Global & static vars              */
+    .bss        : {} > RAM, RUN_END(__BSS_END) /* Global & static vars, end used by diag.c */
     .data       : {} > RAM                  /* Global & static vars              */
     .TI.noinit  : {} > RAM                  /* For #pragma noinit                */
     .sysmem     : {} > RAM                  /* Dynamic memory allocation area    */
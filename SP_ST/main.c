@@ -1,665 +1,1266 @@
-//*****************************************************************************
-// main.c
-//
-// By: Christopher Porter
-//     Wireless Networks Research Lab
-//     Dept of Electrical Engineering, CEFNS
-//     Northern Arizona University
-//
-// SP-ST Main
-//*****************************************************************************
-
-#include <msp430x23x.h>
-#include "core.h"
-//#include "hal/adc12.h"
-#include "Thermo.h"
-
-//! @name Transducer Labels
-//! The labels for each transducer are set in constants here.
-//! Each constant must be 16 characters long.
-//! @{
-#define TRANSDUCER_0_LABEL_TXT "Test Function   " //00
-#define TRANSDUCER_1_LABEL_TXT "ST1             " //01
-#define TRANSDUCER_2_LABEL_TXT "ST2             " //02
-#define TRANSDUCER_3_LABEL_TXT "ST3             " //03
-#define TRANSDUCER_4_LABEL_TXT "ST4             " //04
-//!@}
-
-//! \def TRANSDUCER_0
-//! \brief Transducer 0 index definition
-#define TRANSDUCER_0   		0x00
-//! \def TRANSDUCER_1
-//! \brief Transducer 1 index definition
-#define TRANSDUCER_1      0x01
-//! \def TRANSDUCER_2
-//! \brief Transducer 2 index definition
-#define TRANSDUCER_2      0x02
-//! \def TRANSDUCER_3
-//! \brief Transducer 3 index definition
-#define TRANSDUCER_3      0x03
-//! \def TRANSDUCER_4
-//! \brief Transducer 4 index definition
-#define TRANSDUCER_4      0x04
-
-//! @name SP Board configuration data
-//!
-//! This information allows the CP board to learn about the sensors attached to the SP board
-//! and figure out how to schedule tasks dynamically
-//! @{
-//! \def NUM_TRANSDUCERS
-//! \brief The number of transducers the SP board can have attached
-#define NUM_TRANSDUCERS	4
-//! \def TYPE_IS_SENSOR
-//! \brief The transducer type definition for a sensor
-#define TYPE_IS_SENSOR			0x53 //ascii S
-//! \def TYPE_IS_ACTUATOR
-//! \brief The transducer type definition for an actuator
-#define TYPE_IS_ACTUATOR	0x41 //ascii A
-//!@}
-
-//! @name SP Board data structure
-//! @{
-//! \def NUMDATGEN
-//! \brief The number of data generating elements on this board
-//! 1 per channel, 1 for zero, 1 for thermistor, and one for the diagnostics
-#define NUMDATGEN		0x07
-
-//! \def MAXDATALEN
-//! \brief This is the maximum length of a sensor reading for this board in bytes
-#define MAXDATALEN	0x02
-
-//! \def F_NEWDATA
-//! \brief Flag indicating that new data is loaded into the S_Report structure
-#define F_NEWDATA		0x01
-
-//! \struct S_Report
-//! \brief Customizable struct provides a generalized interface between data generators and the core
-struct{
-		uint8 m_ucaData[MAXDATALEN];	//!< Holds information from a data generator
-		uint8 m_ucLength;							//!< Length of the data in the m_ucaData array (in bytes)
-		uint8 m_ucFlags;							//!< Flags
-}S_Report[NUMDATGEN];
-//! @}
-
-//! \var gui_ZeroReading
-//! \brief global which stores the offset value
-unsigned int gui_ZeroReading=0;
-
-//! \var gui_ThermistorReading
-//! \brief global which stores the thermistor value
-unsigned int gui_ThermistorReading=0;
-
-//! \var gui_ADC_Initialized
-//! \brief Indicates if the ADC has been initialized
-unsigned char guc_ADCInitialized = 0;
-
-//! \var g_iVLOCal
-//! \brief Calibration constant for the VLO.
-//!This constant is the number of ticks required calibrate the VLO based on the typical frequency of 12000
-signed int g_iVLOCal;
-
-//! \var g_ucEventTrigger
-//! \brief Flag indicating that an application specific event has occured and requires handling
-unsigned char g_ucEventTrigger;
-
-///////////////////////////////////////////////////////////////////////////////
-//! \fn vMain_CalibrateVLO
-//! \brief Generates a calibration constant for the VLO
-//!
-//! The SP-CM-STM board uses the VLO to time the duration the valve is on while
-//! allowing the board to remain in LPM3
-//!
-//! The VLO frequency should be 12 kHz, but it can range from 4 kHZ to 20 kHz.
-//! Therefore, we must determine a calibration constant before it can be used.
-//! Two timers, timer A sourced from the SMCLK and timer B from the VLO (through ACLK)
-//! run for 8.333 mS.  TBR should equal 100 ticks assuming the frequency of
-//! the VLO is 12 kHz.  The deviation from 100 is measured and scaled up to the deviation
-//! in ticks the VLO is from a full second of 12000 ticks.
-//!
-///////////////////////////////////////////////////////////////////////////////
-void vMain_CalibrateVLO(void){
-
-	// Set ACLK divider to 1
-	BCSCTL1 &= ~DIVA_3;
-
-	// Determine VLO calibration constant to improve accuracy
-	TACTL = (TASSEL_2 | TACLR | ID_2);
-	TACCR0 = 8333;
-	TBCTL = (TBSSEL_1 | TBCLR );
-	TACTL |= MC_1;
-	TBCTL |= MC_2;
-	while((TACCTL0 & CCIFG) == 0);
-
-	// Set the global cal constant
-	g_iVLOCal = (signed int)(TBR - 100)*120;
-
-	TACTL = TACLR;
-	TBCTL = TBCLR;
-	TACCR0 = 0;
-
-	// Set ACLK divider back to 4
-	BCSCTL1 |= DIVA_2;
-
-}
-
-///////////////////////////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Used as a test function
-//!
-//! gets passed the data to pack data in for the core. Returns a uint16 which is a data message
-//!
-//!   \param pointer to an array where command parameters are (if needed)
-//!
-///////////////////////////////////////////////////////////////////////////////////////////////////
-uint16 uiMain_Test(uint8 *ucParam)
-{
-	S_Report[0].m_ucaData[0] = 0xBE;
-	S_Report[0].m_ucaData[1] = 0xEF;
-	S_Report[0].m_ucLength = 2;
-	S_Report[0].m_ucFlags = F_NEWDATA;
-
-	return 0;
-} 
-
-
-//////////////////////////////////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Used to read CH0
-//!
-//! gets passed the dataarray to pack data in for the core. Returns a unit16 which is a data message
-//!
-//! \param dataarray	Core variables to send back the data in
-//!
-//!
-/////////////////////////////////////////////////////////////////////////////////////////////////////////
-uint16 uiMain_CH1(uint8 *ucParam)
-{
-	uint16 uiCHReading;
-
-	// Make sure the ADC is initialized
-	if (guc_ADCInitialized == 0)
-	{
-		vADCInit();
-		guc_ADCInitialized = 1; //indicate the ADC is initialized
-	}
-
-	// Zero and thermistor reading is required for all channels (besides test )
-	if (gui_ThermistorReading == 0 && gui_ZeroReading == 0)
-	{
-		vZeroReading();
-		vThermistorReading();
-
-		S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
-		S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
-		S_Report[1].m_ucLength = 2;
-		S_Report[1].m_ucFlags = F_NEWDATA;
-
-		S_Report[2].m_ucaData[0] = (uint8) (gui_ThermistorReading >> 8);
-		S_Report[2].m_ucaData[1] = (uint8) gui_ThermistorReading;
-		S_Report[2].m_ucLength = 2;
-		S_Report[2].m_ucFlags = F_NEWDATA;
-	}
-
-	uiCHReading = uiThermo_ReadChannel(1);
-
-	S_Report[3].m_ucaData[0] = (uint8) (uiCHReading>>8);
-	S_Report[3].m_ucaData[1] = (uint8) uiCHReading;
-	S_Report[3].m_ucLength = 2;
-	S_Report[3].m_ucFlags = F_NEWDATA;
-
-	return 0;
-}
-
-
-///////////////////////////////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Used to read CH1
-//!
-//! gets passed the dataarray to pack data in for the core. Returns a unit16 which is a data message
-//!
-//! \param dataarray	Core variables to send back the data in
-//!
-//!
-///////////////////////////////////////////////////////////////////////////////////////////////////////
-uint16 uiMain_CH2(uint8 *ucParam)
-{
-	uint16 uiCHReading;
-
-	// Make sure the ADC is initialized
-	if (guc_ADCInitialized == 0)
-	{
-		vADCInit();
-		guc_ADCInitialized = 1; //indicate the ADC is initialized
-	}
-
-	// Zero and thermistor reading is required for all channels (besides test )
-	if (gui_ThermistorReading == 0 && gui_ZeroReading == 0)
-	{
-		vZeroReading();
-		vThermistorReading();
-
-		S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
-		S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
-		S_Report[1].m_ucLength = 2;
-		S_Report[1].m_ucFlags = F_NEWDATA;
-
-		S_Report[2].m_ucaData[0] = (uint8) (gui_ThermistorReading >> 8);
-		S_Report[2].m_ucaData[1] = (uint8) gui_ThermistorReading;
-		S_Report[2].m_ucLength = 2;
-		S_Report[2].m_ucFlags = F_NEWDATA;
-	}
-
-	uiCHReading = uiThermo_ReadChannel(2);
-
-	S_Report[4].m_ucaData[0] = (uint8) ( uiCHReading>>8);
-	S_Report[4].m_ucaData[1] = (uint8)  uiCHReading;
-	S_Report[4].m_ucLength = 2;
-	S_Report[4].m_ucFlags = F_NEWDATA;
-
-	return 0;
-}
-
-
-
-///////////////////////////////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Used to read CH2
-//!
-//! gets passed the dataarray to pack data in for the core. Returns a unit16 which is a data message
-//!
-//! \param dataarray	Core variables to send back the data in
-//!
-//!
-////////////////////////////////////////////////////////////////////////////////////////////////////////
-uint16 uiMain_CH3(uint8 *ucParam)
-{
-	uint16 uiCHReading;
-
-	// Make sure the ADC is initialized
-	if (guc_ADCInitialized == 0)
-	{
-		vADCInit();
-		guc_ADCInitialized = 1; //indicate the ADC is initialized
-	}
-
-	// Zero and thermistor reading is required for all channels (besides test )
-	if (gui_ThermistorReading == 0 && gui_ZeroReading == 0)
-	{
-		vZeroReading();
-		vThermistorReading();
-
-		S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
-		S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
-		S_Report[1].m_ucLength = 2;
-		S_Report[1].m_ucFlags = F_NEWDATA;
-
-		S_Report[2].m_ucaData[0] = (uint8) (gui_ThermistorReading >> 8);
-		S_Report[2].m_ucaData[1] = (uint8) gui_ThermistorReading;
-		S_Report[2].m_ucLength = 2;
-		S_Report[2].m_ucFlags = F_NEWDATA;
-	}
-
-	uiCHReading = uiThermo_ReadChannel(3);
-
-	S_Report[5].m_ucaData[0] = (uint8) ( uiCHReading>>8);
-	S_Report[5].m_ucaData[1] = (uint8)  uiCHReading;
-	S_Report[5].m_ucLength = 2;
-	S_Report[5].m_ucFlags = F_NEWDATA;
-
-	return 0;
-}
-
-
-//////////////////////////////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Used to read CH4
-//!
-//! gets passed the dataarray to pack data in for the core. Returns a unit16 which is a data message
-//!
-//! \param dataarray	Core variables to send back the data in
-//!
-//!
-//////////////////////////////////////////////////////////////////////////////////////////////////////
-uint16 uiMain_CH4(uint8 *ucParam)
-{
-	uint16 uiCHReading;
-
-	// Make sure the ADC is initialized
-	if (guc_ADCInitialized == 0)
-	{
-		vADCInit();
-		guc_ADCInitialized = 1; //indicate the ADC is initialized
-	}
-
-	// Zero and thermistor reading is required for all channels (besides test )
-	if (gui_ThermistorReading == 0 && gui_ZeroReading == 0)
-	{
-		vZeroReading();
-		vThermistorReading();
-
-		S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
-		S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
-		S_Report[1].m_ucLength = 2;
-		S_Report[1].m_ucFlags = F_NEWDATA;
-
-		S_Report[2].m_ucaData[0] = (uint8) (gui_ThermistorReading >> 8);
-		S_Report[2].m_ucaData[1] = (uint8) gui_ThermistorReading;
-		S_Report[2].m_ucLength = 2;
-		S_Report[2].m_ucFlags = F_NEWDATA;
-	}
-
-	//Read the channel
-	uiCHReading = uiThermo_ReadChannel(4);
-
-	S_Report[6].m_ucaData[0] = (uint8) ( uiCHReading>>8);
-	S_Report[6].m_ucaData[1] = (uint8)  uiCHReading;
-	S_Report[6].m_ucLength = 2;
-	S_Report[6].m_ucFlags = F_NEWDATA;
-
-	return 0;
-}
-
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Initializes the data storage structure
-//!
-//! \param none
-//! \return none
-///////////////////////////////////////////////////////////////////////////////
-void vMain_CleanDataStruct(void)
-{
-	uint8 ucDataGenCnt;
-	uint8 ucByteCnt;
-
-	// Clean out the data storage structure
-	for (ucDataGenCnt = 0; ucDataGenCnt < NUMDATGEN; ucDataGenCnt++) {
-		S_Report[ucDataGenCnt].m_ucFlags = 0;
-		S_Report[ucDataGenCnt].m_ucLength = 0;
-
-		for (ucByteCnt = 0; ucByteCnt < MAXDATALEN; ucByteCnt++) {
-			S_Report[ucDataGenCnt].m_ucaData[ucByteCnt] = 0;
-		}
-	}
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Loads the passed buffer with data stored in the S_Report structure
-//!
-//! \param *pBuff
-//! \return ucLength, the amount of bytes added to the passed buffer
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucMain_FetchData(volatile uint8 * pucBuff)
-{
-	uint8 ucDataGenCnt;
-	uint8 ucByteCnt;
-	uint8 ucLength;
-
-	// Assume no data
-	ucLength = 0;
-
-	// Check all the data generators for new data
-	for (ucDataGenCnt = 0; ucDataGenCnt < NUMDATGEN; ucDataGenCnt++)
-	{
-		// If there is new data to report then write to the passed buffer
-		if (S_Report[ucDataGenCnt].m_ucFlags & F_NEWDATA)
-		{
-			// write the data generator ID and the length of this message
-			*pucBuff++ = ucDataGenCnt;
-			*pucBuff++ = S_Report[ucDataGenCnt].m_ucLength;
-
-			// write the data
-			for (ucByteCnt = 0; ucByteCnt < S_Report[ucDataGenCnt].m_ucLength; ucByteCnt++)
-			{
-				*pucBuff++ = S_Report[ucDataGenCnt].m_ucaData[ucByteCnt];
-			}
-
-			// Update the length variable. Includes raw data, data generator ID, and length byte lengths
-			ucLength += (S_Report[ucDataGenCnt].m_ucLength + 2);
-		}
-	}
-
-return ucLength;
-}
-
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Fetches the requested transducer label and writes it to the passed array
-//!
-//!	\param ucTransNum, the desired transducer; *pucLabelArray, pointer to the label array
-//! \return none
-///////////////////////////////////////////////////////////////////////////////
-void vMain_FetchLabel(uint8 ucTransNum, volatile uint8 * pucLabelArray)
-{
-	uint8 ucLoopCount;
-
-	switch (ucTransNum)
-	{
-		// For each transducer, use the table to get the label
-		case TRANSDUCER_0:
-			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
-				*pucLabelArray++ = TRANSDUCER_0_LABEL_TXT[ucLoopCount];
-		break;
-		case TRANSDUCER_1:
-			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
-				*pucLabelArray++ = TRANSDUCER_1_LABEL_TXT[ucLoopCount];
-		break;
-
-		case TRANSDUCER_2:
-			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
-				*pucLabelArray++ = TRANSDUCER_2_LABEL_TXT[ucLoopCount];
-		break;
-
-		case TRANSDUCER_3:
-			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
-				*pucLabelArray++ = TRANSDUCER_3_LABEL_TXT[ucLoopCount];
-		break;
-
-		case TRANSDUCER_4:
-			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
-				*pucLabelArray++ = TRANSDUCER_4_LABEL_TXT[ucLoopCount];
-		break;
-		default:
-			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
-				*pucLabelArray++ = "CANNOT COMPUTE!!"[ucLoopCount];
-		break;
-
-	} // END: switch(ucTransNum)
-
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief invokes application specific function requesting sensor types
-//!
-//! This function is invoked from the core for uniformity sake - the function
-//! which actually requests sensor types is called from this function because
-//! the mechanism by which the types are gathered is application specific, and
-//! therefore must be called outside of the core
-//!
-//! SP-ST boards have no types and therefore this function does nothing;
-//! It must exist though for consistancy of the core
-//!
-///////////////////////////////////////////////////////////////////////////////
-void vMAIN_RequestSensorType(uint8 ucChannel)
-{
-	// do nothing
-	return;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief invokes application specific function returning sensor types
-//!
-//! This function is invoked from the core for uniformity sake - the function
-//! which actually returns sensor types is called from this function because
-//! the mechanism by which the types are gathered is application specific, and
-//! therefore must be called outside of the core
-//!
-//! SP-ST boards have no types and therefore this function does nothing;
-//! It must exist though for consistancy of the core
-//!
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucMAIN_ReturnSensorType(uint8 ucSensorCount)
-{
-	uint8 retVal = 0;
-
-	// return 0 type for every sensor
-	return retVal;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Returns the maximum number of sensors possible for this SP
-//!
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucMain_getNumTransducers(void)
-{
-	return NUM_TRANSDUCERS;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Returns the type of transducer (sensor vs. actuator)
-//!
-//! \param ucTransNum, the transducer number
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucMain_getTransducerType(uint8 ucTransNum)
-{
-	uint8 ucRetVal;
-
-	switch (ucTransNum)
-	{
-		case TRANSDUCER_1:
-		case TRANSDUCER_2:
-		case TRANSDUCER_3:
-		case TRANSDUCER_4:
-			ucRetVal = TYPE_IS_SENSOR; // For SP-ST board all the transducers are sensors
-		break;
-
-			// This is an error, we should not ever return 0
-		default:
-			ucRetVal = 0;
-		break;
-	}
-
-	return ucRetVal;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Returns the sample duration required for a sensor
-//!
-//! \param ucTransNum, the transducer number
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucMain_getSampleDuration(uint8 ucTransNum)
-{
-	return 1;// For SP-ST board all the transducers use 1 second to sample
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!
-//! \brief Dispatches to the sensor functions
-//!
-//! This is called from the core.  Calling a function in the application layer
-//! to dispatch to the sensor functions decouples the core since it does not
-//! need to "know" anything about the number of transducers
-//!
-//! \param ucCmdTransNum, the transducer number; ucCmdParamLen, length of parameters
-//! *ucParam, pointer to parameter array
-//! \return
-//!
-///////////////////////////////////////////////////////////////////////////////
-uint16 uiMainDispatch(uint8 ucCmdTransNum, uint8 ucCmdParamLen, uint8 *ucParam)
-{
-	uint8 ucRetVal;
-	
-	switch (ucCmdTransNum)
-	{
-		case 0:
-			ucRetVal = uiMain_Test(ucParam);
-		break;
-
-		case 1:
-			ucRetVal = uiMain_CH1(ucParam);
-		break;
-
-		case 2:
-			ucRetVal = uiMain_CH2(ucParam);
-		break;
-
-		case 3:
-			ucRetVal = uiMain_CH3(ucParam);
-		break;
-
-		case 4:
-			ucRetVal =  uiMain_CH4(ucParam);
-		break;
-
-		default:
-			ucRetVal = 1;
-		break;
-	}
-	return ucRetVal;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//! \brief The handler for event triggered functions
-//!
-//! Most of the tasks performed by the SP boards are at the immediate request
-//! of the CP board, but this is not always true.  This functions exists to handle the
-//!	case that there is an event that triggers the SP to exit to core.  Therefore
-//! the SP is capable of handling complex tasks while awaiting commands from the CP
-//!
-///////////////////////////////////////////////////////////////////////////////
-void vMain_EventTrigger(void)
-{
-
-//	// If the turn off the valve flag is true then dispatch to the function
-//	if (g_ucEventTrigger & some flag) {
-//
-//		// Clear the flag
-//		g_ucEventTrigger &= ~some flag;
-//
-//		// Pull the interrrupt line high to tell the CP that we have data
-//		P_INT_OUT |= INT_PIN;
-//	}
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//! \fn ucMain_Shutdown
-//!	\brief Checks to see if all processes are complete allowing the CP to cut power
-//!
-//! \return 1 if shutdown is OK
-///////////////////////////////////////////////////////////////////////////////
-uint8 ucMain_ShutdownAllowed(void){
-	return 1;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//!   \brief The main file for the SP-ST SP Board
-//!
-//!   Initializes Core, and flags
-//!	  Then runs vCORE_Run()
-//!
-//!   \param none
-//!   \return never
-///////////////////////////////////////////////////////////////////////////////
-
-
-void main(void)
-{
-	// Initialize core
-	vCORE_Initilize();
-
-	// Clean the data storage structure
-	vMain_CleanDataStruct();
-
-	// Clear the event trigger flags
-	g_ucEventTrigger = 0;
-
-	//Run core
-	vCORE_Run();
-}
+//*****************************************************************************
+// main.c
+//
+// By: Christopher Porter
+//     Wireless Networks Research Lab
+//     Dept of Electrical Engineering, CEFNS
+//     Northern Arizona University
+//
+// SP-ST Main
+//*****************************************************************************
+
+#include "hal.h"
+#include "core.h"
+//#include "hal/adc12.h"
+#include "Thermo.h"
+#include "LinkTest.h"
+#include "Convert.h"
+#include "Burst.h"
+
+//! @name Transducer Labels
+//! The labels for each transducer are set in constants here.
+//! Each constant must be 16 characters long.
+//! @{
+#define TRANSDUCER_0_LABEL_TXT "Test Function   " //00
+#define TRANSDUCER_1_LABEL_TXT "ST1             " //01
+#define TRANSDUCER_2_LABEL_TXT "ST2             " //02
+#define TRANSDUCER_3_LABEL_TXT "ST3             " //03
+#define TRANSDUCER_4_LABEL_TXT "ST4             " //04
+//!@}
+
+//! \def TRANSDUCER_0
+//! \brief Transducer 0 index definition
+#define TRANSDUCER_0   		0x00
+//! \def TRANSDUCER_1
+//! \brief Transducer 1 index definition
+#define TRANSDUCER_1      0x01
+//! \def TRANSDUCER_2
+//! \brief Transducer 2 index definition
+#define TRANSDUCER_2      0x02
+//! \def TRANSDUCER_3
+//! \brief Transducer 3 index definition
+#define TRANSDUCER_3      0x03
+//! \def TRANSDUCER_4
+//! \brief Transducer 4 index definition
+#define TRANSDUCER_4      0x04
+
+//! @name SP Board configuration data
+//!
+//! This information allows the CP board to learn about the sensors attached to the SP board
+//! and figure out how to schedule tasks dynamically
+//! @{
+//! \def NUM_TRANSDUCERS
+//! \brief The number of transducers the SP board can have attached
+#define NUM_TRANSDUCERS	4
+//! \def TYPE_IS_SENSOR
+//! \brief The transducer type definition for a sensor
+#define TYPE_IS_SENSOR			0x53 //ascii S
+//! \def TYPE_IS_ACTUATOR
+//! \brief The transducer type definition for an actuator
+#define TYPE_IS_ACTUATOR	0x41 //ascii A
+//!@}
+
+//! @name VLO Calibration
+//! @{
+//! \def VLO_CAL_TICKS
+//! \brief The ACLK ticks timed, 125 ms at the nominal rate
+#define VLO_CAL_TICKS		375UL
+//! \def VLO_CAL_CLOCK
+//! \brief The Timer B clock while calibrating, SMCLK / 8
+#define VLO_CAL_CLOCK		500000UL
+//! \def VLO_CAL_PERIOD
+//! \brief The fewest ACLK ticks between two calibrations on a sync, 5 minutes
+//! at the nominal rate
+#define VLO_CAL_PERIOD		(300UL * CLOCK_RATE_NOMINAL)
+//! @}
+
+//! @name SP Board data structure
+//! @{
+//! \def NUMDATGEN
+//! \brief The number of data generating elements on this board
+//! 1 per channel, 1 for zero, 1 for thermistor, and one for the diagnostics
+#define NUMDATGEN		0x07
+
+//! \def DATGEN_ID_TEMPERATURE
+//! \brief Set in the ID byte of a report entry that holds a channel's
+//! converted temperature, signed degrees C x 100, in place of raw ticks
+#define DATGEN_ID_TEMPERATURE	0x80
+
+//! \def DATGEN_ID_FAULT
+//! \brief Set in the ID byte of a report entry that holds a channel's fault,
+//! a single THERMO_HEALTH byte, in place of a reading
+#define DATGEN_ID_FAULT			0x40
+
+//! \def MAXDATALEN
+//! \brief This is the maximum length of a sensor reading for this board in bytes
+#define MAXDATALEN	0x02
+
+//! \def F_NEWDATA
+//! \brief Flag indicating that new data is loaded into the S_Report structure
+#define F_NEWDATA		0x01
+
+//! \def F_12BIT
+//! \brief Flag indicating that the data is a 12-bit value which can be packed
+#define F_12BIT			0x02
+
+//! \def F_TEMPERATURE
+//! \brief Flag indicating that the data is a converted temperature
+#define F_TEMPERATURE	0x04
+
+//! \def F_FAULT
+//! \brief Flag indicating that the data is the health of a dead channel
+#define F_FAULT			0x08
+
+// The packed report carries one presence bit per data generator in a single byte
+#if NUMDATGEN > 8
+	#error "NUMDATGEN does not fit the packed report presence bitmap"
+#endif
+
+//! \struct S_Report
+//! \brief Customizable struct provides a generalized interface between data generators and the core
+struct{
+		uint8 m_ucaData[MAXDATALEN];	//!< Holds information from a data generator
+		uint8 m_ucLength;							//!< Length of the data in the m_ucaData array (in bytes)
+		uint8 m_ucFlags;							//!< Flags
+		uint32 m_ulTime;							//!< ulCLOCK_Now() when the data was taken
+}S_Report[NUMDATGEN];
+//! @}
+
+//! \var gui_ZeroReading
+//! \brief global which stores the offset value
+unsigned int gui_ZeroReading=0;
+
+//! \var gui_ThermistorReading
+//! \brief global which stores the thermistor value
+unsigned int gui_ThermistorReading=0;
+
+//! \var gui_ADC_Initialized
+//! \brief Indicates if the ADC has been initialized
+unsigned char guc_ADCInitialized = 0;
+
+//! \var guc_ScanChannel
+//! \brief The channel read last, a read of this one or a lower one starts a
+//! new scan.  0xFF starts one with the next read.
+static unsigned char guc_ScanChannel = 0xFF;
+
+//! \var g_iVLOCal
+//! \brief Calibration constant for the VLO.
+//!This constant is the number of ticks required calibrate the VLO based on the typical frequency of 12000
+signed int g_iVLOCal;
+
+//! \var g_ulVLOCalTime
+//! \brief The timebase at the end of the latest VLO calibration
+static uint32 g_ulVLOCalTime;
+
+//! \var g_ucEventTrigger
+//! \brief Flag indicating that an application specific event has occured and requires handling
+unsigned char g_ucEventTrigger;
+
+///////////////////////////////////////////////////////////////////////////////
+//! \fn vMain_CalibrateVLO
+//! \brief Generates a calibration constant for the VLO
+//!
+//! The \ref clock timebase counts the VLO through ACLK so the board can remain
+//! in LPM3.
+//!
+//! The VLO frequency should be 12 kHz, but it can range from 4 kHZ to 20 kHz.
+//! Therefore, we must determine a calibration constant before it can be used.
+//! Timer B, sourced from SMCLK / 8, times VLO_CAL_TICKS ACLK ticks of the
+//! free running Timer A, starting and ending on an ACLK edge.  Timer A and the
+//! ACLK divider are left alone so the timebase and the bus timeout keep
+//! running.  g_iVLOCal is the deviation in ticks from a full second of 12000
+//! ticks, and the measured ACLK rate goes to the timebase.
+//!
+///////////////////////////////////////////////////////////////////////////////
+void vMain_CalibrateVLO(void){
+
+	uint16 uiStart;
+	uint16 uiNow;
+	uint16 uiOverflows;
+	uint32 ulCount;
+	uint16 uiRate;
+
+	// Timer B counts SMCLK / 8 once started
+	TBCTL = (TBSSEL_2 | ID_3 | TBCLR);
+	uiOverflows = 0;
+
+	// Wait for an ACLK edge to start on
+	uiStart = (uint16) ulCLOCK_Now();
+	do {
+		uiNow = (uint16) ulCLOCK_Now();
+	}
+	while (uiNow == uiStart);
+
+	TBCTL |= MC_2;
+	uiStart = uiNow;
+
+	do {
+		if (TBCTL & TBIFG) {
+			TBCTL &= ~TBIFG;
+			uiOverflows++;
+		}
+
+		uiNow = (uint16) ulCLOCK_Now();
+	}
+	while ((uint16) (uiNow - uiStart) < VLO_CAL_TICKS);
+
+	TBCTL &= ~MC_2;
+
+	// An overflow after the last check is still pending
+	if (TBCTL & TBIFG)
+		uiOverflows++;
+
+	ulCount = ((uint32) uiOverflows << 16) | TBR;
+	TBCTL = TBCLR;
+
+	// ACLK ticks per second, the VLO runs 4 times as fast
+	uiRate = (uint16) ((VLO_CAL_TICKS * VLO_CAL_CLOCK + (ulCount >> 1)) / ulCount);
+
+	// Set the global cal constant
+	g_iVLOCal = (signed int) (uiRate << 2) - 12000;
+
+	vCLOCK_SetRate(uiRate);
+
+	g_ulVLOCalTime = ulCLOCK_Now();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \fn vMain_TimeSync
+//! \brief Called by the core after it has answered a TIME_SYNC
+//!
+//! The VLO drifts with temperature and supply, so the rate is measured again
+//! for the period that starts with the sync.  The calibration busy-polls in
+//! active mode for VLO_CAL_TICKS, so it is done at most once in
+//! VLO_CAL_PERIOD and a CP that syncs often keeps the previous rate.
+//!
+//! \param none
+//! \return none
+///////////////////////////////////////////////////////////////////////////////
+void vMain_TimeSync(void)
+{
+	if (ulCLOCK_Now() - g_ulVLOCalTime >= VLO_CAL_PERIOD)
+		vMain_CalibrateVLO();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Used as a test function
+//!
+//! gets passed the data to pack data in for the core. Returns a uint16 which is a data message
+//!
+//! Without parameters the report is 0xBEEF.  With parameters the command arms
+//! a \ref linktest run, and the report is the operation followed by 0 on
+//! success or 1 for bad parameters.
+//!
+//!   \param ucParamLen, the number of parameters; ucParam, pointer to an array
+//!   where command parameters are (if needed)
+//!
+///////////////////////////////////////////////////////////////////////////////////////////////////
+uint16 uiMain_Test(uint8 ucParamLen, uint8 *ucParam)
+{
+	uint16 uiRetVal;
+
+	if (ucParamLen == 0) {
+		S_Report[0].m_ucaData[0] = 0xBE;
+		S_Report[0].m_ucaData[1] = 0xEF;
+		uiRetVal = 0;
+	}
+	else if (ucParam[0] == BURST_OP_CAPTURE) {
+		// Make sure the ADC is initialized
+		if (guc_ADCInitialized == 0)
+		{
+			vADCInit();
+			guc_ADCInitialized = 1; //indicate the ADC is initialized
+		}
+
+		uiRetVal = uiBurst_Command(ucParamLen, ucParam);
+		S_Report[0].m_ucaData[0] = ucParam[0];
+		S_Report[0].m_ucaData[1] = (uint8) uiRetVal;
+	}
+	else {
+		uiRetVal = uiLinkTest_Command(ucParamLen, ucParam);
+		S_Report[0].m_ucaData[0] = ucParam[0];
+		S_Report[0].m_ucaData[1] = (uint8) uiRetVal;
+	}
+
+	S_Report[0].m_ucLength = 2;
+	S_Report[0].m_ucFlags = F_NEWDATA;
+	S_Report[0].m_ulTime = ulCLOCK_Now();
+
+	return uiRetVal;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Reports gui_ZeroReading in the data generator of the zero
+//!
+//! \param none
+//! \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vMain_ReportZero(void)
+{
+	S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
+	S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
+	S_Report[1].m_ucLength = 2;
+	S_Report[1].m_ucFlags = F_NEWDATA | F_12BIT;
+	S_Report[1].m_ulTime = ulCLOCK_Now();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Replaces a channel's report entry with its fault
+//!
+//! \param ucDataGen, the data generator of the channel; ucHealth, the
+//! THERMO_HEALTH the channel was found in
+//! \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vMain_ReportFault(uint8 ucDataGen, uint8 ucHealth)
+{
+	S_Report[ucDataGen].m_ucaData[0] = ucHealth;
+	S_Report[ucDataGen].m_ucLength = 1;
+	S_Report[ucDataGen].m_ucFlags = F_NEWDATA | F_FAULT;
+	S_Report[ucDataGen].m_ulTime = ulCLOCK_Now();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Reads and reports a channel
+//!
+//! A channel last seen open or shorted gets a fast probe in place of the full
+//! reading, and is only read again once the probe finds it connected.  A full
+//! reading that lands on a rail marks the channel dead for the next scan.
+//!
+//! A channel without a sensor type reports the raw ticks in its own data
+//! generator.  A channel configured with a thermocouple type reports the
+//! \ref convert temperature in that generator instead, as signed degrees
+//! C x 100 (CONVERT_OUT_OF_RANGE on failure), with DATGEN_ID_TEMPERATURE set
+//! in its ID.  A dead channel reports its THERMO_HEALTH in that generator,
+//! with DATGEN_ID_FAULT set in its ID, so the other channels of the frame are
+//! still reported as data.
+//!
+//! The first command parameter, if any, selects the THERMO_FILTER of the
+//! reading.  Without parameters the reading uses THERMO_FILTER_DEFAULT.  Only
+//! if THERMO_FILTER_EXTENDED is set in it, the second and third select the
+//! mains synchronous sampling mode and the number of periods (1 if left out),
+//! and the fourth turns the ratiometric mode on or off.  These hold for the
+//! readings that follow.
+//!
+//! In the ratiometric mode the zero is read again at the start of each scan
+//! of the channels and reported in its data generator.  The other channels
+//! of the scan reuse it.
+//!
+//! \param ucChannel, the channel; ucDataGen, the data generator of the
+//! channel; ucParamLen, ucParam, the command parameters
+//! \return 0 on success or a dead channel, 1 for bad parameters
+///////////////////////////////////////////////////////////////////////////////
+uint16 uiMain_ReadChannel(uint8 ucChannel, uint8 ucDataGen, uint8 ucParamLen, uint8 *ucParam)
+{
+	uint16 uiCHReading;
+	uint8 ucFilter;
+	uint8 ucHealth;
+	int16 iTemp;
+
+	if (ucThermo_GetHealth(ucChannel) != THERMO_HEALTH_CONNECTED)
+	{
+		ucHealth = ucThermo_ProbeChannel(ucChannel);
+		if (ucHealth != THERMO_HEALTH_CONNECTED)
+		{
+			vMain_ReportFault(ucDataGen, ucHealth);
+			return 0;
+		}
+	}
+
+	ucFilter = THERMO_FILTER_DEFAULT;
+	if (ucParamLen != 0)
+		ucFilter = ucParam[0] & ~THERMO_FILTER_EXTENDED;
+
+	// A CP that predates the modes may send other bytes after the filter
+	if (ucParamLen != 0 && (ucParam[0] & THERMO_FILTER_EXTENDED))
+	{
+		if (ucParamLen >= 2)
+		{
+			if (ucThermo_SetMainsSync(ucParam[1], (ucParamLen >= 3) ? ucParam[2] : 1) != 0)
+				return 1;
+		}
+
+		if (ucParamLen >= 4)
+		{
+			// The zero is read under the mode before the next channel
+			vThermo_SetRatiometric(ucParam[3]);
+			guc_ScanChannel = 0xFF;
+		}
+	}
+
+	if (ucThermo_GetRatiometric() && ucChannel <= guc_ScanChannel)
+	{
+		vZeroReading();
+		vMain_ReportZero();
+	}
+	guc_ScanChannel = ucChannel;
+
+	uiCHReading = uiThermo_ReadChannel(ucChannel, ucFilter);
+
+	ucHealth = ucThermo_ClassifyReading(ucChannel, uiCHReading);
+	if (ucHealth != THERMO_HEALTH_CONNECTED)
+	{
+		vMain_ReportFault(ucDataGen, ucHealth);
+		return 0;
+	}
+
+	if (ucConvert_GetType(ucChannel) == CONVERT_TYPE_NONE)
+	{
+		S_Report[ucDataGen].m_ucaData[0] = (uint8) (uiCHReading >> 8);
+		S_Report[ucDataGen].m_ucaData[1] = (uint8) uiCHReading;
+		S_Report[ucDataGen].m_ucLength = 2;
+		S_Report[ucDataGen].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[ucDataGen].m_ulTime = ulCLOCK_Now();
+		return 0;
+	}
+
+	iTemp = iConvert_Thermocouple(ucChannel, uiCHReading, gui_ZeroReading, iConvert_Thermistor(gui_ThermistorReading));
+
+	S_Report[ucDataGen].m_ucaData[0] = (uint8) ((uint16) iTemp >> 8);
+	S_Report[ucDataGen].m_ucaData[1] = (uint8) iTemp;
+	S_Report[ucDataGen].m_ucLength = 2;
+	S_Report[ucDataGen].m_ucFlags = F_NEWDATA | F_TEMPERATURE;
+	S_Report[ucDataGen].m_ulTime = ulCLOCK_Now();
+
+	return 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Used to read CH0
+//!
+//! gets passed the dataarray to pack data in for the core. Returns a unit16 which is a data message
+//!
+//! \param dataarray	Core variables to send back the data in
+//!
+//!
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint16 uiMain_CH1(uint8 ucParamLen, uint8 *ucParam)
+{
+	// Make sure the ADC is initialized
+	if (guc_ADCInitialized == 0)
+	{
+		vADCInit();
+		guc_ADCInitialized = 1; //indicate the ADC is initialized
+	}
+
+	// Zero and thermistor reading is required for all channels (besides test )
+	if (gui_ThermistorReading == 0 && gui_ZeroReading == 0)
+	{
+		vZeroReading();
+		vThermistorReading();
+
+		S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
+		S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
+		S_Report[1].m_ucLength = 2;
+		S_Report[1].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[1].m_ulTime = ulCLOCK_Now();
+
+		S_Report[2].m_ucaData[0] = (uint8) (gui_ThermistorReading >> 8);
+		S_Report[2].m_ucaData[1] = (uint8) gui_ThermistorReading;
+		S_Report[2].m_ucLength = 2;
+		S_Report[2].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[2].m_ulTime = ulCLOCK_Now();
+	}
+
+	// Read the channel unless it is known to be dead
+	return uiMain_ReadChannel(1, 3, ucParamLen, ucParam);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Used to read CH1
+//!
+//! gets passed the dataarray to pack data in for the core. Returns a unit16 which is a data message
+//!
+//! \param dataarray	Core variables to send back the data in
+//!
+//!
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+uint16 uiMain_CH2(uint8 ucParamLen, uint8 *ucParam)
+{
+	// Make sure the ADC is initialized
+	if (guc_ADCInitialized == 0)
+	{
+		vADCInit();
+		guc_ADCInitialized = 1; //indicate the ADC is initialized
+	}
+
+	// Zero and thermistor reading is required for all channels (besides test )
+	if (gui_ThermistorReading == 0 && gui_ZeroReading == 0)
+	{
+		vZeroReading();
+		vThermistorReading();
+
+		S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
+		S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
+		S_Report[1].m_ucLength = 2;
+		S_Report[1].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[1].m_ulTime = ulCLOCK_Now();
+
+		S_Report[2].m_ucaData[0] = (uint8) (gui_ThermistorReading >> 8);
+		S_Report[2].m_ucaData[1] = (uint8) gui_ThermistorReading;
+		S_Report[2].m_ucLength = 2;
+		S_Report[2].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[2].m_ulTime = ulCLOCK_Now();
+	}
+
+	// Read the channel unless it is known to be dead
+	return uiMain_ReadChannel(2, 4, ucParamLen, ucParam);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Used to read CH2
+//!
+//! gets passed the dataarray to pack data in for the core. Returns a unit16 which is a data message
+//!
+//! \param dataarray	Core variables to send back the data in
+//!
+//!
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint16 uiMain_CH3(uint8 ucParamLen, uint8 *ucParam)
+{
+	// Make sure the ADC is initialized
+	if (guc_ADCInitialized == 0)
+	{
+		vADCInit();
+		guc_ADCInitialized = 1; //indicate the ADC is initialized
+	}
+
+	// Zero and thermistor reading is required for all channels (besides test )
+	if (gui_ThermistorReading == 0 && gui_ZeroReading == 0)
+	{
+		vZeroReading();
+		vThermistorReading();
+
+		S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
+		S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
+		S_Report[1].m_ucLength = 2;
+		S_Report[1].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[1].m_ulTime = ulCLOCK_Now();
+
+		S_Report[2].m_ucaData[0] = (uint8) (gui_ThermistorReading >> 8);
+		S_Report[2].m_ucaData[1] = (uint8) gui_ThermistorReading;
+		S_Report[2].m_ucLength = 2;
+		S_Report[2].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[2].m_ulTime = ulCLOCK_Now();
+	}
+
+	// Read the channel unless it is known to be dead
+	return uiMain_ReadChannel(3, 5, ucParamLen, ucParam);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Used to read CH4
+//!
+//! gets passed the dataarray to pack data in for the core. Returns a unit16 which is a data message
+//!
+//! \param dataarray	Core variables to send back the data in
+//!
+//!
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+uint16 uiMain_CH4(uint8 ucParamLen, uint8 *ucParam)
+{
+	// Make sure the ADC is initialized
+	if (guc_ADCInitialized == 0)
+	{
+		vADCInit();
+		guc_ADCInitialized = 1; //indicate the ADC is initialized
+	}
+
+	// Zero and thermistor reading is required for all channels (besides test )
+	if (gui_ThermistorReading == 0 && gui_ZeroReading == 0)
+	{
+		vZeroReading();
+		vThermistorReading();
+
+		S_Report[1].m_ucaData[0] = (uint8) (gui_ZeroReading >> 8);
+		S_Report[1].m_ucaData[1] = (uint8) gui_ZeroReading;
+		S_Report[1].m_ucLength = 2;
+		S_Report[1].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[1].m_ulTime = ulCLOCK_Now();
+
+		S_Report[2].m_ucaData[0] = (uint8) (gui_ThermistorReading >> 8);
+		S_Report[2].m_ucaData[1] = (uint8) gui_ThermistorReading;
+		S_Report[2].m_ucLength = 2;
+		S_Report[2].m_ucFlags = F_NEWDATA | F_12BIT;
+		S_Report[2].m_ulTime = ulCLOCK_Now();
+	}
+
+	// Read the channel unless it is known to be dead
+	return uiMain_ReadChannel(4, 6, ucParamLen, ucParam);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Initializes the data storage structure
+//!
+//! \param none
+//! \return none
+///////////////////////////////////////////////////////////////////////////////
+void vMain_CleanDataStruct(void)
+{
+	uint8 ucDataGenCnt;
+	uint8 ucByteCnt;
+
+	// Clean out the data storage structure
+	for (ucDataGenCnt = 0; ucDataGenCnt < NUMDATGEN; ucDataGenCnt++) {
+		S_Report[ucDataGenCnt].m_ucFlags = 0;
+		S_Report[ucDataGenCnt].m_ucLength = 0;
+		S_Report[ucDataGenCnt].m_ulTime = 0;
+
+		for (ucByteCnt = 0; ucByteCnt < MAXDATALEN; ucByteCnt++) {
+			S_Report[ucDataGenCnt].m_ucaData[ucByteCnt] = 0;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Returns the ID byte of a data generator's report entry
+//!
+//! \param ucDataGen, the data generator
+//! \return The generator number, with DATGEN_ID_TEMPERATURE set if it holds
+//! a converted temperature or DATGEN_ID_FAULT if it holds a fault
+///////////////////////////////////////////////////////////////////////////////
+static uint8 ucMain_ReportID(uint8 ucDataGen)
+{
+	if (S_Report[ucDataGen].m_ucFlags & F_TEMPERATURE)
+		return ucDataGen | DATGEN_ID_TEMPERATURE;
+
+	if (S_Report[ucDataGen].m_ucFlags & F_FAULT)
+		return ucDataGen | DATGEN_ID_FAULT;
+
+	return ucDataGen;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Loads the passed buffer with data stored in the S_Report structure
+//!
+//! \param *pBuff
+//! \return ucLength, the amount of bytes added to the passed buffer
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_FetchData(volatile uint8 * pucBuff)
+{
+	uint8 ucDataGenCnt;
+	uint8 ucByteCnt;
+	uint8 ucLength;
+
+	// Assume no data
+	ucLength = 0;
+
+	// Check all the data generators for new data
+	for (ucDataGenCnt = 0; ucDataGenCnt < NUMDATGEN; ucDataGenCnt++)
+	{
+		// If there is new data to report then write to the passed buffer
+		if (S_Report[ucDataGenCnt].m_ucFlags & F_NEWDATA)
+		{
+			// write the data generator ID and the length of this message
+			*pucBuff++ = ucMain_ReportID(ucDataGenCnt);
+			*pucBuff++ = S_Report[ucDataGenCnt].m_ucLength;
+
+			// write the data
+			for (ucByteCnt = 0; ucByteCnt < S_Report[ucDataGenCnt].m_ucLength; ucByteCnt++)
+			{
+				*pucBuff++ = S_Report[ucDataGenCnt].m_ucaData[ucByteCnt];
+			}
+
+			// Update the length variable. Includes raw data, data generator ID, and length byte lengths
+			ucLength += (S_Report[ucDataGenCnt].m_ucLength + 2);
+		}
+	}
+
+return ucLength;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Loads the passed buffer with the S_Report data in packed form
+//!
+//! A presence bitmap is followed by the 12-bit values packed two to every
+//! three bytes.  Data generators that do not hold 12-bit values follow in the
+//! same form as ucMain_FetchData().  See SP_DATAMESSAGE_VERSION_PACKED.
+//!
+//! \param *pucBuff
+//! \return ucLength, the amount of bytes added to the passed buffer
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_FetchPackedData(volatile uint8 * pucBuff)
+{
+	volatile uint8 * pucBitmap;
+	uint8 ucDataGenCnt;
+	uint8 ucByteCnt;
+	uint8 ucLength;
+	uint8 ucHalfByte;
+	uint16 uiValue;
+
+	// The bitmap leads the payload
+	pucBitmap = pucBuff++;
+	*pucBitmap = 0;
+	ucLength = 1;
+
+	// No value is waiting for its second half
+	ucHalfByte = FALSE;
+
+	// Pack the 12-bit values
+	for (ucDataGenCnt = 0; ucDataGenCnt < NUMDATGEN; ucDataGenCnt++)
+	{
+		if ((S_Report[ucDataGenCnt].m_ucFlags & (F_NEWDATA | F_12BIT)) == (F_NEWDATA | F_12BIT))
+		{
+			*pucBitmap |= (1 << ucDataGenCnt);
+
+			uiValue = ((uint16) S_Report[ucDataGenCnt].m_ucaData[0] << 8) | S_Report[ucDataGenCnt].m_ucaData[1];
+
+			// Calibrated readings may run slightly past full scale
+			if (uiValue > 0x0FFF)
+				uiValue = 0x0FFF;
+
+			if (ucHalfByte == FALSE)
+			{
+				// Upper 8 bits, then the lower 4 bits in the top of the next byte
+				*pucBuff++ = (uint8) (uiValue >> 4);
+				*pucBuff = (uint8) (uiValue << 4);
+				ucLength += 2;
+				ucHalfByte = TRUE;
+			}
+			else
+			{
+				// Upper 4 bits finish the shared byte, then the lower 8 bits
+				*pucBuff++ |= (uint8) (uiValue >> 8);
+				*pucBuff++ = (uint8) uiValue;
+				ucLength++;
+				ucHalfByte = FALSE;
+			}
+		}
+	}
+
+	// Step past a shared byte that was only half used
+	if (ucHalfByte == TRUE)
+		pucBuff++;
+
+	// Everything else goes out as it does in the unpacked report
+	for (ucDataGenCnt = 0; ucDataGenCnt < NUMDATGEN; ucDataGenCnt++)
+	{
+		if ((S_Report[ucDataGenCnt].m_ucFlags & (F_NEWDATA | F_12BIT)) == F_NEWDATA)
+		{
+			*pucBuff++ = ucMain_ReportID(ucDataGenCnt);
+			*pucBuff++ = S_Report[ucDataGenCnt].m_ucLength;
+
+			for (ucByteCnt = 0; ucByteCnt < S_Report[ucDataGenCnt].m_ucLength; ucByteCnt++)
+			{
+				*pucBuff++ = S_Report[ucDataGenCnt].m_ucaData[ucByteCnt];
+			}
+
+			ucLength += (S_Report[ucDataGenCnt].m_ucLength + 2);
+		}
+	}
+
+	return ucLength;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Loads the passed buffer with the S_Report data and its age
+//!
+//! The time of the frame leads, in milliseconds since the latest TIME_SYNC.
+//! Each data generator follows as in ucMain_FetchData() with the age of its
+//! data appended.  See SP_DATAMESSAGE_VERSION_TIMED.
+//!
+//! \param *pucBuff
+//! \return ucLength, the amount of bytes added to the passed buffer
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_FetchTimedData(volatile uint8 * pucBuff)
+{
+	uint8 ucDataGenCnt;
+	uint8 ucByteCnt;
+	uint8 ucLength;
+	uint32 ulBase;
+	uint32 ulValue;
+
+	// The ages count back from the time of the frame
+	ulBase = ulCLOCK_Now();
+
+	ulValue = ulCLOCK_SinceSync(ulBase);
+	*pucBuff++ = (uint8) (ulValue >> 24);
+	*pucBuff++ = (uint8) (ulValue >> 16);
+	*pucBuff++ = (uint8) (ulValue >> 8);
+	*pucBuff++ = (uint8) ulValue;
+	ucLength = 4;
+
+	for (ucDataGenCnt = 0; ucDataGenCnt < NUMDATGEN; ucDataGenCnt++)
+	{
+		if (S_Report[ucDataGenCnt].m_ucFlags & F_NEWDATA)
+		{
+			*pucBuff++ = ucMain_ReportID(ucDataGenCnt);
+			*pucBuff++ = S_Report[ucDataGenCnt].m_ucLength;
+
+			for (ucByteCnt = 0; ucByteCnt < S_Report[ucDataGenCnt].m_ucLength; ucByteCnt++)
+			{
+				*pucBuff++ = S_Report[ucDataGenCnt].m_ucaData[ucByteCnt];
+			}
+
+			// Data older than the age can hold is only known to be old
+			ulValue = ulCLOCK_ToMillis(ulBase - S_Report[ucDataGenCnt].m_ulTime);
+			if (ulValue > 0xFFFF)
+				ulValue = 0xFFFF;
+
+			*pucBuff++ = (uint8) (ulValue >> 8);
+			*pucBuff++ = (uint8) ulValue;
+
+			ucLength += (S_Report[ucDataGenCnt].m_ucLength + 4);
+		}
+	}
+
+	return ucLength;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Fetches the requested transducer label and writes it to the passed array
+//!
+//!	\param ucTransNum, the desired transducer; *pucLabelArray, pointer to the label array
+//! \return none
+///////////////////////////////////////////////////////////////////////////////
+void vMain_FetchLabel(uint8 ucTransNum, volatile uint8 * pucLabelArray)
+{
+	uint8 ucLoopCount;
+
+	switch (ucTransNum)
+	{
+		// For each transducer, use the table to get the label
+		case TRANSDUCER_0:
+			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
+				*pucLabelArray++ = TRANSDUCER_0_LABEL_TXT[ucLoopCount];
+		break;
+		case TRANSDUCER_1:
+			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
+				*pucLabelArray++ = TRANSDUCER_1_LABEL_TXT[ucLoopCount];
+		break;
+
+		case TRANSDUCER_2:
+			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
+				*pucLabelArray++ = TRANSDUCER_2_LABEL_TXT[ucLoopCount];
+		break;
+
+		case TRANSDUCER_3:
+			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
+				*pucLabelArray++ = TRANSDUCER_3_LABEL_TXT[ucLoopCount];
+		break;
+
+		case TRANSDUCER_4:
+			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
+				*pucLabelArray++ = TRANSDUCER_4_LABEL_TXT[ucLoopCount];
+		break;
+		default:
+			for (ucLoopCount = 0x00; ucLoopCount < TRANSDUCER_LABEL_LEN; ucLoopCount++)
+				*pucLabelArray++ = "CANNOT COMPUTE!!"[ucLoopCount];
+		break;
+
+	} // END: switch(ucTransNum)
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Binds a channel to the conversion table of its stored type
+//!
+//! \param ucChannel, the channel 1 to 4
+///////////////////////////////////////////////////////////////////////////////
+void vMain_LoadSensorType(uint8 ucChannel)
+{
+	uint8 ucaTypes[SENSOR_TYPE_COUNT];
+
+	if (ucChannel == 0 || ucChannel > SENSOR_TYPE_COUNT)
+		return;
+
+	vFlash_GetSensorTypes(ucaTypes);
+
+	// Erased flash binds no table and the channel reports raw ticks
+	ucConvert_Bind(ucChannel, ucaTypes[ucChannel - 1]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief invokes application specific function requesting sensor types
+//!
+//! This function is invoked from the core for uniformity sake - the function
+//! which actually requests sensor types is called from this function because
+//! the mechanism by which the types are gathered is application specific, and
+//! therefore must be called outside of the core
+//!
+//! SP-ST boards cannot detect the thermocouple type, so the type stored in
+//! flash is loaded.  The channel is probed for an open or shorted
+//! thermocouple, see ucMAIN_ReturnSensorHealth().
+//!
+//! \param ucChannel, the channel 1 to 4
+///////////////////////////////////////////////////////////////////////////////
+void vMAIN_RequestSensorType(uint8 ucChannel)
+{
+	if (ucChannel == 0 || ucChannel > SENSOR_TYPE_COUNT)
+		return;
+
+	vMain_LoadSensorType(ucChannel);
+
+	// Make sure the ADC is initialized
+	if (guc_ADCInitialized == 0)
+	{
+		vADCInit();
+		guc_ADCInitialized = 1; //indicate the ADC is initialized
+	}
+
+	ucThermo_ProbeChannel(ucChannel);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief invokes application specific function returning sensor types
+//!
+//! This function is invoked from the core for uniformity sake - the function
+//! which actually returns sensor types is called from this function because
+//! the mechanism by which the types are gathered is application specific, and
+//! therefore must be called outside of the core
+//!
+//! \param ucSensorCount, the channel 1 to 4
+//! \return the thermocouple type letter, 0 for raw ticks
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMAIN_ReturnSensorType(uint8 ucSensorCount)
+{
+	return ucConvert_GetType(ucSensorCount);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Returns the health of a channel
+//!
+//! The health is cached from the last probe or reading of the channel.
+//!
+//! \param ucSensorCount, the channel 1 to 4
+//! \return the THERMO_HEALTH code
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMAIN_ReturnSensorHealth(uint8 ucSensorCount)
+{
+	return ucThermo_GetHealth(ucSensorCount);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Configures the sensor type of every channel
+//!
+//! The types are checked and bound first, then stored in flash so they
+//! survive a power cycle.  If any type is unknown nothing is stored and the
+//! channels are bound to the stored types again.
+//!
+//! \param pucTypes, one type letter per channel, 0 for raw ticks
+//! \return 0 on success, 1 on failure
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMAIN_SetSensorTypes(uint8 * pucTypes)
+{
+	uint8 ucChannel;
+	uint8 ucErr;
+
+	ucErr = 0;
+
+	for (ucChannel = 1; ucChannel <= SENSOR_TYPE_COUNT; ucChannel++)
+		ucErr |= ucConvert_Bind(ucChannel, pucTypes[ucChannel - 1]);
+
+	if (ucErr == 0)
+		ucErr = ucFlash_SetSensorTypes(pucTypes);
+
+	if (ucErr != 0)
+	{
+		for (ucChannel = 1; ucChannel <= SENSOR_TYPE_COUNT; ucChannel++)
+			vMain_LoadSensorType(ucChannel);
+	}
+
+	return ucErr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Returns the maximum number of sensors possible for this SP
+//!
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_getNumTransducers(void)
+{
+	return NUM_TRANSDUCERS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Returns the type of transducer (sensor vs. actuator)
+//!
+//! \param ucTransNum, the transducer number
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_getTransducerType(uint8 ucTransNum)
+{
+	uint8 ucRetVal;
+
+	switch (ucTransNum)
+	{
+		case TRANSDUCER_1:
+		case TRANSDUCER_2:
+		case TRANSDUCER_3:
+		case TRANSDUCER_4:
+			ucRetVal = TYPE_IS_SENSOR; // For SP-ST board all the transducers are sensors
+		break;
+
+			// This is an error, we should not ever return 0
+		default:
+			ucRetVal = 0;
+		break;
+	}
+
+	return ucRetVal;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Returns the sample duration required for a sensor
+//!
+//! \param ucTransNum, the transducer number
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_getSampleDuration(uint8 ucTransNum)
+{
+	return 1;// For SP-ST board all the transducers use 1 second to sample
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!
+//! \brief Dispatches to the sensor functions
+//!
+//! This is called from the core.  Calling a function in the application layer
+//! to dispatch to the sensor functions decouples the core since it does not
+//! need to "know" anything about the number of transducers
+//!
+//! \param ucCmdTransNum, the transducer number; ucCmdParamLen, length of parameters
+//! *ucParam, pointer to parameter array
+//! \return
+//!
+///////////////////////////////////////////////////////////////////////////////
+uint16 uiMainDispatch(uint8 ucCmdTransNum, uint8 ucCmdParamLen, uint8 *ucParam)
+{
+	uint8 ucRetVal;
+	
+	switch (ucCmdTransNum)
+	{
+		case 0:
+			ucRetVal = uiMain_Test(ucCmdParamLen, ucParam);
+		break;
+
+		case 1:
+			ucRetVal = uiMain_CH1(ucCmdParamLen, ucParam);
+		break;
+
+		case 2:
+			ucRetVal = uiMain_CH2(ucCmdParamLen, ucParam);
+		break;
+
+		case 3:
+			ucRetVal = uiMain_CH3(ucCmdParamLen, ucParam);
+		break;
+
+		case 4:
+			ucRetVal =  uiMain_CH4(ucCmdParamLen, ucParam);
+		break;
+
+		default:
+			ucRetVal = 1;
+		break;
+	}
+	return ucRetVal;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The handler for event triggered functions
+//!
+//! Most of the tasks performed by the SP boards are at the immediate request
+//! of the CP board, but this is not always true.  This functions exists to handle the
+//!	case that there is an event that triggers the SP to exit to core.  Therefore
+//! the SP is capable of handling complex tasks while awaiting commands from the CP
+//!
+///////////////////////////////////////////////////////////////////////////////
+void vMain_EventTrigger(void)
+{
+
+//	// If the turn off the valve flag is true then dispatch to the function
+//	if (g_ucEventTrigger & some flag) {
+//
+//		// Clear the flag
+//		g_ucEventTrigger &= ~some flag;
+//
+//		// Pull the interrrupt line high to tell the CP that we have data
+//		P_INT_OUT |= INT_PIN;
+//	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \fn ucMain_Shutdown
+//!	\brief Checks to see if all processes are complete allowing the CP to cut power
+//!
+//! \return 1 if shutdown is OK
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_ShutdownAllowed(void){
+	return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Reads a segment of a transfer object
+//!
+//! Called by the core for every XFER_DATA frame.  Fewer than ucMaxLen bytes
+//! marks the end of the object.
+//!
+//! \param ucObject, the object number; uiOffset, byte offset in the object;
+//! pucBuff, where to write the data; ucMaxLen, the size of a full segment
+//! \return The number of bytes written, or XFER_NO_OBJECT
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_XferRead(uint8 ucObject, uint16 uiOffset, volatile uint8 * pucBuff, uint8 ucMaxLen)
+{
+	// Transducer 0 owns the transfer objects
+	if (ucObject == BURST_OBJ_INFO || ucObject == BURST_OBJ_DATA)
+		return ucBurst_XferRead(ucObject, uiOffset, pucBuff, ucMaxLen);
+
+	return ucLinkTest_XferRead(ucObject, uiOffset, pucBuff, ucMaxLen);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Stores a segment of a transfer object
+//!
+//! Called by the core for every in-order XFER_WRITE segment.  The link test
+//! sink checks each segment as it arrives, so nothing waits for the last one.
+//!
+//! \param ucObject, the object number; uiOffset, byte offset in the object;
+//! pucData, the segment data; ucLength, the number of bytes
+//! \return XFER_OK or an XFER error code
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_XferWrite(uint8 ucObject, uint16 uiOffset, volatile uint8 * pucData, uint8 ucLength)
+{
+	// Transducer 0 owns the transfer objects
+	return ucLinkTest_XferWrite(ucObject, uiOffset, pucData, ucLength);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Runs a calibration operation
+//!
+//! Called by the core for every CALIBRATE message.  The payload is
+//! [operation, channel, ...], see the THERMO_CAL_OP codes.  The reply
+//! replaces the payload and holds the operation, the channel and the
+//! calibration of the channel after the operation, MSB first.
+//!
+//! \param pucPayload, the payload; ucLength, the number of payload bytes
+//! \return The length of the reply, 0 on failure
+///////////////////////////////////////////////////////////////////////////////
+uint8 ucMain_Calibrate(volatile uint8 * pucPayload, uint8 ucLength)
+{
+	uint8 ucChannel;
+	uint8 ucErr;
+	unsigned int uiGain;
+	signed int iOffset;
+
+	if (ucLength < 2)
+		return 0;
+
+	ucChannel = pucPayload[1];
+	if (ucChannel == 0 || ucChannel > SENSOR_TYPE_COUNT)
+		return 0;
+
+	switch (pucPayload[0]) {
+		case THERMO_CAL_OP_READ:
+			ucErr = 0;
+			break;
+
+		case THERMO_CAL_OP_LOW:
+		case THERMO_CAL_OP_HIGH:
+			if (ucLength < 4)
+				return 0;
+
+			// Make sure the ADC is initialized
+			if (guc_ADCInitialized == 0)
+			{
+				vADCInit();
+				guc_ADCInitialized = 1; //indicate the ADC is initialized
+			}
+
+			ucErr = ucThermo_CapturePoint(ucChannel, pucPayload[0] - THERMO_CAL_OP_LOW, ((uint16) pucPayload[2] << 8) | pucPayload[3]);
+			break;
+
+		case THERMO_CAL_OP_STORE:
+			ucErr = ucThermo_StoreCapture(ucChannel);
+			break;
+
+		case THERMO_CAL_OP_SET:
+			if (ucLength < 6)
+				return 0;
+
+			ucErr = ucThermo_SetCalibration(ucChannel, ((uint16) pucPayload[2] << 8) | pucPayload[3], (int16) (((uint16) pucPayload[4] << 8) | pucPayload[5]));
+			break;
+
+		case THERMO_CAL_OP_CLEAR:
+			ucErr = ucThermo_SetCalibration(ucChannel, THERMO_CAL_UNITY, 0);
+			break;
+
+		default:
+			return 0;
+	}
+
+	if (ucErr != 0)
+		return 0;
+
+	vThermo_GetCalibration(ucChannel, &uiGain, &iOffset);
+
+	pucPayload[2] = (uint8) (uiGain >> 8);
+	pucPayload[3] = (uint8) uiGain;
+	pucPayload[4] = (uint8) ((unsigned int) iOffset >> 8);
+	pucPayload[5] = (uint8) iOffset;
+
+	return THERMO_CAL_REPLY_LEN;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//!   \brief The main file for the SP-ST SP Board
+//!
+//!   Initializes Core, and flags
+//!	  Then runs vCORE_Run()
+//!
+//!   \param none
+//!   \return never
+///////////////////////////////////////////////////////////////////////////////
+
+
+void main(void)
+{
+	uint8 ucChannel;
+
+	// Initialize core
+	vCORE_Initilize();
+
+	// Measure the VLO for the timebase
+	vMain_CalibrateVLO();
+
+	// Clean the data storage structure
+	vMain_CleanDataStruct();
+
+	// Bind every channel to the conversion table of its stored type
+	for (ucChannel = 1; ucChannel <= SENSOR_TYPE_COUNT; ucChannel++)
+		vMain_LoadSensorType(ucChannel);
+
+	// Merge the stored channel calibration with the factory calibration
+	vThermo_LoadCalibration();
+
+	// Clear the event trigger flags
+	g_ucEventTrigger = 0;
+
+	//Run core
+	vCORE_Run();
+}
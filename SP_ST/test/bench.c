@@ -0,0 +1,466 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file bench.c
+//! \brief Host microbenchmarks of the hot paths
+//!
+//! Usage: sp_bench [limits].  Three kinds of figures come out:
+//!   - ns: host time per call of the code alone, the poll hook off.  Good to
+//!     compare two versions on one machine, not a figure for the MSP430.
+//!   - sim_us: simulated time the SP waits on the hardware for a job, from
+//!     the device model.  It does not depend on the machine.
+//!   - bits: SCL clocks on the bus, from the CP bus master of cp_sim.c.
+//!
+//! The link figures come from the firmware run from reset against the CP
+//! in a child process, as it cannot be run again once the other figures
+//! have been taken.
+//!
+//! With a limits file, of lines "name max", the run fails when a figure is
+//! over its limit.  The cycle counts of the target are measured on the
+//! instruction set simulator by bench_iss.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "hal.h"
+#include "core.h"
+#include "Thermo.h"
+#include "Burst.h"
+#include "sim.h"
+#include "board.h"
+#include "cp_sim.h"
+#include "check.h"
+
+//! \def BENCH_MAX
+//! \brief The most figures of a run
+#define BENCH_MAX			16
+
+//! \def BENCH_READINGS
+//! \brief Channels read by a reading cycle of the link figures
+#define BENCH_READINGS		4
+
+//! \def BENCH_BATCH_NS
+//! \brief The shortest batch of calls that is timed
+#define BENCH_BATCH_NS		20000000.0
+
+//! \struct BENCH_RESULT
+typedef struct {
+	const char * pcName;
+	const char * pcUnit;
+	double dValue;
+} BENCH_RESULT;
+
+static BENCH_RESULT s_saBench_Result[BENCH_MAX];
+static unsigned int s_uiBench_Count;
+
+static uint8 s_ucaBench_Msg[MAXMSGLEN];
+
+//! Keeps the results alive so the calls are not optimized away
+volatile unsigned int g_uiBench_Sink;
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Records a figure
+//!   \param pcName, pcUnit, dValue The figure
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vBench_Record(const char * pcName, const char * pcUnit, double dValue)
+{
+	if (s_uiBench_Count == BENCH_MAX)
+		return;
+
+	s_saBench_Result[s_uiBench_Count].pcName = pcName;
+	s_saBench_Result[s_uiBench_Count].pcUnit = pcUnit;
+	s_saBench_Result[s_uiBench_Count].dValue = dValue;
+	s_uiBench_Count++;
+}
+
+static double dBench_Now(void)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return sTime.tv_sec * 1e9 + sTime.tv_nsec;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Times a job, the best of five batches
+//!   \param pcName The figure; pfnJob The job
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vBench_Time(const char * pcName, void (*pfnJob)(void))
+{
+	unsigned long ulCalls;
+	unsigned long ulIdx;
+	unsigned char ucBatch;
+	double dStart;
+	double dSpent;
+	double dBest;
+
+	// Grow the batch until it is long enough to time
+	ulCalls = 1;
+	for (;;)
+	{
+		dStart = dBench_Now();
+		for (ulIdx = 0; ulIdx < ulCalls; ulIdx++)
+			pfnJob();
+		dSpent = dBench_Now() - dStart;
+
+		if (dSpent >= BENCH_BATCH_NS)
+			break;
+
+		ulCalls <<= 1;
+	}
+
+	dBest = dSpent;
+	for (ucBatch = 0; ucBatch < 4; ucBatch++)
+	{
+		dStart = dBench_Now();
+		for (ulIdx = 0; ulIdx < ulCalls; ulIdx++)
+			pfnJob();
+		dSpent = dBench_Now() - dStart;
+
+		if (dSpent < dBest)
+			dBest = dSpent;
+	}
+
+	vBench_Record(pcName, "ns", dBest / ulCalls);
+}
+
+//! @name Jobs
+//! @{
+static void vBench_Crc(void)
+{
+	g_uiBench_Sink += ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_SEND, s_ucaBench_Msg, MAXMSGLEN);
+}
+
+static void vBench_FetchData(void)
+{
+	g_uiBench_Sink += ucMain_FetchData(s_ucaBench_Msg);
+}
+
+static void vBench_FetchPacked(void)
+{
+	g_uiBench_Sink += ucMain_FetchPackedData(s_ucaBench_Msg);
+}
+
+static void vBench_Dispatch(void)
+{
+	g_uiBench_Sink += uiMainDispatch(0, 0, 0);
+}
+
+//! A sequence of samples through the ADC12 ISR, as uiThermo_ReadChannel()
+//! takes them
+static void vBench_Average(void)
+{
+	unsigned char ucIdx;
+
+	for (ucIdx = 0; ucIdx < THERMO_SAMPLES; ucIdx++)
+	{
+		ADC12IE |= BIT0;
+		ADC12IV = ADC12IV_ADC12IFG0;
+		ADC12MEM0 = 1000 + ucIdx;
+		ADC_Conversion();
+	}
+}
+//! @}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Measures the simulated time of a dispatch
+//!   \param pcName The figure; ucTrans, ucParamLen, pucParam The command
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vBench_Simulated(const char * pcName, uint8 ucTrans, uint8 ucParamLen, uint8 * pucParam)
+{
+	unsigned long long ullStart;
+
+	ullStart = g_ullSIM_Now;
+	uiMainDispatch(ucTrans, ucParamLen, pucParam);
+
+	vBench_Record(pcName, "sim_us", (g_ullSIM_Now - ullStart) / 1000.0);
+}
+
+//! @name Link Figures
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Builds a frame
+//!   \param pucMsg The frame; ucType, ucVersion The header; ucReadings The
+//!   channels to read from 1 on, the test transducer if 0
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vBench_Frame(uint8 * pucMsg, uint8 ucType, uint8 ucVersion, uint8 ucReadings)
+{
+	uint8 ucIdx;
+
+	pucMsg[MSG_TYP_IDX] = ucType;
+	pucMsg[MSG_LEN_IDX] = SP_HEADERSIZE;
+	pucMsg[MSG_VER_IDX] = ucVersion;
+	pucMsg[MSG_FLAGS_IDX] = 0;
+
+	if (ucType != COMMAND_PKT && ucType != COMMAND_AND_REPORT)
+		return;
+
+	if (ucReadings == 0)
+	{
+		pucMsg[MSG_PAYLD_IDX] = 0;
+		pucMsg[MSG_PAYLD_IDX + 1] = 0;
+		pucMsg[MSG_LEN_IDX] += 2;
+	}
+
+	for (ucIdx = 0; ucIdx < ucReadings; ucIdx++)
+	{
+		pucMsg[MSG_PAYLD_IDX + 2 * ucIdx] = ucIdx + 1;
+		pucMsg[MSG_PAYLD_IDX + 2 * ucIdx + 1] = 0;
+		pucMsg[MSG_LEN_IDX] += 2;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Measures one transaction, from its start condition to the end of
+//! the reply
+//!   \param pcName The figure; ucType, ucVersion, ucReadings The frame
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vBench_Transaction(const char * pcName, uint8 ucType, uint8 ucVersion, uint8 ucReadings)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+	unsigned long long ullStart;
+
+	vBench_Frame(ucaTx, ucType, ucVersion, ucReadings);
+
+	vCP_WaitListening();
+	ullStart = g_ullSIM_Now;
+	if (ucCP_Transact(ucaTx, ucaRx) != CP_OK)
+		vSIM_Fail(pcName);
+
+	vBench_Record(pcName, "sim_us", (g_ullSIM_Now - ullStart) / 1000.0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Counts the clocks of a reading cycle of all channels
+//!   \param pcName The figure; ucVersion The report version
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vBench_Cycle(const char * pcName, uint8 ucVersion)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+	unsigned long ulClocks;
+
+	ulClocks = g_ulCP_Clocks;
+
+	if (g_ucCP_LinkMode & COMM_LINK_BURST)
+	{
+		vBench_Frame(ucaTx, COMMAND_AND_REPORT, ucVersion, BENCH_READINGS);
+		if (ucCP_Exchange(ucaTx, ucaRx) != CP_OK)
+			vSIM_Fail(pcName);
+	}
+	else
+	{
+		vBench_Frame(ucaTx, COMMAND_PKT, SP_DATAMESSAGE_VERSION, BENCH_READINGS);
+		if (ucCP_Exchange(ucaTx, ucaRx) != CP_OK)
+			vSIM_Fail(pcName);
+
+		vBench_Frame(ucaTx, REQUEST_DATA, ucVersion, 0);
+		if (ucCP_Exchange(ucaTx, ucaRx) != CP_OK)
+			vSIM_Fail(pcName);
+	}
+
+	vBench_Record(pcName, "bits", (double) (g_ulCP_Clocks - ulClocks) / BENCH_READINGS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The CP script of the link figures
+//!
+//! The latencies use the test transducer, which takes no time, so they are
+//! the time on the bus.
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vBench_LinkScript(void)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+	unsigned long long ullStart;
+
+	vCP_WaitListening();
+	if (ucCP_Transact(0, ucaRx) != CP_OK)
+		vSIM_Fail("ID packet");
+
+	vBench_Transaction("interrogate_sim", INTERROGATE, SP_DATAMESSAGE_VERSION, 0);
+	vBench_Transaction("command_confirm_sim", COMMAND_PKT, SP_DATAMESSAGE_VERSION, 0);
+	vBench_Transaction("request_report_sim", REQUEST_DATA, SP_DATAMESSAGE_VERSION, 0);
+
+	vBench_Cycle("bits_reading_v120", SP_DATAMESSAGE_VERSION);
+	vBench_Cycle("bits_reading_v121", SP_DATAMESSAGE_VERSION_PACKED);
+
+	// A bit flipped in a command costs an error report and a second try
+	vBench_Frame(ucaTx, COMMAND_PKT, SP_DATAMESSAGE_VERSION, 0);
+	g_ucCP_CorruptByte = MSG_PAYLD_IDX;
+	vCP_WaitListening();
+	ullStart = g_ullSIM_Now;
+	if (ucCP_Exchange(ucaTx, ucaRx) != CP_OK || ucaRx[MSG_TYP_IDX] != CONFIRM_COMMAND)
+		vSIM_Fail("line error");
+	vBench_Record("line_error_sim", "sim_us", (g_ullSIM_Now - ullStart) / 1000.0);
+
+	if (ucCP_SetLinkMode(COMM_LINK_BURST | COMM_LINK_READY_LINE) != CP_OK)
+		vSIM_Fail("link mode");
+
+	vBench_Transaction("command_report_burst_sim", COMMAND_AND_REPORT, SP_DATAMESSAGE_VERSION, 0);
+	vBench_Cycle("bits_reading_burst", SP_DATAMESSAGE_VERSION_PACKED);
+}
+//! @}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Compares the figures with a limits file
+//!   \param pcFile The file
+//!   \return The number of figures over their limit, or 1 if the file is
+//!   unreadable
+///////////////////////////////////////////////////////////////////////////////
+static unsigned int uiBench_Check(const char * pcFile)
+{
+	FILE * psFile;
+	char caLine[128];
+	char caName[64];
+	double dLimit;
+	unsigned int uiIdx;
+	unsigned int uiOver;
+
+	psFile = fopen(pcFile, "r");
+	if (!psFile)
+	{
+		perror(pcFile);
+		return 1;
+	}
+
+	uiOver = 0;
+
+	while (fgets(caLine, sizeof(caLine), psFile))
+	{
+		if (caLine[0] == '#' || sscanf(caLine, "%63s %lf", caName, &dLimit) != 2)
+			continue;
+
+		for (uiIdx = 0; uiIdx < s_uiBench_Count; uiIdx++)
+		{
+			if (strcmp(caName, s_saBench_Result[uiIdx].pcName) != 0)
+				continue;
+
+			if (s_saBench_Result[uiIdx].dValue > dLimit)
+			{
+				printf("over limit: %s %.1f > %.1f\n", caName, s_saBench_Result[uiIdx].dValue, dLimit);
+				uiOver++;
+			}
+		}
+	}
+
+	fclose(psFile);
+
+	return uiOver;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Prints the figures and compares them with the limits
+//!   \param pcLimits The limits file, or 0
+//!   \return The number of figures over their limit
+///////////////////////////////////////////////////////////////////////////////
+static unsigned int uiBench_Report(const char * pcLimits)
+{
+	unsigned int uiIdx;
+
+	for (uiIdx = 0; uiIdx < s_uiBench_Count; uiIdx++)
+		printf("%-26s %12.1f %s\n", s_saBench_Result[uiIdx].pcName, s_saBench_Result[uiIdx].dValue, s_saBench_Result[uiIdx].pcUnit);
+
+	fflush(stdout);
+
+	return pcLimits ? uiBench_Check(pcLimits) : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Takes the link figures in a child process
+//!   \param pcLimits The limits file, or 0
+//!   \return 0 if the figures are within their limits
+///////////////////////////////////////////////////////////////////////////////
+static int iBench_Link(const char * pcLimits)
+{
+	pid_t iPid;
+	int iStatus;
+
+	fflush(stdout);
+
+	iPid = fork();
+	if (iPid < 0)
+	{
+		perror("fork");
+		return 1;
+	}
+
+	if (iPid == 0)
+	{
+		vSIM_Reset();
+		vBOARD_Init();
+		vCP_Run(vBench_LinkScript);
+		_exit(uiBench_Report(pcLimits) ? 1 : 0);
+	}
+
+	if (waitpid(iPid, &iStatus, 0) < 0)
+		return 1;
+
+	return !(WIFEXITED(iStatus) && WEXITSTATUS(iStatus) == 0);
+}
+
+int main(int iArgc, char ** ppcArgv)
+{
+	uint8 ucaParam[4];
+	const char * pcLimits;
+	int iFailed;
+
+	pcLimits = (iArgc > 1) ? ppcArgv[1] : 0;
+
+	iFailed = iBench_Link(pcLimits);
+
+	vSIM_Reset();
+	vBOARD_Init();
+	vCORE_Initilize();
+	vMain_CleanDataStruct();
+	vThermo_LoadCalibration();
+
+	// The first read of a channel probes it and takes the zero path
+	vBench_Simulated("read_first_sim", 1, 0, 0);
+	ucaParam[0] = THERMO_FILTER_TRIMMED;
+	vBench_Simulated("read_trimmed_sim", 2, 1, ucaParam);
+
+	ucaParam[0] = THERMO_FILTER_TRIMMED | THERMO_FILTER_EXTENDED;
+	ucaParam[1] = THERMO_MAINS_50HZ;
+	vBench_Simulated("read_mains_sim", 3, 2, ucaParam);
+
+	ucaParam[0] = BURST_OP_CAPTURE;
+	ucaParam[1] = 4;
+	ucaParam[2] = BURST_MIN_INTERVAL >> 8;
+	ucaParam[3] = BURST_MIN_INTERVAL & 0xFF;
+	vBench_Simulated("burst_sim", 0, 4, ucaParam);
+
+	uiMainDispatch(4, 0, 0);
+
+	// The code alone from here
+	g_pfnHOST_Poll = 0;
+
+	memset(s_ucaBench_Msg, 0x5A, sizeof(s_ucaBench_Msg));
+	vBench_Time("crc_64", vBench_Crc);
+	vBench_Time("fetch_data", vBench_FetchData);
+	vBench_Time("fetch_packed", vBench_FetchPacked);
+	vBench_Time("dispatch_test", vBench_Dispatch);
+	vBench_Time("average_seq", vBench_Average);
+
+	if (uiBench_Report(pcLimits))
+		iFailed = 1;
+
+	return iFailed;
+}
+
+//! @}
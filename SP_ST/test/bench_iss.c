@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file bench_iss.c
+//! \brief Cycle counts of the hot paths on the MSP430 instruction set
+//!
+//! Built with msp430-elf-gcc and HAL_ISS, and run on the simulator of
+//! mspdebug by bench_iss.py (make bench-iss).  Each job is timed with
+//! Timer_A on SMCLK, which the simulator clocks with MCLK, and the cost of
+//! the timing itself is taken off.  The counts are left in the g_uiISS_
+//! variables, which the runner reads once vISS_Done() is reached.
+//!
+//! The simulator has no CP or ADC.  The bus waits of HAL_ISS pass at once,
+//! so the comm figures are the SP's own work between the edges, and the
+//! ADC12 ISR is entered with a sample already in ADC12MEM0.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "Thermo.h"
+#include "check.h"
+
+//! \def ISS_CLOCKS_PER_BYTE
+//! \brief The SCL clocks of a standard byte, 8 data bits, parity and ack
+#define ISS_CLOCKS_PER_BYTE	10
+
+//! \def ISS_START
+//! \brief Clears Timer_A and starts it in continuous mode on SMCLK
+#define ISS_START()			TACTL = TASSEL_2 | MC_2 | TACLR
+
+//! \def ISS_CYCLES
+//! \brief The cycles since ISS_START, less the cost of the timing
+#define ISS_CYCLES()		(TAR - s_uiISS_Overhead)
+
+//! \def ISS_CALL_ISR
+//! \brief Enters an interrupt service routine as the hardware does, with the
+//! return address and SR on the stack, so its reti comes back here
+#define ISS_CALL_ISR(name)	__asm__ __volatile__ ("push #1f\n\tpush r2\n\tbr #" #name "\n1:" ::: "memory")
+
+//! @name Figures
+//! Read by bench_iss.py from the symbol table, one unsigned int each.
+//! @{
+volatile unsigned int g_uiISS_SendBit;
+volatile unsigned int g_uiISS_ReceiveByte;
+volatile unsigned int g_uiISS_Crc64;
+volatile unsigned int g_uiISS_AverageSeq;
+volatile unsigned int g_uiISS_FetchData;
+volatile unsigned int g_uiISS_DispatchTest;
+//! @}
+
+//! Keeps the results alive so the calls are not optimized away
+volatile unsigned int g_uiISS_Sink;
+
+static unsigned int s_uiISS_Overhead;
+
+static uint8 s_ucaISS_Msg[MAXMSGLEN];
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Marks the end of the run, the runner breaks here
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void __attribute__((noinline)) vISS_Done(void)
+{
+	__asm__ __volatile__ ("nop");
+}
+
+int main(void)
+{
+	unsigned char ucIdx;
+
+	WDTCTL = WDTPW | WDTHOLD;
+
+	for (ucIdx = 0; ucIdx < MAXMSGLEN; ucIdx++)
+		s_ucaISS_Msg[ucIdx] = 0x5A;
+
+	vMain_CleanDataStruct();
+
+	// The cost of starting and reading the timer
+	ISS_START();
+	s_uiISS_Overhead = TAR;
+
+	// A byte with both levels on SDA, timed over its 10 clocks
+	ISS_START();
+	g_uiISS_Sink += ucCOMM_SendByte(0xA5);
+	g_uiISS_SendBit = ISS_CYCLES() / ISS_CLOCKS_PER_BYTE;
+
+	// A payload byte, past the header that is vetted
+	g_ucRXBufferIndex = SP_HEADERSIZE;
+	ISS_START();
+	g_uiISS_Sink += ucCOMM_ReceiveByte();
+	g_uiISS_ReceiveByte = ISS_CYCLES();
+
+	ISS_START();
+	g_uiISS_Sink += ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_SEND, s_ucaISS_Msg, MAXMSGLEN);
+	g_uiISS_Crc64 = ISS_CYCLES();
+
+	// A sequence of samples through the ADC12 ISR, as uiThermo_ReadChannel()
+	// takes them
+	ISS_START();
+	for (ucIdx = 0; ucIdx < THERMO_SAMPLES; ucIdx++)
+	{
+		ADC12IE |= BIT0;
+		ADC12IV = ADC12IV_ADC12IFG0;
+		ADC12MEM0 = 1000 + ucIdx;
+		ISS_CALL_ISR(ADC_Conversion);
+	}
+	g_uiISS_AverageSeq = ISS_CYCLES();
+
+	ISS_START();
+	g_uiISS_Sink += ucMain_FetchData(s_ucaISS_Msg);
+	g_uiISS_FetchData = ISS_CYCLES();
+
+	// The test transducer, through the switch on the transducer number
+	ISS_START();
+	g_uiISS_Sink += uiMainDispatch(0, 0, 0);
+	g_uiISS_DispatchTest = ISS_CYCLES();
+
+	TACTL = 0;
+
+	vISS_Done();
+
+	for (;;)
+		;
+}
+
+//! @}
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+###############################################################################
+# Runs bench_iss on the mspdebug simulator and checks the figures
+#
+# Usage: bench_iss.py [--nm NM] [--mspdebug MSPDEBUG] [--update] ELF OBJDIR LIMITS
+#
+# For each figure it reports the cycles of the job from the g_uiISS_
+# variables of the ELF, and the code size and frame of the function it
+# times, from the symbol table and the .su files that -fstack-usage left
+# under OBJDIR.  The frame is that of the function alone, not of the calls
+# it makes.
+#
+# LIMITS has lines "name cycles size stack".  The run fails when a figure
+# is over one of its limits.  --update writes the figures of this run with
+# 10% of headroom instead.  Without a LIMITS file the figures are only
+# reported, there is no baseline until the first --update.
+###############################################################################
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# figure, cycle variable, function timed
+FIGURES = (
+    ("send_bit",      "g_uiISS_SendBit",      "ucCOMM_SendByte"),
+    ("receive_byte",  "g_uiISS_ReceiveByte",  "ucCOMM_ReceiveByte"),
+    ("crc_64",        "g_uiISS_Crc64",        "ucCRC16_compute_msg_CRC"),
+    ("average_seq",   "g_uiISS_AverageSeq",   "ADC_Conversion"),
+    ("fetch_data",    "g_uiISS_FetchData",    "ucMain_FetchData"),
+    ("dispatch_test", "g_uiISS_DispatchTest", "uiMainDispatch"),
+)
+
+DONE = "vISS_Done"
+
+LIMITS_HEADER = """\
+# Limits of bench_iss, one "name cycles bytes stack" a line.
+#
+# cycles are MCLK cycles of the job on the simulator, bytes the code size
+# and stack the frame of the function it times.  All three repeat exactly
+# for one compiler version.  Written by make bench-iss-update, run it again
+# after a change of compiler or to take a new baseline.
+"""
+
+
+def read_symbols(nm, elf):
+    """Returns the address and size of every defined symbol"""
+    out = subprocess.run([nm, "-S", "--defined-only", elf], check=True,
+                         capture_output=True, text=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 4:
+            symbols[fields[3]] = (int(fields[0], 16), int(fields[1], 16))
+        elif len(fields) == 3:
+            symbols[fields[2]] = (int(fields[0], 16), 0)
+    return symbols
+
+
+def read_frames(objdir):
+    """Returns the frame of every function of the .su files"""
+    frames = {}
+    for root, _, files in os.walk(objdir):
+        for name in files:
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(root, name)) as su:
+                for line in su:
+                    fields = line.rstrip("\n").split("\t")
+                    if len(fields) < 2:
+                        continue
+                    function = fields[0].rsplit(":", 1)[-1]
+                    frames[function] = int(fields[1])
+    return frames
+
+
+def run_iss(mspdebug, elf, addresses):
+    """Runs the ELF up to DONE and returns the words at the addresses"""
+    cmds = ["simio add timer tmr", "prog " + elf, "setbreak " + DONE, "run"]
+    cmds += ["md 0x%04x 2" % addr for addr in addresses]
+    out = subprocess.run([mspdebug, "-q", "sim"] + cmds, check=True,
+                         capture_output=True, text=True, timeout=60).stdout
+
+    memory = {}
+    for match in re.finditer(r"^\s*(?:0x)?([0-9a-fA-F]+):((?:\s[0-9a-fA-F]{2})+)", out, re.M):
+        base = int(match.group(1), 16)
+        for offset, byte in enumerate(match.group(2).split()):
+            memory[base + offset] = int(byte, 16)
+
+    words = []
+    for addr in addresses:
+        if addr not in memory or addr + 1 not in memory:
+            sys.exit("bench_iss: no figure at 0x%04x, did the run reach %s?" % (addr, DONE))
+        words.append(memory[addr] | (memory[addr + 1] << 8))
+    return words
+
+
+def read_limits(path):
+    limits = {}
+    with open(path) as lim:
+        for line in lim:
+            fields = line.split("#", 1)[0].split()
+            if len(fields) == 4:
+                limits[fields[0]] = [int(field) for field in fields[1:]]
+    return limits
+
+
+def write_limits(path, results):
+    header = [LIMITS_HEADER]
+    if os.path.exists(path):
+        with open(path) as lim:
+            header = [line for line in lim if line.startswith("#")]
+    with open(path, "w") as lim:
+        lim.writelines(header)
+        for name, values in results:
+            lim.write("%-16s%s\n" % (name, "\t".join(str(v + (v + 9) // 10) for v in values)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Cycle benchmarks on the mspdebug simulator")
+    parser.add_argument("--nm", default="msp430-elf-nm")
+    parser.add_argument("--mspdebug", default="mspdebug")
+    parser.add_argument("--update", action="store_true")
+    parser.add_argument("elf")
+    parser.add_argument("objdir")
+    parser.add_argument("limits")
+    args = parser.parse_args()
+
+    symbols = read_symbols(args.nm, args.elf)
+    frames = read_frames(args.objdir)
+
+    for name in [DONE] + [fig[1] for fig in FIGURES] + [fig[2] for fig in FIGURES]:
+        if name not in symbols:
+            sys.exit("bench_iss: %s is not in %s" % (name, args.elf))
+
+    cycles = run_iss(args.mspdebug, args.elf, [symbols[fig[1]][0] for fig in FIGURES])
+
+    results = []
+    print("%-16s %8s %8s %8s" % ("", "cycles", "bytes", "stack"))
+    for (name, _, function), count in zip(FIGURES, cycles):
+        values = [count, symbols[function][1], frames.get(function, 0)]
+        results.append((name, values))
+        print("%-16s %8d %8d %8d" % (name, values[0], values[1], values[2]))
+
+    if args.update:
+        write_limits(args.limits, results)
+        return 0
+
+    if not os.path.exists(args.limits):
+        print("no %s, run make bench-iss-update to take a baseline" % args.limits)
+        return 0
+
+    limits = read_limits(args.limits)
+    failed = 0
+    for name, values in results:
+        if name not in limits:
+            print("%s: no limit" % name)
+            failed += 1
+            continue
+        for what, value, limit in zip(("cycles", "bytes", "stack"), values, limits[name]):
+            if value > limit:
+                print("%s: %d %s over the limit of %d" % (name, value, what, limit))
+                failed += 1
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file board.c
+//! \brief The analog front end of the SP-ST board, as the ADC12 sees it
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "Thermo.h"
+#include "sim.h"
+#include "board.h"
+
+unsigned int g_uiaBOARD_Channel[5];
+unsigned int g_uiBOARD_Thermistor;
+unsigned int g_uiBOARD_Supply;
+unsigned int g_uiBOARD_RefHigh;
+unsigned int g_uiBOARD_RefLow;
+unsigned int (*g_pfnBOARD_Wave)(unsigned char ucChannel, unsigned long ulSample, unsigned long long ullNs);
+
+static const unsigned char s_ucaBOARD_Enable[4] = {CH1_ENABLE_BIT, CH2_ENABLE_BIT, CH3_ENABLE_BIT, CH4_ENABLE_BIT};
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the channel that reaches A3
+//!   \param none
+//!   \return The channel 1 to 4, 0 for the zero path
+///////////////////////////////////////////////////////////////////////////////
+unsigned char ucBOARD_Channel(void)
+{
+	unsigned char ucIdx;
+
+	for (ucIdx = 0; ucIdx < 4; ucIdx++)
+	{
+		if ((EN_CH & s_ucaBOARD_Enable[ucIdx]) == 0)
+			return ucIdx + 1;
+	}
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The ADC12 input of the model
+//!   \param ucInch The input channel
+//!   \return The level in ticks
+///////////////////////////////////////////////////////////////////////////////
+static unsigned int uiBOARD_Adc(unsigned char ucInch)
+{
+	unsigned char ucChannel;
+
+	switch (ucInch)
+	{
+		case INCH_3:
+			ucChannel = ucBOARD_Channel();
+
+			if (g_pfnBOARD_Wave)
+				return g_pfnBOARD_Wave(ucChannel, g_ulSIM_AdcConversions, g_ullSIM_Now);
+
+			return g_uiaBOARD_Channel[ucChannel];
+
+		case INCH_7:
+			return g_uiBOARD_Thermistor;
+
+		case INCH_8:
+			return g_uiBOARD_RefHigh;
+
+		case INCH_9:
+			return g_uiBOARD_RefLow;
+
+		case INCH_11:
+			return g_uiBOARD_Supply;
+
+		default:
+			return 0x0800;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Connects every channel near mid scale and the board to the ADC12
+//!
+//! The thermistor reads 25 degrees C, the supply 3.0 V and the references
+//! full scale and 0.
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vBOARD_Init(void)
+{
+	unsigned char ucIdx;
+
+	g_uiaBOARD_Channel[0] = 0x0100;
+	for (ucIdx = 1; ucIdx < 5; ucIdx++)
+		g_uiaBOARD_Channel[ucIdx] = 0x0300 * ucIdx + ucIdx;
+
+	g_uiBOARD_Thermistor = 2048;
+	g_uiBOARD_Supply = 2460;
+	g_uiBOARD_RefHigh = 4095;
+	g_uiBOARD_RefLow = 0;
+	g_pfnBOARD_Wave = 0;
+
+	g_pfnSIM_Adc = uiBOARD_Adc;
+}
+
+//! @}
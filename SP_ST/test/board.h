@@ -0,0 +1,36 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file board.h
+//! \brief The analog front end of the SP-ST board, as the ADC12 sees it
+//!
+//! A thermocouple channel reaches A3 while its EN_CH pin is low, the zero
+//! path otherwise.  The thermistor is on A7 and the supply divider on A11.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOARD_H_
+#define BOARD_H_
+
+//! @name Board Inputs
+//! In ADC ticks.  Index 0 of the channels is the zero path.
+//! @{
+extern unsigned int g_uiaBOARD_Channel[5];
+extern unsigned int g_uiBOARD_Thermistor;
+extern unsigned int g_uiBOARD_Supply;
+//! VeREF+ and VeREF- as the ADC12 converts them against themselves
+extern unsigned int g_uiBOARD_RefHigh;
+extern unsigned int g_uiBOARD_RefLow;
+
+//! Overrides the level of a channel, given the sample count and the time
+extern unsigned int (*g_pfnBOARD_Wave)(unsigned char ucChannel, unsigned long ulSample, unsigned long long ullNs);
+//! @}
+
+//! @name Board Functions
+//! @{
+void vBOARD_Init(void);
+unsigned char ucBOARD_Channel(void);
+//! @}
+
+#endif /*BOARD_H_*/
+//! @}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file check.h
+//! \brief Checks and the test list of the host tests
+//!
+//! Every test runs in a process of its own on a freshly reset device, so
+//! the firmware globals start at their initial values.  A failed check
+//! reports and the test goes on; the test fails if any check did.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CHECK_H_
+#define CHECK_H_
+
+//! @name Checks
+//! @{
+//! \def CHECK
+//! \brief Fails the test unless the condition holds
+#define CHECK(cond)					vCHECK_True((cond) != 0, #cond, __FILE__, __LINE__)
+//! \def CHECK_EQUAL
+//! \brief Fails the test unless the value is the expected one
+#define CHECK_EQUAL(exp, val)		vCHECK_Equal((long) (exp), (long) (val), #val, __FILE__, __LINE__)
+//! \def CHECK_NEAR
+//! \brief Fails the test unless the value is within a tolerance of the
+//! expected one
+#define CHECK_NEAR(exp, val, tol)	vCHECK_Near((long) (exp), (long) (val), (long) (tol), #val, __FILE__, __LINE__)
+
+void vCHECK_True(int iPass, const char * pcWhat, const char * pcFile, int iLine);
+void vCHECK_Equal(long lExp, long lVal, const char * pcWhat, const char * pcFile, int iLine);
+void vCHECK_Near(long lExp, long lVal, long lTol, const char * pcWhat, const char * pcFile, int iLine);
+//! @}
+
+//! @name Firmware Symbols Without a Header
+//! main.c and the ISRs have no header of their own.
+//! @{
+void vMain_CalibrateVLO(void);
+void vMain_CleanDataStruct(void);
+void ADC_Conversion(void);
+extern signed int g_iVLOCal;
+extern unsigned char guc_ADCInitialized;
+extern volatile unsigned char g_ucRXBufferIndex;
+//! @}
+
+//! @name Tests
+//! Each group lives in the test_ file of its module.
+//! @{
+void vTest_CrcReference(void);
+void vTest_CrcDetectsFlips(void);
+void vTest_FlashChannelRecord(void);
+void vTest_FlashTornRecord(void);
+void vTest_FlashKeepsHid(void);
+void vTest_ClockToMillis(void);
+void vTest_ClockCountsAclk(void);
+void vTest_ClockCalibrateVlo(void);
+void vTest_ClockSyncCalibrates(void);
+void vTest_ConvertThermistor(void);
+void vTest_ConvertThermocouple(void);
+void vTest_ThermoTrimsSpike(void);
+void vTest_ThermoMeanFilter(void);
+void vTest_ThermoMainsSync(void);
+void vTest_ReportPacked(void);
+void vTest_ReportDispatch(void);
+void vTest_ReportRatiometric(void);
+void vTest_BurstTrigger(void);
+void vTest_BurstBound(void);
+void vTest_BurstShortTimeout(void);
+void vTest_BurstRejects(void);
+void vTest_LinkCommandReport(void);
+void vTest_LinkLineError(void);
+void vTest_LinkNackRetry(void);
+void vTest_LinkTxAbort(void);
+void vTest_LinkBurst(void);
+void vTest_LinkIrqTx(void);
+void vTest_LinkTimeSync(void);
+//! @}
+
+#endif /*CHECK_H_*/
+//! @}
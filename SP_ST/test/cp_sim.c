@@ -0,0 +1,611 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file cp_sim.c
+//! \brief A CP bus master for the device model
+//!
+//! Three contexts take turns.  vCP_Run() starts the CP script, which runs
+//! until it waits on the bus.  A wait sets the due time of the bus hook and
+//! switches to the firmware, which runs until the model reaches that time
+//! and calls the hook, which switches back to the CP.  The firmware is left
+//! where it was once the script returns.
+//!
+//! Each clock is a low time, a rising edge on which the CP samples SDA, a
+//! high time and a falling edge.  The CP changes SDA right after a falling
+//! edge, as the SP does.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ucontext.h>
+
+#include "hal.h"
+#include "core.h"
+#include "comm.h"
+#include "crc.h"
+#include "sim.h"
+#include "cp_sim.h"
+
+//! \def CP_STACK_BYTES
+//! \brief Stack of the firmware and of the CP script
+#define CP_STACK_BYTES		(1024 * 1024)
+
+//! \def CP_POLL_NS
+//! \brief How often the CP looks at a line it waits on
+#define CP_POLL_NS			1000ULL
+
+//! \def CP_ERRORS
+//! \brief Nacks of a frame before it is given up, as in vCOMM_SendFrame()
+#define CP_ERRORS			5
+
+//! \def CP_TRIES
+//! \brief Transactions ucCP_Exchange() tries
+#define CP_TRIES			3
+
+//! The entry point of the firmware, main() renamed
+void vSP_Main(void);
+
+unsigned long g_ulCP_HalfNs;
+unsigned long g_ulCP_AckLowNs;
+unsigned long g_ulCP_IrqHalfNs;
+unsigned long g_ulCP_IrqAckLowNs;
+
+unsigned char g_ucCP_CorruptByte;
+unsigned char g_ucCP_Nacks;
+
+unsigned long g_ulCP_Clocks;
+unsigned long g_ulCP_NacksSeen;
+unsigned char g_ucCP_LinkMode;
+
+//! @name Contexts
+//! @{
+static ucontext_t s_sCP_Main;
+static ucontext_t s_sCP_Sp;
+static ucontext_t s_sCP_Cp;
+static unsigned char s_ucaCP_SpStack[CP_STACK_BYTES];
+static unsigned char s_ucaCP_CpStack[CP_STACK_BYTES];
+static void (*s_pfnCP_Script)(void);
+//! @}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The bus hook, hands the time over to the CP
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vCP_Bus(void)
+{
+	swapcontext(&s_sCP_Sp, &s_sCP_Cp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Runs the firmware until the model reaches a time
+//!   \param ullNs The time from now
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vCP_Wait(unsigned long long ullNs)
+{
+	g_ullSIM_BusDue = g_ullSIM_Now + ullNs;
+	swapcontext(&s_sCP_Cp, &s_sCP_Sp);
+}
+
+//! @name Lines
+//! A line is the wired AND of the CP drive and the port of the SP.
+//! @{
+static void vCP_Scl(unsigned char ucHigh)
+{
+	if (ucHigh)
+		g_ucSIM_P2Ext |= SCL_PIN;
+	else
+		g_ucSIM_P2Ext &= ~SCL_PIN;
+}
+
+static void vCP_Sda(unsigned char ucHigh)
+{
+	if (ucHigh)
+		g_ucSIM_P1Ext |= SDA_PIN;
+	else
+		g_ucSIM_P1Ext &= ~SDA_PIN;
+}
+
+static unsigned char ucCP_SdaLine(void)
+{
+	return g_ucSIM_P1Ext & (unsigned char) (~P_SDA_DIR | P_SDA_OUT) & SDA_PIN;
+}
+
+static unsigned char ucCP_SpReady(void)
+{
+	return !(g_ucSIM_P2Ext & (unsigned char) (~P_INT_DIR | P_INT_OUT) & INT_PIN);
+}
+
+//! The SP sleeps with the start condition interrupt on
+static unsigned char ucCP_SpListening(void)
+{
+	return (P_SDA_IE & SDA_PIN) != 0;
+}
+
+//! The SP has the first bit of its frame on SDA
+static unsigned char ucCP_SpSending(void)
+{
+	return (P_SDA_DIR & SDA_PIN) != 0;
+}
+//! @}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Waits until a condition of the lines or the SP holds
+//!   \param pfnHolds The condition
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vCP_WaitFor(unsigned char (*pfnHolds)(void))
+{
+	while (!pfnHolds())
+		vCP_Wait(CP_POLL_NS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Gives one clock
+//!   \param ulLowNs The low time before the rising edge
+//!   \param ulHighNs The high time
+//!   \return SDA as sampled on the rising edge
+///////////////////////////////////////////////////////////////////////////////
+static unsigned char ucCP_Clock(unsigned long ulLowNs, unsigned long ulHighNs)
+{
+	unsigned char ucSda;
+
+	vCP_Wait(ulLowNs);
+	vCP_Scl(1);
+	g_ulCP_Clocks++;
+
+	ucSda = ucCP_SdaLine();
+
+	vCP_Wait(ulHighNs);
+	vCP_Scl(0);
+
+	return ucSda;
+}
+
+static unsigned char ucCP_Parity(unsigned char ucByte)
+{
+	ucByte ^= ucByte >> 4;
+	ucByte ^= ucByte >> 2;
+	ucByte ^= ucByte >> 1;
+
+	return ucByte & 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Clocks the data bits of a byte out, LSB first
+//!   \param ucWire The byte as it goes on the wire
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vCP_WriteBits(unsigned char ucWire)
+{
+	unsigned char ucBit;
+
+	for (ucBit = 0; ucBit < 8; ucBit++)
+	{
+		vCP_Sda((ucWire >> ucBit) & 1);
+		ucCP_Clock(g_ulCP_HalfNs, g_ulCP_HalfNs);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Clocks the data bits of a byte in, LSB first
+//!   \param ulHalfNs Half of the clock period
+//!   \return The byte
+///////////////////////////////////////////////////////////////////////////////
+static unsigned char ucCP_ReadBits(unsigned long ulHalfNs)
+{
+	unsigned char ucBit;
+	unsigned char ucByte;
+
+	ucByte = 0;
+	for (ucBit = 0; ucBit < 8; ucBit++)
+	{
+		if (ucCP_Clock(ulHalfNs, ulHalfNs))
+			ucByte |= 1 << ucBit;
+	}
+
+	return ucByte;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sends a frame in the standard mode
+//!
+//! With COMM_LINK_HEADER_NACK a nack of a header byte means the SP refused
+//! the frame, the CP stops.  Any other nack is a parity error, the SP keeps
+//! the byte and the CRC of the frame decides, so the CP goes on as a legacy
+//! CP does.
+//!   \param pucFrame, ucLength The frame with its CRC
+//!   \return CP_OK or CP_REFUSED
+///////////////////////////////////////////////////////////////////////////////
+static unsigned char ucCP_WriteFrame(const unsigned char * pucFrame, unsigned char ucLength)
+{
+	unsigned char ucIdx;
+	unsigned char ucWire;
+
+	for (ucIdx = 0; ucIdx < ucLength; ucIdx++)
+	{
+		ucWire = pucFrame[ucIdx];
+		if (ucIdx == g_ucCP_CorruptByte)
+			ucWire ^= BIT0;
+
+		vCP_WriteBits(ucWire);
+
+		vCP_Sda(ucCP_Parity(pucFrame[ucIdx]));
+		ucCP_Clock(g_ulCP_HalfNs, g_ulCP_HalfNs);
+
+		// Released for the ack of the SP
+		vCP_Sda(1);
+		if (ucCP_Clock(g_ulCP_AckLowNs, g_ulCP_HalfNs))
+		{
+			g_ulCP_NacksSeen++;
+
+			if (ucIdx < SP_HEADERSIZE && (g_ucCP_LinkMode & COMM_LINK_HEADER_NACK))
+				return CP_REFUSED;
+		}
+	}
+
+	return CP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Sends a frame in the burst mode
+//!   \param pucFrame, ucLength The frame with its CRC
+//!   \return CP_OK or CP_REFUSED if the SP nacked the frame
+///////////////////////////////////////////////////////////////////////////////
+static unsigned char ucCP_WriteBurst(const unsigned char * pucFrame, unsigned char ucLength)
+{
+	unsigned char ucIdx;
+	unsigned char ucWire;
+
+	for (ucIdx = 0; ucIdx < ucLength; ucIdx++)
+	{
+		ucWire = pucFrame[ucIdx];
+		if (ucIdx == g_ucCP_CorruptByte)
+			ucWire ^= BIT0;
+
+		vCP_WriteBits(ucWire);
+	}
+
+	vCP_Sda(1);
+	if (ucCP_Clock(COMM_BURST_ACK_GAP_US(ucLength) * 1000UL, g_ulCP_HalfNs))
+	{
+		g_ulCP_NacksSeen++;
+		return CP_REFUSED;
+	}
+
+	return CP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Tells whether the CP nacks the next SP byte on purpose
+//!   \param none
+//!   \return Nonzero to nack
+///////////////////////////////////////////////////////////////////////////////
+static unsigned char ucCP_InjectNack(void)
+{
+	if (!g_ucCP_Nacks)
+		return 0;
+
+	g_ucCP_Nacks--;
+	return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Receives a frame in the standard mode
+//!
+//! A nacked byte comes again.  The CP gives up after CP_ERRORS nacks, as
+//! the SP does.
+//!   \param pucFrame The frame
+//!   \param ulHalfNs, ulAckLowNs The clock
+//!   \return CP_OK, CP_BAD_REPLY or CP_ABORTED
+///////////////////////////////////////////////////////////////////////////////
+static unsigned char ucCP_ReadFrame(unsigned char * pucFrame, unsigned long ulHalfNs, unsigned long ulAckLowNs)
+{
+	unsigned char ucIdx;
+	unsigned char ucLength;
+	unsigned char ucByte;
+	unsigned char ucNack;
+	unsigned char ucErrors;
+
+	ucLength = SP_HEADERSIZE + CRC_SZ;
+	ucErrors = 0;
+
+	for (ucIdx = 0; ucIdx < ucLength;)
+	{
+		ucByte = ucCP_ReadBits(ulHalfNs);
+
+		ucNack = (ucCP_Clock(ulHalfNs, ulHalfNs) != 0) != ucCP_Parity(ucByte);
+		ucNack |= ucCP_InjectNack();
+
+		vCP_Sda(ucNack);
+		ucCP_Clock(ulAckLowNs, ulHalfNs);
+		vCP_Sda(1);
+
+		if (ucNack)
+		{
+			if (++ucErrors == CP_ERRORS)
+				return CP_ABORTED;
+
+			continue;
+		}
+
+		pucFrame[ucIdx++] = ucByte;
+
+		if (ucIdx == MSG_LEN_IDX + 1 && ucByte >= SP_HEADERSIZE && ucByte <= MAXMSGLEN - CRC_SZ)
+			ucLength = ucByte + CRC_SZ;
+	}
+
+	return ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_REC, pucFrame, ucLength) ? CP_OK : CP_BAD_REPLY;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Receives a frame in the burst mode and acks it on its CRC
+//!   \param pucFrame The frame
+//!   \param ulHalfNs The clock
+//!   \return CP_OK or CP_BAD_REPLY
+///////////////////////////////////////////////////////////////////////////////
+static unsigned char ucCP_ReadBurst(unsigned char * pucFrame, unsigned long ulHalfNs)
+{
+	unsigned char ucIdx;
+	unsigned char ucLength;
+	unsigned char ucNack;
+
+	ucLength = SP_HEADERSIZE + CRC_SZ;
+
+	for (ucIdx = 0; ucIdx < ucLength; ucIdx++)
+	{
+		pucFrame[ucIdx] = ucCP_ReadBits(ulHalfNs);
+
+		if (ucIdx == MSG_LEN_IDX && pucFrame[ucIdx] >= SP_HEADERSIZE && pucFrame[ucIdx] <= MAXMSGLEN - CRC_SZ)
+			ucLength = pucFrame[ucIdx] + CRC_SZ;
+	}
+
+	ucNack = !ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_REC, pucFrame, ucLength);
+	ucNack |= ucCP_InjectNack();
+
+	vCP_Sda(ucNack);
+	ucCP_Clock(COMM_BURST_ACK_GAP_US(ucLength) * 1000UL, ulHalfNs);
+	vCP_Sda(1);
+
+	return ucNack ? CP_BAD_REPLY : CP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Waits until the SP has its reply staged
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vCP_WaitReply(void)
+{
+	if (g_ucCP_LinkMode & COMM_LINK_READY_LINE)
+	{
+		vCP_Wait(COMM_READY_SETTLE_US * 1000ULL);
+		vCP_WaitFor(ucCP_SpReady);
+	}
+	else
+	{
+		// The SP lets go of the ack first
+		vCP_Wait(g_ulCP_HalfNs);
+		vCP_WaitFor(ucCP_SpSending);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Receives the reply in the link mode in effect
+//!
+//! A burst reply the CP nacks is sent again in the standard mode.
+//!   \param pucRx The reply
+//!   \return CP_OK, CP_BAD_REPLY or CP_ABORTED
+///////////////////////////////////////////////////////////////////////////////
+static unsigned char ucCP_ReadReply(unsigned char * pucRx)
+{
+	unsigned long ulHalfNs;
+	unsigned long ulAckLowNs;
+
+	ulHalfNs = g_ulCP_HalfNs;
+	ulAckLowNs = g_ulCP_AckLowNs;
+
+	if (g_ucCP_LinkMode & COMM_LINK_IRQ_TX)
+	{
+		ulHalfNs = g_ulCP_IrqHalfNs;
+		ulAckLowNs = g_ulCP_IrqAckLowNs;
+	}
+
+	if (g_ucCP_LinkMode & COMM_LINK_BURST)
+	{
+		if (ucCP_ReadBurst(pucRx, ulHalfNs) == CP_OK)
+			return CP_OK;
+
+		g_ucCP_LinkMode &= ~COMM_LINK_BURST;
+		vCP_WaitReply();
+	}
+
+	return ucCP_ReadFrame(pucRx, ulHalfNs, ulAckLowNs);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Waits until the SP listens for a start condition
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vCP_WaitListening(void)
+{
+	if (g_ucCP_LinkMode & COMM_LINK_READY_LINE)
+	{
+		vCP_Wait(COMM_READY_SETTLE_US * 1000ULL);
+		vCP_WaitFor(ucCP_SpReady);
+	}
+	else
+	{
+		vCP_WaitFor(ucCP_SpListening);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Runs one transaction: a start condition, a frame and the reply
+//!
+//! The CRC of the frame is filled in.  Without a frame the SP is expected to
+//! send its ID packet, as after a reset.  The SP must be listening.
+//!   \param pucTx The frame to send, or 0
+//!   \param pucRx The reply, MAXMSGLEN bytes
+//!   \return CP_OK, CP_REFUSED, CP_BAD_REPLY or CP_ABORTED
+///////////////////////////////////////////////////////////////////////////////
+unsigned char ucCP_Transact(unsigned char * pucTx, unsigned char * pucRx)
+{
+	unsigned char ucLength;
+	unsigned char ucResult;
+
+	// SDA falls while SCL is high, then SCL falls
+	vCP_Sda(0);
+	vCP_Wait(g_ulCP_HalfNs);
+	vCP_Scl(0);
+	vCP_Sda(1);
+
+	ucResult = CP_OK;
+
+	if (pucTx)
+	{
+		ucLength = pucTx[MSG_LEN_IDX] + CRC_SZ;
+		ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_SEND, pucTx, ucLength);
+
+		if (g_ucCP_LinkMode & COMM_LINK_BURST)
+		{
+			ucResult = ucCP_WriteBurst(pucTx, ucLength);
+
+			// The SP dropped to the standard mode on its nack
+			if (ucResult != CP_OK)
+				g_ucCP_LinkMode &= ~COMM_LINK_BURST;
+		}
+		else
+		{
+			ucResult = ucCP_WriteFrame(pucTx, ucLength);
+		}
+
+		g_ucCP_CorruptByte = 0xFF;
+	}
+
+	if (ucResult == CP_OK)
+	{
+		vCP_WaitReply();
+		ucResult = ucCP_ReadReply(pucRx);
+	}
+
+	// Back to idle, both lines high
+	vCP_Sda(1);
+	vCP_Wait(g_ulCP_HalfNs);
+	vCP_Scl(1);
+
+	return ucResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Runs a transaction until it succeeds, as a CP would
+//!
+//! A refused frame, a failed reply or an error report of a frame that
+//! failed its CRC on the SP are tried again, up to CP_TRIES times.
+//!   \param pucTx The frame to send, or 0
+//!   \param pucRx The reply, MAXMSGLEN bytes
+//!   \return The result of the last try
+///////////////////////////////////////////////////////////////////////////////
+unsigned char ucCP_Exchange(unsigned char * pucTx, unsigned char * pucRx)
+{
+	unsigned char ucTry;
+	unsigned char ucResult;
+
+	ucResult = CP_OK;
+
+	for (ucTry = 0; ucTry < CP_TRIES; ucTry++)
+	{
+		vCP_WaitListening();
+
+		ucResult = ucCP_Transact(pucTx, pucRx);
+		if (ucResult != CP_OK)
+			continue;
+
+		if (pucRx[MSG_TYP_IDX] != REPORT_ERROR || pucRx[MSG_LEN_IDX] != SP_HEADERSIZE + 1 || pucRx[MSG_PAYLD_IDX] != COMM_ERROR)
+			break;
+	}
+
+	return ucResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Negotiates a link mode
+//!
+//! The reply comes in the old mode, both ends switch after it.
+//!   \param ucMode The COMM_LINK bits asked for
+//!   \return The result of the exchange
+///////////////////////////////////////////////////////////////////////////////
+unsigned char ucCP_SetLinkMode(unsigned char ucMode)
+{
+	unsigned char ucaTx[MAXMSGLEN];
+	unsigned char ucaRx[MAXMSGLEN];
+	unsigned char ucResult;
+
+	ucaTx[MSG_TYP_IDX] = LINK_MODE;
+	ucaTx[MSG_LEN_IDX] = SP_HEADERSIZE + 1;
+	ucaTx[MSG_VER_IDX] = SP_DATAMESSAGE_VERSION;
+	ucaTx[MSG_FLAGS_IDX] = 0;
+	ucaTx[MSG_PAYLD_IDX] = ucMode;
+
+	ucResult = ucCP_Exchange(ucaTx, ucaRx);
+
+	if (ucResult == CP_OK && ucaRx[MSG_TYP_IDX] == LINK_MODE)
+		g_ucCP_LinkMode = ucaRx[MSG_PAYLD_IDX];
+
+	return ucResult;
+}
+
+static void vCP_SpEntry(void)
+{
+	vSP_Main();
+	vSIM_Fail("the firmware returned");
+}
+
+static void vCP_CpEntry(void)
+{
+	s_pfnCP_Script();
+	g_pfnSIM_Bus = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Runs the firmware from reset against a CP script
+//!
+//! Returns once the script does.  The firmware is left where it was, so it
+//! cannot be run again in the same process.
+//!   \param pfnScript The CP script
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vCP_Run(void (*pfnScript)(void))
+{
+	g_ulCP_HalfNs = 500000UL / COMM_MAX_SCL_KHZ;
+	g_ulCP_AckLowNs = COMM_MIN_ACK_CLOCK_US * 1000UL;
+	g_ulCP_IrqHalfNs = 500000UL / COMM_IRQ_TX_MAX_SCL_KHZ;
+	g_ulCP_IrqAckLowNs = COMM_IRQ_TX_MIN_ACK_CLOCK_US * 1000UL;
+
+	g_ucCP_CorruptByte = 0xFF;
+	g_ucCP_Nacks = 0;
+	g_ulCP_Clocks = 0;
+	g_ulCP_NacksSeen = 0;
+	g_ucCP_LinkMode = 0;
+
+	s_pfnCP_Script = pfnScript;
+
+	getcontext(&s_sCP_Sp);
+	s_sCP_Sp.uc_stack.ss_sp = s_ucaCP_SpStack;
+	s_sCP_Sp.uc_stack.ss_size = sizeof(s_ucaCP_SpStack);
+	s_sCP_Sp.uc_link = 0;
+	makecontext(&s_sCP_Sp, vCP_SpEntry, 0);
+
+	getcontext(&s_sCP_Cp);
+	s_sCP_Cp.uc_stack.ss_sp = s_ucaCP_CpStack;
+	s_sCP_Cp.uc_stack.ss_size = sizeof(s_ucaCP_CpStack);
+	s_sCP_Cp.uc_link = &s_sCP_Main;
+	makecontext(&s_sCP_Cp, vCP_CpEntry, 0);
+
+	g_pfnSIM_Bus = vCP_Bus;
+
+	swapcontext(&s_sCP_Main, &s_sCP_Cp);
+}
+
+//! @}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file cp_sim.h
+//! \brief A CP bus master for the device model
+//!
+//! Drives SDA, SCL and reads the interrupt line bit by bit against the
+//! firmware, which runs from vSP_Main() as it does on the part.  The CP runs
+//! as a coroutine of the bus hook of sim.c: each edge is a bus event, and the
+//! firmware sees it at its next poll.  The wire format is the one of comm.c,
+//! in the standard, burst, ready line and interrupt driven transmit modes.
+//!
+//! Without the ready line a real CP waits fixed delays before a start
+//! condition or a reply.  This CP instead waits until the model shows the SP
+//! listening or driving SDA, so the measured times are the bus time and the
+//! simulated SP time with no slack.  The SP takes no time between two polls,
+//! so its compute time is not in the figures.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CP_SIM_H_
+#define CP_SIM_H_
+
+//! @name Timing
+//! In nanoseconds.  The defaults are 100 kHz with the shortest ack clocks
+//! comm.h allows.
+//! @{
+//! Half of an SCL period
+extern unsigned long g_ulCP_HalfNs;
+//! Low time of SCL before the rising ack clock
+extern unsigned long g_ulCP_AckLowNs;
+//! Half of an SCL period and ack low time while SP frames are clocked in
+//! the interrupt driven transmit mode
+extern unsigned long g_ulCP_IrqHalfNs;
+extern unsigned long g_ulCP_IrqAckLowNs;
+//! @}
+
+//! @name Error Injection
+//! One shot, each is cleared once it has been used.
+//! @{
+//! Index of the byte of the next CP frame that gets a data bit flipped on
+//! the wire, with the parity of the true byte.  0xFF for none.
+extern unsigned char g_ucCP_CorruptByte;
+//! Number of SP bytes the CP nacks, from the next one on
+extern unsigned char g_ucCP_Nacks;
+//! @}
+
+//! @name Bus Counters
+//! @{
+//! SCL clocks, one bit on the wire each
+extern unsigned long g_ulCP_Clocks;
+//! Bytes of CP frames the SP nacked
+extern unsigned long g_ulCP_NacksSeen;
+//! The COMM_LINK bits the CP works with
+extern unsigned char g_ucCP_LinkMode;
+//! @}
+
+//! @name Transaction Results
+//! @{
+#define CP_OK				0	//!< The reply is in and its CRC is good
+#define CP_REFUSED			1	//!< The SP nacked a header byte, the CP stopped
+#define CP_BAD_REPLY		2	//!< The reply failed its CRC
+#define CP_ABORTED			3	//!< The CP nacked 5 tries of a reply byte and gave up
+//! @}
+
+//! @name CP Functions
+//! vCP_Run() may be called once per process.  The other functions are
+//! called from its script.
+//! @{
+void vCP_Run(void (*pfnScript)(void));
+void vCP_Wait(unsigned long long ullNs);
+void vCP_WaitListening(void);
+unsigned char ucCP_Transact(unsigned char * pucTx, unsigned char * pucRx);
+unsigned char ucCP_Exchange(unsigned char * pucTx, unsigned char * pucRx);
+unsigned char ucCP_SetLinkMode(unsigned char ucMode);
+//! @}
+
+#endif /*CP_SIM_H_*/
+//! @}
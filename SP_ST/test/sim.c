@@ -0,0 +1,567 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file sim.c
+//! \brief Device model behind the mock register file of host builds
+//!
+//! Every source of an event keeps the time it is next due.  The model
+//! advances to the earliest one, handles it, and then looks at the registers
+//! again, since an ISR or the bus may have changed them.  A register written
+//! by the code takes effect at the next poll, which is as soon as the code
+//! waits on anything.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "sim.h"
+
+//! \def SIM_NEVER
+//! \brief Due time of a source with nothing pending
+#define SIM_NEVER			0xFFFFFFFFFFFFFFFFULL
+
+//! \def SIM_NS_PER_S
+#define SIM_NS_PER_S		1000000000ULL
+
+//! \def SIM_PORT_PASSES
+//! \brief The most port interrupts taken in one look at the registers
+#define SIM_PORT_PASSES		4
+
+//! @name Interrupt Service Routines
+//! HAL_ISR() makes them plain functions in a host build.
+//! @{
+void PORT1_ISR(void);
+void PORT2_ISR(void);
+void TIMERA1_ISR(void);
+void TIMERB1_ISR(void);
+void ADC_Conversion(void);
+//! @}
+
+//! \struct SIM_TIMER
+//! \brief One of the two timers, which share the register layout
+typedef struct {
+	volatile unsigned int * puiCtl;			//!< TxCTL
+	volatile unsigned int * puiCount;		//!< TxR
+	volatile unsigned int * puiIv;			//!< TxIV
+	volatile unsigned int * puiCcr0;		//!< TxCCR0
+	volatile unsigned int * puiCcr1;		//!< TxCCR1
+	volatile unsigned int * puiCctl1;		//!< TxCCTL1
+	unsigned int uiOverflowIv;				//!< TxIV of the overflow
+	void (*pfnIsr)(void);					//!< The ISR of TxIV
+	unsigned int uiClock;					//!< TxCTL clock bits the phase was started with
+	unsigned long long ullStart;			//!< Time of the phase start
+	unsigned long long ullTicks;			//!< Ticks since the phase start
+	unsigned long long ullNext;				//!< Time of the next tick
+} SIM_TIMER;
+
+unsigned long long g_ullSIM_Now;
+unsigned long long g_ullSIM_Limit;
+unsigned long g_ulSIM_AclkHz;
+
+unsigned int g_uiaSIM_Adc[16];
+unsigned int (*g_pfnSIM_Adc)(unsigned char ucInch);
+unsigned long g_ulSIM_AdcConversions;
+unsigned long g_ulSIM_AdcOverruns;
+
+unsigned char g_ucSIM_P1Ext;
+unsigned char g_ucSIM_P2Ext;
+unsigned long g_ulSIM_EdgeOverruns;
+
+void (*g_pfnSIM_Bus)(void);
+unsigned long long g_ullSIM_BusDue;
+
+//! \var s_ucSIM_InPoll
+//! \brief Set while the model runs, an ISR that polls again gets no time
+static unsigned char s_ucSIM_InPoll;
+
+static SIM_TIMER s_sSIM_TimerA = {
+	&TACTL, &g_uiHOST_TAR, &TAIV, &TACCR0, &TACCR1, &TACCTL1, TAIV_TAIFG, TIMERA1_ISR
+};
+
+static SIM_TIMER s_sSIM_TimerB = {
+	&TBCTL, &g_uiHOST_TBR, &TBIV, &TBCCR0, &TBCCR1, &TBCCTL1, TBIV_TBIFG, TIMERB1_ISR
+};
+
+//! @name ADC12 State
+//! @{
+static unsigned char s_ucSIM_AdcBusy;
+static unsigned char s_ucSIM_AdcMem;
+static unsigned long long s_ullSIM_AdcDone;
+//! @}
+
+static volatile unsigned int * const s_puiaSIM_AdcMem[16] = {
+	&ADC12MEM0, &ADC12MEM1, &ADC12MEM2, &ADC12MEM3, &ADC12MEM4, &ADC12MEM5, &ADC12MEM6, &ADC12MEM7,
+	&ADC12MEM8, &ADC12MEM9, &ADC12MEM10, &ADC12MEM11, &ADC12MEM12, &ADC12MEM13, &ADC12MEM14, &ADC12MEM15
+};
+
+static volatile unsigned char * const s_pucaSIM_AdcMctl[16] = {
+	&ADC12MCTL0, &ADC12MCTL1, &ADC12MCTL2, &ADC12MCTL3, &ADC12MCTL4, &ADC12MCTL5, &ADC12MCTL6, &ADC12MCTL7,
+	&ADC12MCTL8, &ADC12MCTL9, &ADC12MCTL10, &ADC12MCTL11, &ADC12MCTL12, &ADC12MCTL13, &ADC12MCTL14, &ADC12MCTL15
+};
+
+//! ADC12CLK cycles of each SHTx setting
+static const unsigned int s_uiaSIM_AdcSht[16] = {
+	4, 8, 16, 32, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1024, 1024, 1024
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Stops the test with a message
+//!   \param pcWhy What went wrong
+//!   \return never
+///////////////////////////////////////////////////////////////////////////////
+void vSIM_Fail(const char * pcWhy)
+{
+	printf("sim: %s at %llu ns\n", pcWhy, g_ullSIM_Now);
+	fflush(stdout);
+	exit(2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the frequency a timer counts at, 0 if it is stopped
+//!   \param psTimer The timer
+//!   \return Ticks per second
+///////////////////////////////////////////////////////////////////////////////
+static unsigned long ulSIM_TimerHz(SIM_TIMER * psTimer)
+{
+	unsigned int uiCtl;
+	unsigned long ulHz;
+
+	uiCtl = *psTimer->puiCtl;
+
+	if ((uiCtl & (MC_1 | MC_2)) == 0)
+		return 0;
+
+	switch (uiCtl & (TASSEL_1 | TASSEL_2))
+	{
+		case TASSEL_1:
+			ulHz = g_ulSIM_AclkHz;
+		break;
+
+		case TASSEL_2:
+			ulHz = SIM_SMCLK_HZ;
+		break;
+
+		default:
+			vSIM_Fail("timer clock not modeled");
+			return 0;
+	}
+
+	return ulHz >> ((uiCtl >> 6) & 3);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Takes up a change of the timer control
+//!
+//! A clear resets the count.  A change of the clock or the mode starts a new
+//! phase, so the first tick is one period after the write.
+//!   \param psTimer The timer
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_TimerControl(SIM_TIMER * psTimer)
+{
+	unsigned int uiClock;
+	unsigned long ulHz;
+
+	if (*psTimer->puiCtl & TACLR)
+	{
+		*psTimer->puiCtl &= ~TACLR;
+		*psTimer->puiCount = 0;
+		psTimer->uiClock = 0xFFFF;
+	}
+
+	uiClock = *psTimer->puiCtl & (TASSEL_1 | TASSEL_2 | ID_3 | MC_1 | MC_2);
+	if (uiClock == psTimer->uiClock)
+		return;
+
+	psTimer->uiClock = uiClock;
+	psTimer->ullStart = g_ullSIM_Now;
+	psTimer->ullTicks = 0;
+
+	ulHz = ulSIM_TimerHz(psTimer);
+	psTimer->ullNext = ulHz ? g_ullSIM_Now + SIM_NS_PER_S / ulHz : SIM_NEVER;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Starts a conversion of the ADC12
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_AdcStart(void)
+{
+	unsigned long ulHz;
+	unsigned long ulCycles;
+	unsigned int uiSht;
+
+	if (s_ucSIM_AdcBusy)
+	{
+		g_ulSIM_AdcOverruns++;
+		return;
+	}
+
+	switch (ADC12CTL1 & ADC12SSEL_3)
+	{
+		case 0:
+			ulHz = SIM_ADC12OSC_HZ;
+		break;
+
+		case ADC12SSEL0:
+			ulHz = g_ulSIM_AclkHz;
+		break;
+
+		case ADC12SSEL1:
+			ulHz = SIM_MCLK_HZ;
+		break;
+
+		default:
+			ulHz = SIM_SMCLK_HZ;
+		break;
+	}
+
+	s_ucSIM_AdcMem = (unsigned char) (ADC12CTL1 >> 12);
+
+	// SHT0 times MEM0 to MEM7, SHT1 the others
+	uiSht = (s_ucSIM_AdcMem < 8) ? (ADC12CTL0 >> 8) & 0x0F : ADC12CTL0 >> 12;
+	ulCycles = (s_uiaSIM_AdcSht[uiSht] + 13UL) * (((ADC12CTL1 >> 5) & 7) + 1);
+
+	s_ucSIM_AdcBusy = 1;
+	s_ullSIM_AdcDone = g_ullSIM_Now + (ulCycles * SIM_NS_PER_S + ulHz - 1) / ulHz;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Stores a finished conversion and starts the next of a sequence
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_AdcDone(void)
+{
+	unsigned char ucInch;
+	unsigned int uiValue;
+	unsigned int uiBit;
+
+	s_ucSIM_AdcBusy = 0;
+	s_ullSIM_AdcDone = SIM_NEVER;
+
+	if ((ADC12CTL0 & ADC12ON) == 0)
+		return;
+
+	ucInch = *s_pucaSIM_AdcMctl[s_ucSIM_AdcMem] & 0x0F;
+	uiValue = g_pfnSIM_Adc ? g_pfnSIM_Adc(ucInch) : g_uiaSIM_Adc[ucInch];
+
+	*s_puiaSIM_AdcMem[s_ucSIM_AdcMem] = uiValue & 0x0FFF;
+	g_ulSIM_AdcConversions++;
+
+	uiBit = 1 << s_ucSIM_AdcMem;
+	ADC12IFG |= uiBit;
+
+	// Reading ADC12IV in the ISR clears the flag
+	if (ADC12IE & uiBit)
+	{
+		ADC12IV = ADC12IV_ADC12IFG0 + 2 * s_ucSIM_AdcMem;
+		ADC_Conversion();
+		ADC12IFG &= ~uiBit;
+		ADC12IV = 0;
+	}
+
+	// A repeated conversion without a trigger starts over at once
+	if ((ADC12CTL1 & CONSEQ1) && (ADC12CTL0 & (MSC | ENC)) == (MSC | ENC) && (ADC12CTL1 & SHS_3) == SHS_0)
+		vSIM_AdcStart();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Handles a compare or an overflow of a timer
+//!   \param psTimer The timer; puiCctl The capture/compare control; uiIv The
+//!   vector; puiFlag The register of the flag, and uiIe, uiIfg its bits
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_TimerFlag(SIM_TIMER * psTimer, volatile unsigned int * puiFlag, unsigned int uiIe, unsigned int uiIfg, unsigned int uiIv)
+{
+	*puiFlag |= uiIfg;
+
+	if (*puiFlag & uiIe)
+	{
+		*psTimer->puiIv = uiIv;
+		psTimer->pfnIsr();
+		*puiFlag &= ~uiIfg;
+		*psTimer->puiIv = 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Counts one tick of a timer
+//!
+//! In up mode the count rolls over from TxCCR0 to 0.  OUT1 of Timer_B in
+//! OUTMOD_7 rises as the count reaches TBCCR0, which triggers the ADC12 when
+//! it is set to SHS_3.
+//!   \param psTimer The timer
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_TimerTick(SIM_TIMER * psTimer)
+{
+	unsigned int uiCount;
+	unsigned char ucOverflow;
+
+	uiCount = *psTimer->puiCount;
+
+	if ((*psTimer->puiCtl & (MC_1 | MC_2)) == MC_1 && uiCount == *psTimer->puiCcr0)
+		uiCount = 0;
+	else
+		uiCount = (uiCount + 1) & 0xFFFF;
+
+	ucOverflow = (uiCount == 0);
+	*psTimer->puiCount = uiCount;
+
+	psTimer->ullTicks++;
+	psTimer->ullNext = psTimer->ullStart + ((psTimer->ullTicks + 1) * SIM_NS_PER_S) / ulSIM_TimerHz(psTimer);
+
+	if (psTimer == &s_sSIM_TimerB && (*psTimer->puiCtl & (MC_1 | MC_2)) == MC_1 && uiCount == *psTimer->puiCcr0)
+	{
+		if ((TBCCTL1 & OUTMOD_7) == OUTMOD_7 && (ADC12CTL1 & SHS_3) == SHS_3 && (ADC12CTL0 & (ADC12ON | ENC)) == (ADC12ON | ENC))
+			vSIM_AdcStart();
+	}
+
+	if (uiCount == *psTimer->puiCcr1)
+		vSIM_TimerFlag(psTimer, psTimer->puiCctl1, CCIE, CCIFG, TAIV_TACCR1);
+
+	if (ucOverflow)
+		vSIM_TimerFlag(psTimer, psTimer->puiCtl, TAIE, TAIFG, psTimer->uiOverflowIv);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Updates the input of a port and flags its edges
+//!   \param pucIn, pucOut, pucDir, pucIes, pucIfg The port registers
+//!   ucExt The external drive
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_Port(volatile unsigned char * pucIn, volatile unsigned char * pucOut, volatile unsigned char * pucDir,
+	volatile unsigned char * pucIes, volatile unsigned char * pucIfg, unsigned char ucExt)
+{
+	unsigned char ucLine;
+	unsigned char ucEdges;
+
+	ucLine = ucExt & (unsigned char) (~*pucDir | *pucOut);
+
+	// IES set flags a falling edge
+	ucEdges = ((ucLine & ~*pucIn) & ~*pucIes) | ((*pucIn & ~ucLine) & *pucIes);
+
+	if (ucEdges & *pucIfg)
+		g_ulSIM_EdgeOverruns++;
+
+	*pucIfg |= ucEdges;
+	*pucIn = ucLine;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Updates the port inputs from the external drive and the outputs
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vSIM_Pins(void)
+{
+	vSIM_Port(&P1IN, &P1OUT, &P1DIR, &P1IES, &P1IFG, g_ucSIM_P1Ext);
+	vSIM_Port(&P2IN, &P2OUT, &P2DIR, &P2IES, &P2IFG, g_ucSIM_P2Ext);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Takes up what the code or an ISR wrote to the registers
+//!
+//! A port interrupt that is still pending afterwards is taken again, the
+//! way the part would take it as soon as the ISR returns.
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_Registers(void)
+{
+	unsigned char ucPass;
+
+	vSIM_TimerControl(&s_sSIM_TimerA);
+	vSIM_TimerControl(&s_sSIM_TimerB);
+
+	if (s_ucSIM_AdcBusy && (ADC12CTL0 & ADC12ON) == 0)
+	{
+		s_ucSIM_AdcBusy = 0;
+		s_ullSIM_AdcDone = SIM_NEVER;
+	}
+
+	// A software start, the bit clears once sampling starts
+	if ((ADC12CTL0 & (ADC12ON | ENC | ADC12SC)) == (ADC12ON | ENC | ADC12SC) && (ADC12CTL1 & SHS_3) == SHS_0)
+	{
+		ADC12CTL0 &= ~ADC12SC;
+		if (!s_ucSIM_AdcBusy)
+			vSIM_AdcStart();
+	}
+
+	for (ucPass = 0; ucPass < SIM_PORT_PASSES; ucPass++)
+	{
+		vSIM_Pins();
+
+		if (P1IFG & P1IE)
+			PORT1_ISR();
+		else if (P2IFG & P2IE)
+			PORT2_ISR();
+		else
+			break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Returns the time of the earliest event
+//!   \param none
+//!   \return The time, SIM_NEVER if nothing is pending
+///////////////////////////////////////////////////////////////////////////////
+static unsigned long long ullSIM_Next(void)
+{
+	unsigned long long ullNext;
+
+	ullNext = s_sSIM_TimerA.ullNext;
+
+	if (s_sSIM_TimerB.ullNext < ullNext)
+		ullNext = s_sSIM_TimerB.ullNext;
+
+	if (s_ullSIM_AdcDone < ullNext)
+		ullNext = s_ullSIM_AdcDone;
+
+	if (g_pfnSIM_Bus && g_ullSIM_BusDue < ullNext)
+		ullNext = g_ullSIM_BusDue;
+
+	return ullNext;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Handles every event up to a time, then moves the time there
+//!   \param ullTarget The time
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_Advance(unsigned long long ullTarget)
+{
+	unsigned long long ullNext;
+	void (*pfnBus)(void);
+
+	for (;;)
+	{
+		ullNext = ullSIM_Next();
+		if (ullNext > ullTarget)
+			break;
+
+		g_ullSIM_Now = ullNext;
+
+		if (g_ullSIM_Now > g_ullSIM_Limit)
+			vSIM_Fail("time limit reached");
+
+		if (s_sSIM_TimerA.ullNext == ullNext)
+			vSIM_TimerTick(&s_sSIM_TimerA);
+		else if (s_sSIM_TimerB.ullNext == ullNext)
+			vSIM_TimerTick(&s_sSIM_TimerB);
+		else if (s_ullSIM_AdcDone == ullNext)
+			vSIM_AdcDone();
+		else
+		{
+			// The bus sets its next due time
+			pfnBus = g_pfnSIM_Bus;
+			g_ullSIM_BusDue = SIM_NEVER;
+			pfnBus();
+		}
+
+		vSIM_Registers();
+	}
+
+	g_ullSIM_Now = ullTarget;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The poll hook, runs the model for one poll of the code
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vSIM_Poll(void)
+{
+	unsigned long long ullNext;
+
+	if (s_ucSIM_InPoll)
+		return;
+
+	s_ucSIM_InPoll = 1;
+
+	vSIM_Registers();
+
+	if (g_ucHOST_Asleep && !g_ucHOST_Awake)
+	{
+		ullNext = ullSIM_Next();
+		if (ullNext == SIM_NEVER)
+			vSIM_Fail("asleep with nothing to wake the part");
+
+		vSIM_Advance(ullNext);
+	}
+	else
+	{
+		vSIM_Advance(g_ullSIM_Now + SIM_BUSY_NS);
+	}
+
+	if (g_ullSIM_Now > g_ullSIM_Limit)
+		vSIM_Fail("time limit reached");
+
+	s_ucSIM_InPoll = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Runs the model on its own for a while, as the code would sleep
+//!   \param ullNs The time to run
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vSIM_Run(unsigned long long ullNs)
+{
+	s_ucSIM_InPoll = 1;
+
+	vSIM_Registers();
+	vSIM_Advance(g_ullSIM_Now + ullNs);
+
+	s_ucSIM_InPoll = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Puts the mock device and the model in their power up state
+//!
+//! Every ADC input reads mid scale, the bus lines are released and the time
+//! limit is a minute.
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+void vSIM_Reset(void)
+{
+	unsigned char ucIdx;
+
+	vHOST_Reset();
+
+	g_ullSIM_Now = 0;
+	g_ullSIM_Limit = 60 * SIM_NS_PER_S;
+	g_ulSIM_AclkHz = 3000;
+
+	for (ucIdx = 0; ucIdx < 16; ucIdx++)
+		g_uiaSIM_Adc[ucIdx] = 0x0800;
+
+	g_pfnSIM_Adc = 0;
+	g_ulSIM_AdcConversions = 0;
+	g_ulSIM_AdcOverruns = 0;
+	s_ucSIM_AdcBusy = 0;
+	s_ullSIM_AdcDone = SIM_NEVER;
+
+	g_ucSIM_P1Ext = 0xFF;
+	g_ucSIM_P2Ext = 0xFF;
+	g_ulSIM_EdgeOverruns = 0;
+	P1IN = 0xFF;
+	P2IN = 0xFF;
+
+	g_pfnSIM_Bus = 0;
+	g_ullSIM_BusDue = SIM_NEVER;
+
+	s_sSIM_TimerA.uiClock = 0xFFFF;
+	s_sSIM_TimerA.ullNext = SIM_NEVER;
+	s_sSIM_TimerB.uiClock = 0xFFFF;
+	s_sSIM_TimerB.ullNext = SIM_NEVER;
+
+	s_ucSIM_InPoll = 0;
+	g_pfnHOST_Poll = vSIM_Poll;
+}
+
+//! @}
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file sim.h
+//! \brief Device model behind the mock register file of host builds
+//!
+//! The model runs from the poll hook of core/host/msp430_host.c.  Time is
+//! kept in nanoseconds.  A poll while the code is busy advances it by
+//! SIM_BUSY_NS.  A poll while the part sleeps jumps to the next event.  The
+//! code itself takes no time between two polls, so a measured time is the
+//! time spent waiting on the hardware and the bus.
+//!
+//! Modeled are:
+//!   - Timer_A and Timer_B: continuous and up mode, CCR1 compare interrupts,
+//!     the overflow flag and interrupt, and OUT1 of Timer_B as the ADC12
+//!     trigger
+//!   - ADC12: one channel, single and repeated, software or Timer_B trigger,
+//!     with the sample and conversion time of the configured clock
+//!   - Ports 1 and 2: the line is the wired AND of the external drive and
+//!     the port output, with edge flags and interrupts
+//!
+//! Flash writes land at once and an erase is not modeled.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SIM_H_
+#define SIM_H_
+
+//! @name Clocks
+//! @{
+//! \def SIM_MCLK_HZ
+#define SIM_MCLK_HZ			16000000UL
+//! \def SIM_SMCLK_HZ
+#define SIM_SMCLK_HZ		4000000UL
+//! \def SIM_ADC12OSC_HZ
+#define SIM_ADC12OSC_HZ		5000000UL
+//! \def SIM_BUSY_NS
+//! \brief Time of one poll of a busy wait loop
+#define SIM_BUSY_NS			1000ULL
+//! @}
+
+//! @name Model State
+//! @{
+extern unsigned long long g_ullSIM_Now;
+extern unsigned long long g_ullSIM_Limit;
+extern unsigned long g_ulSIM_AclkHz;
+
+//! The ADC input of each channel, unless g_pfnSIM_Adc is set
+extern unsigned int g_uiaSIM_Adc[16];
+extern unsigned int (*g_pfnSIM_Adc)(unsigned char ucInch);
+extern unsigned long g_ulSIM_AdcConversions;
+extern unsigned long g_ulSIM_AdcOverruns;
+
+//! The external drive of ports 1 and 2, 1 for released
+extern unsigned char g_ucSIM_P1Ext;
+extern unsigned char g_ucSIM_P2Ext;
+extern unsigned long g_ulSIM_EdgeOverruns;
+
+//! Called once g_ullSIM_Now reaches g_ullSIM_BusDue
+extern void (*g_pfnSIM_Bus)(void);
+extern unsigned long long g_ullSIM_BusDue;
+//! @}
+
+//! @name Model Functions
+//! @{
+void vSIM_Reset(void);
+void vSIM_Run(unsigned long long ullNs);
+void vSIM_Pins(void);
+void vSIM_Fail(const char * pcWhy);
+//! @}
+
+#endif /*SIM_H_*/
+//! @}
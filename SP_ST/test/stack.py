@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+###############################################################################
+# Static worst-case stack of the firmware
+#
+# Usage: stack.py [--src DIR] [--size SIZE --elf ELF] [--ram BYTES] OBJDIR
+#
+# Reads the call graph and frames that -fcallgraph-info=su left in the .ci
+# files under OBJDIR and finds the deepest call chain from main and from
+# each interrupt service routine.  The routines are the HAL_ISR definitions
+# of the sources under --src.  None of them sets GIE, so at most one runs on
+# top of the main chain, and the worst case is the deepest main chain plus
+# the deepest routine with the 4 bytes of PC and SR the CPU pushes for it.
+#
+# The frames are those of -fstack-usage, with the return address.  A call
+# to a function without a frame (a runtime helper of libgcc) counts 0 and
+# is listed, as are dynamic frames and recursion, which make the figure a
+# lower bound.
+#
+# With --elf the RAM taken by .data and .bss is read with the size tool of
+# the toolchain and the RAM left above the worst case is reported.
+###############################################################################
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+NODE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+FRAME = re.compile(r"\\n(\d+) bytes \(([a-z,]+)\)")
+ISR = re.compile(r"HAL_ISR\(\s*\w+\s*,\s*(\w+)\s*\)")
+
+ISR_ENTRY = 4
+
+
+def read_graph(objdir):
+    """Returns the frame and kind of each function and the callees of each"""
+    frames = {}
+    calls = {}
+    for root, _, files in os.walk(objdir):
+        for name in files:
+            if not name.endswith(".ci"):
+                continue
+            with open(os.path.join(root, name)) as ci:
+                text = ci.read()
+            for title, label in NODE.findall(text):
+                match = FRAME.search(label)
+                if match:
+                    frames[title] = (int(match.group(1)), match.group(2))
+            for source, target in EDGE.findall(text):
+                calls.setdefault(source, set()).add(target)
+    return frames, calls
+
+
+def read_isrs(srcdir):
+    isrs = []
+    for root, _, files in os.walk(srcdir):
+        for name in sorted(files):
+            if name.endswith(".c"):
+                with open(os.path.join(root, name), errors="replace") as src:
+                    isrs += ISR.findall(src.read())
+    return isrs
+
+
+class Walker:
+    """Finds the deepest chain below a function"""
+
+    def __init__(self, frames, calls):
+        self.frames = frames
+        self.calls = calls
+        self.memo = {}
+        self.unknown = set()
+        self.dynamic = set()
+        self.recursive = set()
+
+    def deepest(self, function, active=()):
+        if function in self.memo:
+            return self.memo[function]
+        if function in active:
+            self.recursive.add(function)
+            return 0, []
+
+        if function not in self.frames:
+            self.unknown.add(function)
+            return 0, [function]
+
+        frame, kind = self.frames[function]
+        if kind != "static":
+            self.dynamic.add(function)
+
+        best = (0, [])
+        for callee in sorted(self.calls.get(function, ())):
+            depth = self.deepest(callee, active + (function,))
+            if depth[0] > best[0]:
+                best = depth
+
+        result = (frame + best[0], [function] + best[1])
+        self.memo[function] = result
+        return result
+
+
+def show(title, depth, chain, frames):
+    print("%s: %d bytes" % (title, depth))
+    for function in chain:
+        # Static functions are titled with their file
+        print("  %-32s %5d" % (function.rsplit(":", 1)[-1], frames.get(function, (0, ""))[0]))
+
+
+def ram_used(size, elf):
+    out = subprocess.run([size, "-A", elf], check=True, capture_output=True, text=True).stdout
+    used = 0
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in (".data", ".bss", ".noinit") and fields[1].isdigit():
+            used += int(fields[1])
+    return used
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Static worst-case stack from the GCC call graph")
+    parser.add_argument("--src", default="..")
+    parser.add_argument("--size", default="msp430-elf-size")
+    parser.add_argument("--elf")
+    parser.add_argument("--ram", type=int, default=2048)
+    parser.add_argument("--main", default="main")
+    parser.add_argument("objdir")
+    args = parser.parse_args()
+
+    frames, calls = read_graph(args.objdir)
+    if args.main not in frames:
+        sys.exit("stack: no %s in the call graph of %s" % (args.main, args.objdir))
+
+    walker = Walker(frames, calls)
+    main_depth, main_chain = walker.deepest(args.main)
+    show(args.main, main_depth, main_chain, frames)
+
+    isr_depth = 0
+    isr_name = None
+    for isr in read_isrs(args.src):
+        if isr not in frames:
+            continue
+        depth, chain = walker.deepest(isr)
+        if depth > isr_depth:
+            isr_depth, isr_name, isr_chain = depth, isr, chain
+
+    if isr_name:
+        show("%s, with %d bytes of entry" % (isr_name, ISR_ENTRY), isr_depth + ISR_ENTRY, isr_chain, frames)
+        isr_depth += ISR_ENTRY
+
+    worst = main_depth + isr_depth
+    print("worst case: %d bytes" % worst)
+
+    for what, names in (("no frame", walker.unknown), ("dynamic frame", walker.dynamic),
+                        ("recursion", walker.recursive)):
+        if names:
+            print("%s: %s" % (what, " ".join(sorted(names))))
+
+    if args.elf:
+        used = ram_used(args.size, args.elf)
+        print(".data and .bss: %d bytes, free above the worst case: %d of %d bytes"
+              % (used, args.ram - used - worst, args.ram))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file test_burst.c
+//! \brief Tests of the \ref burst capture
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "Burst.h"
+#include "sim.h"
+#include "board.h"
+#include "check.h"
+
+//! \def TEST_STEP_SAMPLE
+//! \brief The sample of channel 1 that steps from 1000 to 3000 ticks
+#define TEST_STEP_SAMPLE	300
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A step on channel 1, counted from its first sample
+///////////////////////////////////////////////////////////////////////////////
+static unsigned int uiTest_Step(unsigned char ucChannel, unsigned long ulSample, unsigned long long ullNs)
+{
+	static unsigned long s_ulFirst = 0xFFFFFFFFUL;
+
+	if (ucChannel != 1)
+		return 0x0100;
+
+	if (s_ulFirst == 0xFFFFFFFFUL)
+		s_ulFirst = ulSample;
+
+	return (ulSample - s_ulFirst < TEST_STEP_SAMPLE) ? 1000 : 3000;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Reads the capture back as the CP would
+//!   \param puiSamples The samples, BURST_SAMPLES at most
+//!   \param uiCount The number of samples the info gives
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vTest_BurstRead(uint16 * puiSamples, uint16 uiCount)
+{
+	uint8 ucaData[BURST_BYTES];
+	uint16 uiOffset;
+	uint16 uiIdx;
+	uint8 ucLength;
+
+	for (uiOffset = 0; uiOffset < BURST_BYTES; uiOffset += ucLength)
+	{
+		ucLength = ucBurst_XferRead(BURST_OBJ_DATA, uiOffset, &ucaData[uiOffset], 50);
+		if (ucLength == 0 || ucLength == XFER_NO_OBJECT)
+			break;
+	}
+
+	CHECK_EQUAL(uiCount / 2 * 3, uiOffset);
+
+	for (uiIdx = 0; uiIdx < uiCount; uiIdx += 2)
+	{
+		puiSamples[uiIdx] = ((uint16) ucaData[uiIdx / 2 * 3] << 4) | (ucaData[uiIdx / 2 * 3 + 1] >> 4);
+		puiSamples[uiIdx + 1] = ((uint16) (ucaData[uiIdx / 2 * 3 + 1] & 0x0F) << 8) | ucaData[uiIdx / 2 * 3 + 2];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A rising trigger keeps the pretrigger samples ahead of the step
+///////////////////////////////////////////////////////////////////////////////
+void vTest_BurstTrigger(void)
+{
+	uint8 ucaParam[9] = { BURST_OP_CAPTURE, 1, 0x01, 0x90, BURST_TRIG_RISING, 0x07, 0xD0, 0x00, 100 };
+	uint8 ucaInfo[BURST_INFO_LEN];
+	uint16 uiaSamples[BURST_SAMPLES];
+
+	vBOARD_Init();
+	g_pfnBOARD_Wave = uiTest_Step;
+	vCORE_Initilize();
+
+	CHECK_EQUAL(0, uiMainDispatch(0, sizeof(ucaParam), ucaParam));
+	CHECK_EQUAL(0, g_ulSIM_AdcOverruns);
+
+	CHECK_EQUAL(BURST_INFO_LEN, ucBurst_XferRead(BURST_OBJ_INFO, 0, ucaInfo, BURST_INFO_LEN));
+	CHECK_EQUAL(BURST_STATE_DONE, ucaInfo[0]);
+	CHECK_EQUAL(BURST_SAMPLES, (ucaInfo[9] << 8) | ucaInfo[10]);
+	CHECK_EQUAL(100, (ucaInfo[11] << 8) | ucaInfo[12]);
+
+	vTest_BurstRead(uiaSamples, BURST_SAMPLES);
+	CHECK_EQUAL(1000, uiaSamples[0]);
+	CHECK_EQUAL(1000, uiaSamples[99]);
+	CHECK_EQUAL(3000, uiaSamples[100]);
+	CHECK_EQUAL(3000, uiaSamples[BURST_SAMPLES - 1]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A trigger that never comes gives up within BURST_MAX_TICKS
+//!
+//! The longest pretrigger is the worst case, the wait only starts once it
+//! is in.
+///////////////////////////////////////////////////////////////////////////////
+void vTest_BurstBound(void)
+{
+	uint8 ucaParam[9] = { BURST_OP_CAPTURE, 2, BURST_MAX_INTERVAL >> 8, BURST_MAX_INTERVAL & 0xFF, BURST_TRIG_RISING, 0x0F, 0xF0,
+		(BURST_SAMPLES - 1) >> 8, (BURST_SAMPLES - 1) & 0xFF };
+	uint8 ucaInfo[BURST_INFO_LEN];
+	unsigned long long ullStart;
+	unsigned long long ullBound;
+
+	vBOARD_Init();
+	vCORE_Initilize();
+
+	ullStart = g_ullSIM_Now;
+	CHECK_EQUAL(0, uiMainDispatch(0, sizeof(ucaParam), ucaParam));
+
+	// The settle of the channel, then the capture
+	ullBound = 125000000ULL + BURST_MAX_TICKS * 1000000000ULL / SIM_SMCLK_HZ;
+	CHECK(g_ullSIM_Now - ullStart <= ullBound);
+	CHECK(g_ullSIM_Now - ullStart > ullBound - 10000000ULL);
+
+	ucBurst_XferRead(BURST_OBJ_INFO, 0, ucaInfo, BURST_INFO_LEN);
+	CHECK_EQUAL(BURST_STATE_TIMEOUT, ucaInfo[0]);
+	CHECK_EQUAL(0xFFFF, (ucaInfo[11] << 8) | ucaInfo[12]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A timeout at the longest interval serves only the samples taken
+//!
+//! The default pretrigger and the wait that fits BURST_MAX_TICKS come to
+//! fewer than BURST_SAMPLES.  A capture of channel 1 first fills the ring,
+//! so a stale sample served would show as 1000 or 3000.
+///////////////////////////////////////////////////////////////////////////////
+void vTest_BurstShortTimeout(void)
+{
+	uint8 ucaFill[4] = { BURST_OP_CAPTURE, 1, BURST_MIN_INTERVAL >> 8, BURST_MIN_INTERVAL & 0xFF };
+	uint8 ucaParam[7] = { BURST_OP_CAPTURE, 2, BURST_MAX_INTERVAL >> 8, BURST_MAX_INTERVAL & 0xFF, BURST_TRIG_RISING, 0x0F, 0xF0 };
+	uint8 ucaInfo[BURST_INFO_LEN];
+	uint16 uiaSamples[BURST_SAMPLES];
+	uint16 uiCount;
+	uint16 uiIdx;
+
+	vBOARD_Init();
+	g_pfnBOARD_Wave = uiTest_Step;
+	vCORE_Initilize();
+
+	CHECK_EQUAL(0, uiMainDispatch(0, sizeof(ucaFill), ucaFill));
+	CHECK_EQUAL(0, uiMainDispatch(0, sizeof(ucaParam), ucaParam));
+
+	ucBurst_XferRead(BURST_OBJ_INFO, 0, ucaInfo, BURST_INFO_LEN);
+	CHECK_EQUAL(BURST_STATE_TIMEOUT, ucaInfo[0]);
+	CHECK_EQUAL(BURST_SAMPLES / 2, (ucaInfo[7] << 8) | ucaInfo[8]);
+
+	// The pretrigger, then the wait
+	uiCount = (ucaInfo[9] << 8) | ucaInfo[10];
+	CHECK_EQUAL(BURST_SAMPLES / 2 + BURST_MAX_TICKS / BURST_MAX_INTERVAL - BURST_SAMPLES, uiCount);
+
+	vTest_BurstRead(uiaSamples, uiCount);
+	for (uiIdx = 0; uiIdx < uiCount; uiIdx++)
+		if (uiaSamples[uiIdx] != 0x0100)
+			break;
+	CHECK_EQUAL(uiCount, uiIdx);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Bad parameters are refused without a capture
+///////////////////////////////////////////////////////////////////////////////
+void vTest_BurstRejects(void)
+{
+	uint8 ucaParam[5] = { BURST_OP_CAPTURE, 1, (BURST_MAX_INTERVAL + 1) >> 8, (BURST_MAX_INTERVAL + 1) & 0xFF, BURST_TRIG_NONE };
+	uint8 ucaInfo[BURST_INFO_LEN];
+
+	vBOARD_Init();
+	vCORE_Initilize();
+
+	CHECK_EQUAL(1, uiBurst_Command(sizeof(ucaParam), ucaParam));
+
+	ucaParam[2] = (BURST_MIN_INTERVAL - 1) >> 8;
+	ucaParam[3] = (BURST_MIN_INTERVAL - 1) & 0xFF;
+	CHECK_EQUAL(1, uiBurst_Command(sizeof(ucaParam), ucaParam));
+
+	ucaParam[2] = BURST_MIN_INTERVAL >> 8;
+	ucaParam[3] = BURST_MIN_INTERVAL & 0xFF;
+	ucaParam[1] = 0;
+	CHECK_EQUAL(1, uiBurst_Command(sizeof(ucaParam), ucaParam));
+
+	ucaParam[1] = 1;
+	ucaParam[4] = BURST_TRIG_FALLING + 1;
+	CHECK_EQUAL(1, uiBurst_Command(sizeof(ucaParam), ucaParam));
+
+	CHECK_EQUAL(0, g_ulSIM_AdcConversions);
+	ucBurst_XferRead(BURST_OBJ_INFO, 0, ucaInfo, BURST_INFO_LEN);
+	CHECK_EQUAL(BURST_STATE_IDLE, ucaInfo[0]);
+	CHECK_EQUAL(XFER_NO_OBJECT, ucBurst_XferRead(BURST_OBJ_DATA, 0, ucaInfo, BURST_INFO_LEN));
+}
+
+//! @}
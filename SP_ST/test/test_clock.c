@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file test_clock.c
+//! \brief Tests of the \ref clock timebase and the VLO calibration
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "sim.h"
+#include "check.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Ticks convert to rounded milliseconds at the set rate
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ClockToMillis(void)
+{
+	CHECK_EQUAL(CLOCK_RATE_NOMINAL, uiCLOCK_GetRate());
+	CHECK_EQUAL(1000, ulCLOCK_ToMillis(3000));
+	CHECK_EQUAL(1500, ulCLOCK_ToMillis(4500));
+	CHECK_EQUAL(0, ulCLOCK_ToMillis(1));
+	CHECK_EQUAL(1, ulCLOCK_ToMillis(2));
+
+	// A day of ticks does not overflow
+	CHECK_EQUAL(86400000UL, ulCLOCK_ToMillis(86400UL * 3000));
+
+	// A rate of 0 is ignored
+	vCLOCK_SetRate(0);
+	CHECK_EQUAL(CLOCK_RATE_NOMINAL, uiCLOCK_GetRate());
+
+	vCLOCK_SetRate(2500);
+	CHECK_EQUAL(1000, ulCLOCK_ToMillis(2500));
+	CHECK_EQUAL(1717986918UL, ulCLOCK_ToMillis(0xFFFFFFFFUL));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The timebase counts ACLK, across overflows of Timer_A
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ClockCountsAclk(void)
+{
+	uint32 ulStart;
+	uint32 ulTicks;
+
+	vCORE_Initilize();
+
+	ulStart = ulCLOCK_Now();
+	vSIM_Run(1000000000ULL);
+	CHECK_NEAR(3000, ulCLOCK_Now() - ulStart, 1);
+
+	// 30 s wraps the 16-bit counter
+	ulStart = ulCLOCK_Now();
+	vSIM_Run(30000000000ULL);
+	ulTicks = ulCLOCK_Now() - ulStart;
+	CHECK_NEAR(90000, ulTicks, 1);
+	CHECK_NEAR(30000, ulCLOCK_ToMillis(ulTicks), 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The calibration measures the ACLK rate against SMCLK
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ClockCalibrateVlo(void)
+{
+	g_ulSIM_AclkHz = 2500;
+
+	vCORE_Initilize();
+	vMain_CalibrateVLO();
+
+	CHECK_NEAR(2500, uiCLOCK_GetRate(), 2);
+	CHECK_NEAR(2500 * 4 - 12000, g_iVLOCal, 8);
+
+	// Timer_B is left stopped, Timer_A runs on
+	CHECK_EQUAL(0, TBCTL & (MC_1 | MC_2));
+	CHECK_EQUAL(MC_2, TACTL & (MC_1 | MC_2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A sync calibrates again only once the period has passed
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ClockSyncCalibrates(void)
+{
+	vCORE_Initilize();
+	vMain_CalibrateVLO();
+	CHECK_NEAR(3000, uiCLOCK_GetRate(), 2);
+
+	g_ulSIM_AclkHz = 2500;
+	vSIM_Run(1000000000ULL);
+	vMain_TimeSync();
+	CHECK_NEAR(3000, uiCLOCK_GetRate(), 2);
+
+	// The period is 5 minutes
+	g_ullSIM_Limit = 400000000000ULL;
+	vSIM_Run(360000000000ULL);
+	vMain_TimeSync();
+	CHECK_NEAR(2500, uiCLOCK_GetRate(), 2);
+}
+
+//! @}
@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file test_crc.c
+//! \brief Tests of the \ref comm CRC
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "hal.h"
+#include "core.h"
+#include "comm.h"
+#include "crc.h"
+#include "check.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief CRC-16/CCITT-FALSE a bit at a time
+//!   \param pucData The bytes; uiLength Their number
+//!   \return The CRC
+///////////////////////////////////////////////////////////////////////////////
+static unsigned int uiTest_Crc(const unsigned char * pucData, unsigned int uiLength)
+{
+	unsigned int uiCrc;
+	unsigned char ucBit;
+
+	uiCrc = 0xFFFF;
+
+	while (uiLength--)
+	{
+		uiCrc ^= (unsigned int) *pucData++ << 8;
+
+		for (ucBit = 0; ucBit < 8; ucBit++)
+			uiCrc = (uiCrc & 0x8000) ? ((uiCrc << 1) ^ 0x1021) & 0xFFFF : (uiCrc << 1) & 0xFFFF;
+	}
+
+	return uiCrc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The table CRC matches the test vector and the bitwise CRC
+///////////////////////////////////////////////////////////////////////////////
+void vTest_CrcReference(void)
+{
+	unsigned char ucaMsg[MAXMSGLEN];
+	unsigned char ucLength;
+	unsigned char ucIdx;
+
+	memcpy(ucaMsg, "123456789", 9);
+	CHECK(ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_SEND, ucaMsg, 9 + CRC_SZ));
+	CHECK_EQUAL(0x29B1, (ucaMsg[9] << 8) | ucaMsg[10]);
+
+	// Every length a frame can have, over a changing pattern
+	for (ucLength = 1; ucLength + CRC_SZ <= MAXMSGLEN; ucLength++)
+	{
+		for (ucIdx = 0; ucIdx < ucLength; ucIdx++)
+			ucaMsg[ucIdx] = (unsigned char) (ucIdx * 37 + ucLength);
+
+		ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_SEND, ucaMsg, ucLength + CRC_SZ);
+		CHECK_EQUAL(uiTest_Crc(ucaMsg, ucLength), (ucaMsg[ucLength] << 8) | ucaMsg[ucLength + 1]);
+		CHECK(ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_REC, ucaMsg, ucLength + CRC_SZ));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A received frame with any single bit flipped fails the check
+///////////////////////////////////////////////////////////////////////////////
+void vTest_CrcDetectsFlips(void)
+{
+	unsigned char ucaMsg[16];
+	unsigned char ucIdx;
+	unsigned char ucBit;
+
+	for (ucIdx = 0; ucIdx < 14; ucIdx++)
+		ucaMsg[ucIdx] = (unsigned char) (0xA5 ^ ucIdx);
+
+	ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_SEND, ucaMsg, 16);
+
+	for (ucIdx = 0; ucIdx < 16; ucIdx++)
+	{
+		for (ucBit = 0; ucBit < 8; ucBit++)
+		{
+			ucaMsg[ucIdx] ^= 1 << ucBit;
+			CHECK(!ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_REC, ucaMsg, 16));
+			ucaMsg[ucIdx] ^= 1 << ucBit;
+		}
+	}
+
+	CHECK(ucCRC16_compute_msg_CRC(CRC_FOR_MSG_TO_REC, ucaMsg, 16));
+}
+
+//! @}
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file test_flash.c
+//! \brief Tests of the \ref flash channel record
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "flash.h"
+#include "check.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Fills a calibration with a pattern
+//!   \param puiCal The calibration; uiSeed The pattern
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vTest_FillCal(uint16 * puiCal, uint16 uiSeed)
+{
+	uint8 ucIdx;
+
+	for (ucIdx = 0; ucIdx < CAL_WORDS; ucIdx++)
+		puiCal[ucIdx] = (uint16) (uiSeed + ucIdx * 0x0101);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The calibration and the types read back as stored, each update
+//! keeping the other
+///////////////////////////////////////////////////////////////////////////////
+void vTest_FlashChannelRecord(void)
+{
+	uint16 uiaCal[CAL_WORDS];
+	uint16 uiaRead[CAL_WORDS];
+	uint8 ucaTypes[SENSOR_TYPE_COUNT] = { 'K', 'T', 'J', 0 };
+	uint8 ucaRead[SENSOR_TYPE_COUNT];
+	uint8 ucIdx;
+
+	// An erased part has neither
+	CHECK_EQUAL(1, ucFlash_GetCalibration(uiaRead));
+	vFlash_GetSensorTypes(ucaRead);
+	CHECK_EQUAL(0xFF, ucaRead[0]);
+
+	vTest_FillCal(uiaCal, 0x8000);
+	CHECK_EQUAL(0, ucFlash_SetCalibration(uiaCal));
+	CHECK_EQUAL(0, ucFlash_SetSensorTypes(ucaTypes));
+
+	CHECK_EQUAL(0, ucFlash_GetCalibration(uiaRead));
+	for (ucIdx = 0; ucIdx < CAL_WORDS; ucIdx++)
+		CHECK_EQUAL(uiaCal[ucIdx], uiaRead[ucIdx]);
+
+	vFlash_GetSensorTypes(ucaRead);
+	for (ucIdx = 0; ucIdx < SENSOR_TYPE_COUNT; ucIdx++)
+		CHECK_EQUAL(ucaTypes[ucIdx], ucaRead[ucIdx]);
+
+	// Both copies hold the record
+	for (ucIdx = 0; ucIdx < INFO_SEGMENTLENGTH / 2; ucIdx++)
+		CHECK_EQUAL(HAL_PTR(uint16, FLASH_INFO_C)[ucIdx], HAL_PTR(uint16, FLASH_INFO_B)[ucIdx]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A record torn in sector B is read from the copy in sector C
+///////////////////////////////////////////////////////////////////////////////
+void vTest_FlashTornRecord(void)
+{
+	uint16 uiaCal[CAL_WORDS];
+	uint16 uiaRead[CAL_WORDS];
+
+	vTest_FillCal(uiaCal, 0x7F00);
+	CHECK_EQUAL(0, ucFlash_SetCalibration(uiaCal));
+
+	// A reset while sector B was written leaves it half erased
+	HAL_PTR(uint16, FLASH_INFO_B)[4] = 0xFFFF;
+
+	CHECK_EQUAL(0, ucFlash_GetCalibration(uiaRead));
+	CHECK_EQUAL(uiaCal[2], uiaRead[2]);
+
+	// With both copies gone there is no calibration
+	HAL_PTR(uint16, FLASH_INFO_C)[0] = 0xFFFF;
+	CHECK_EQUAL(1, ucFlash_GetCalibration(uiaRead));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A channel update leaves the HID in sector D alone
+///////////////////////////////////////////////////////////////////////////////
+void vTest_FlashKeepsHid(void)
+{
+	uint16 uiaHid[4] = { 0x5354, 0x0102, 0x0304, 0x0506 };
+	uint16 uiaRead[4];
+	uint16 uiaCal[CAL_WORDS];
+	uint8 ucaTypes[SENSOR_TYPE_COUNT] = { 'J', 'J', 'K', 'K' };
+	uint8 ucIdx;
+
+	CHECK_EQUAL(0, ucFlash_SetHID(uiaHid));
+
+	vTest_FillCal(uiaCal, 0x8100);
+	CHECK_EQUAL(0, ucFlash_SetCalibration(uiaCal));
+	CHECK_EQUAL(0, ucFlash_SetSensorTypes(ucaTypes));
+
+	vFlash_GetHID(uiaRead);
+	for (ucIdx = 0; ucIdx < 4; ucIdx++)
+		CHECK_EQUAL(uiaHid[ucIdx], uiaRead[ucIdx]);
+}
+
+//! @}
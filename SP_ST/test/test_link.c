@@ -0,0 +1,380 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file test_link.c
+//! \brief Tests of the \ref comm link against the CP bus master of cp_sim.c
+//!
+//! The firmware runs from reset.  Each test is a CP script, the checks run
+//! in the script between transactions.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "sim.h"
+#include "board.h"
+#include "cp_sim.h"
+#include "check.h"
+
+//! \def TEST_LINK_BYTE_CLOCKS
+//! \brief Clocks of a standard mode byte
+#define TEST_LINK_BYTE_CLOCKS	10
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Builds a frame without payload
+//!   \param pucMsg The frame; ucType, ucVersion The header
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vTest_LinkHeader(uint8 * pucMsg, uint8 ucType, uint8 ucVersion)
+{
+	pucMsg[MSG_TYP_IDX] = ucType;
+	pucMsg[MSG_LEN_IDX] = SP_HEADERSIZE;
+	pucMsg[MSG_VER_IDX] = ucVersion;
+	pucMsg[MSG_FLAGS_IDX] = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Builds a command of the test transducer, which reports 0xBEEF
+//!   \param pucMsg The frame; ucType COMMAND_PKT or COMMAND_AND_REPORT
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vTest_LinkCommand(uint8 * pucMsg, uint8 ucType)
+{
+	vTest_LinkHeader(pucMsg, ucType, SP_DATAMESSAGE_VERSION);
+	pucMsg[MSG_PAYLD_IDX] = 0;
+	pucMsg[MSG_PAYLD_IDX + 1] = 0;
+	pucMsg[MSG_LEN_IDX] = SP_HEADERSIZE + 2;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Receives the ID packet the SP sends after a reset
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vTest_LinkBoot(void)
+{
+	uint8 ucaRx[MAXMSGLEN];
+
+	vCP_WaitListening();
+	CHECK_EQUAL(CP_OK, ucCP_Transact(0, ucaRx));
+	CHECK_EQUAL(ID_PKT, ucaRx[MSG_TYP_IDX]);
+	CHECK_EQUAL(12, ucaRx[MSG_LEN_IDX]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Reads a link statistic of the SP over the link
+//!
+//! The diagnostics frame is counted in FRAMES_RX, its reply is not yet in
+//! FRAMES_TX.
+//!   \param ucIdx The COMM_STAT index
+//!   \return The counter
+///////////////////////////////////////////////////////////////////////////////
+static uint16 uiTest_LinkStat(uint8 ucIdx)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+	uint8 ucPos;
+
+	vTest_LinkHeader(ucaTx, REQUEST_DIAGNOSTICS, SP_DATAMESSAGE_VERSION);
+
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+	CHECK_EQUAL(REQUEST_DIAGNOSTICS, ucaRx[MSG_TYP_IDX]);
+
+	ucPos = MSG_PAYLD_IDX + DIAG_REPORT_LEN + 2 * ucIdx;
+
+	return ((uint16) ucaRx[ucPos] << 8) | ucaRx[ucPos + 1];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Finds the test transducer in a version 1.20 report
+//!   \param pucMsg The report
+//!   \return Nonzero if it reads 0xBEEF
+///////////////////////////////////////////////////////////////////////////////
+static uint8 ucTest_LinkHasBeef(const uint8 * pucMsg)
+{
+	uint8 ucPos;
+
+	for (ucPos = MSG_PAYLD_IDX; ucPos < pucMsg[MSG_LEN_IDX]; ucPos += pucMsg[ucPos + 1] + 2)
+	{
+		if (pucMsg[ucPos] == 0 && pucMsg[ucPos + 1] == 2)
+			return pucMsg[ucPos + 2] == 0xBE && pucMsg[ucPos + 3] == 0xEF;
+	}
+
+	return 0;
+}
+
+static void vTest_LinkCommandReportScript(void)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+	unsigned long ulClocks;
+
+	vTest_LinkBoot();
+
+	vTest_LinkCommand(ucaTx, COMMAND_PKT);
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+	CHECK_EQUAL(CONFIRM_COMMAND, ucaRx[MSG_TYP_IDX]);
+
+	vTest_LinkHeader(ucaTx, REQUEST_DATA, SP_DATAMESSAGE_VERSION);
+	vCP_WaitListening();
+	ulClocks = g_ulCP_Clocks;
+	CHECK_EQUAL(CP_OK, ucCP_Transact(ucaTx, ucaRx));
+	CHECK_EQUAL(REPORT_DATA, ucaRx[MSG_TYP_IDX]);
+	CHECK(ucTest_LinkHasBeef(ucaRx));
+
+	// Every byte both ways is 10 clocks
+	CHECK_EQUAL(TEST_LINK_BYTE_CLOCKS * (SP_HEADERSIZE + CRC_SZ + ucaRx[MSG_LEN_IDX] + CRC_SZ), g_ulCP_Clocks - ulClocks);
+	CHECK_EQUAL(0, g_ulCP_NacksSeen);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A command is confirmed and its report requested
+///////////////////////////////////////////////////////////////////////////////
+void vTest_LinkCommandReport(void)
+{
+	vBOARD_Init();
+	vCP_Run(vTest_LinkCommandReportScript);
+}
+
+static void vTest_LinkLineErrorScript(void)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+
+	vTest_LinkBoot();
+
+	// A bit flipped in the payload is nacked, the frame fails its CRC and
+	// the SP reports the error
+	vTest_LinkCommand(ucaTx, COMMAND_PKT);
+	g_ucCP_CorruptByte = MSG_PAYLD_IDX + 1;
+	vCP_WaitListening();
+	CHECK_EQUAL(CP_OK, ucCP_Transact(ucaTx, ucaRx));
+	CHECK_EQUAL(REPORT_ERROR, ucaRx[MSG_TYP_IDX]);
+	CHECK_EQUAL(COMM_ERROR, ucaRx[MSG_PAYLD_IDX]);
+	CHECK_EQUAL(1, g_ulCP_NacksSeen);
+
+	// A bit flipped in the type is only a parity error to a legacy CP
+	g_ucCP_CorruptByte = MSG_TYP_IDX;
+	vCP_WaitListening();
+	CHECK_EQUAL(CP_OK, ucCP_Transact(ucaTx, ucaRx));
+	CHECK_EQUAL(REPORT_ERROR, ucaRx[MSG_TYP_IDX]);
+	CHECK_EQUAL(2, g_ulCP_NacksSeen);
+
+	// Once negotiated it is refused at once, the CP stops
+	CHECK_EQUAL(CP_OK, ucCP_SetLinkMode(COMM_LINK_HEADER_NACK));
+	CHECK_EQUAL(COMM_LINK_HEADER_NACK, g_ucCP_LinkMode);
+	g_ucCP_CorruptByte = MSG_TYP_IDX;
+	vCP_WaitListening();
+	CHECK_EQUAL(CP_REFUSED, ucCP_Transact(ucaTx, ucaRx));
+	CHECK_EQUAL(3, g_ulCP_NacksSeen);
+
+	// The frame goes through once the line is clean
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+	CHECK_EQUAL(CONFIRM_COMMAND, ucaRx[MSG_TYP_IDX]);
+
+	// The refused byte counts as a header reject only
+	CHECK_EQUAL(2, uiTest_LinkStat(COMM_STAT_PARITY_ERR));
+	CHECK_EQUAL(2, uiTest_LinkStat(COMM_STAT_CRC_ERR));
+	CHECK_EQUAL(1, uiTest_LinkStat(COMM_STAT_HEADER_REJECT));
+	CHECK_EQUAL(0, uiTest_LinkStat(COMM_STAT_TIMEOUT));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Line errors on CP frames are caught by the parity and the CRC
+///////////////////////////////////////////////////////////////////////////////
+void vTest_LinkLineError(void)
+{
+	vBOARD_Init();
+	vCP_Run(vTest_LinkLineErrorScript);
+}
+
+static void vTest_LinkNackRetryScript(void)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+
+	vTest_LinkBoot();
+
+	// Nacked bytes come again and the frame arrives whole
+	vTest_LinkCommand(ucaTx, COMMAND_PKT);
+	g_ucCP_Nacks = 2;
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+	CHECK_EQUAL(CONFIRM_COMMAND, ucaRx[MSG_TYP_IDX]);
+
+	// The ID packet and the confirm
+	CHECK_EQUAL(2, uiTest_LinkStat(COMM_STAT_FRAMES_TX));
+	CHECK_EQUAL(2, uiTest_LinkStat(COMM_STAT_ACK_ERR));
+	CHECK_EQUAL(0, uiTest_LinkStat(COMM_STAT_TX_ABORT));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The SP sends a byte the CP nacked again
+///////////////////////////////////////////////////////////////////////////////
+void vTest_LinkNackRetry(void)
+{
+	vBOARD_Init();
+	vCP_Run(vTest_LinkNackRetryScript);
+}
+
+static void vTest_LinkTxAbortScript(void)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+
+	vTest_LinkBoot();
+
+	// Both ends give up on the fifth nack
+	vTest_LinkCommand(ucaTx, COMMAND_PKT);
+	g_ucCP_Nacks = 5;
+	vCP_WaitListening();
+	CHECK_EQUAL(CP_ABORTED, ucCP_Transact(ucaTx, ucaRx));
+
+	// Only the ID packet was sent
+	CHECK_EQUAL(1, uiTest_LinkStat(COMM_STAT_FRAMES_TX));
+	CHECK_EQUAL(5, uiTest_LinkStat(COMM_STAT_ACK_ERR));
+	CHECK_EQUAL(1, uiTest_LinkStat(COMM_STAT_TX_ABORT));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief An abandoned frame is counted as aborted, not as sent
+///////////////////////////////////////////////////////////////////////////////
+void vTest_LinkTxAbort(void)
+{
+	vBOARD_Init();
+	vCP_Run(vTest_LinkTxAbortScript);
+}
+
+static void vTest_LinkBurstScript(void)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+	unsigned long ulClocks;
+
+	vTest_LinkBoot();
+
+	CHECK_EQUAL(CP_OK, ucCP_SetLinkMode(COMM_LINK_BURST | COMM_LINK_READY_LINE));
+	CHECK_EQUAL(COMM_LINK_BURST | COMM_LINK_READY_LINE, g_ucCP_LinkMode);
+
+	// 8 clocks a byte and one frame ack each way
+	vTest_LinkCommand(ucaTx, COMMAND_AND_REPORT);
+	vCP_WaitListening();
+	ulClocks = g_ulCP_Clocks;
+	CHECK_EQUAL(CP_OK, ucCP_Transact(ucaTx, ucaRx));
+	CHECK_EQUAL(REPORT_DATA, ucaRx[MSG_TYP_IDX]);
+	CHECK(ucaRx[MSG_FLAGS_IDX] & CONFIRM_BIT);
+	CHECK(ucTest_LinkHasBeef(ucaRx));
+	CHECK_EQUAL(8 * (SP_HEADERSIZE + 2 + CRC_SZ) + 1 + 8 * (ucaRx[MSG_LEN_IDX] + CRC_SZ) + 1, g_ulCP_Clocks - ulClocks);
+
+	// A nacked burst reply comes again in the standard mode
+	vTest_LinkHeader(ucaTx, REQUEST_DATA, SP_DATAMESSAGE_VERSION);
+	g_ucCP_Nacks = 1;
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+	CHECK_EQUAL(REPORT_DATA, ucaRx[MSG_TYP_IDX]);
+	CHECK_EQUAL(COMM_LINK_READY_LINE, g_ucCP_LinkMode);
+
+	CHECK_EQUAL(1, uiTest_LinkStat(COMM_STAT_BURST_FALLBACK));
+	CHECK_EQUAL(0, uiTest_LinkStat(COMM_STAT_TIMEOUT));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The burst mode with the ready line, and its fallback
+///////////////////////////////////////////////////////////////////////////////
+void vTest_LinkBurst(void)
+{
+	vBOARD_Init();
+	vCP_Run(vTest_LinkBurstScript);
+}
+
+static void vTest_LinkIrqTxScript(void)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+
+	vTest_LinkBoot();
+
+	CHECK_EQUAL(CP_OK, ucCP_SetLinkMode(COMM_LINK_IRQ_TX));
+	CHECK_EQUAL(COMM_LINK_IRQ_TX, g_ucCP_LinkMode);
+
+	vTest_LinkCommand(ucaTx, COMMAND_PKT);
+	g_ucCP_Nacks = 2;
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+	CHECK_EQUAL(CONFIRM_COMMAND, ucaRx[MSG_TYP_IDX]);
+
+	vTest_LinkHeader(ucaTx, REQUEST_DATA, SP_DATAMESSAGE_VERSION);
+	g_ucCP_Nacks = 5;
+	vCP_WaitListening();
+	CHECK_EQUAL(CP_ABORTED, ucCP_Transact(ucaTx, ucaRx));
+
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+	CHECK(ucTest_LinkHasBeef(ucaRx));
+
+	// The ID packet, the link mode reply, the confirm and the report
+	CHECK_EQUAL(4, uiTest_LinkStat(COMM_STAT_FRAMES_TX));
+	CHECK_EQUAL(7, uiTest_LinkStat(COMM_STAT_ACK_ERR));
+	CHECK_EQUAL(1, uiTest_LinkStat(COMM_STAT_TX_ABORT));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The interrupt driven transmit engine retries and gives up as the
+//! polled one does
+///////////////////////////////////////////////////////////////////////////////
+void vTest_LinkIrqTx(void)
+{
+	vBOARD_Init();
+	vCP_Run(vTest_LinkIrqTxScript);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Requests a version 1.22 report
+//!   \param pucRx The report
+//!   \return The time of the frame, in milliseconds since the sync
+///////////////////////////////////////////////////////////////////////////////
+static uint32 ulTest_LinkTimedReport(uint8 * pucRx)
+{
+	uint8 ucaTx[MAXMSGLEN];
+
+	vTest_LinkHeader(ucaTx, REQUEST_DATA, SP_DATAMESSAGE_VERSION_TIMED);
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, pucRx));
+	CHECK_EQUAL(SP_DATAMESSAGE_VERSION_TIMED, pucRx[MSG_VER_IDX]);
+
+	return ((uint32) pucRx[MSG_PAYLD_IDX] << 24) | ((uint32) pucRx[MSG_PAYLD_IDX + 1] << 16)
+			| ((uint32) pucRx[MSG_PAYLD_IDX + 2] << 8) | pucRx[MSG_PAYLD_IDX + 3];
+}
+
+static void vTest_LinkTimeSyncScript(void)
+{
+	uint8 ucaTx[MAXMSGLEN];
+	uint8 ucaRx[MAXMSGLEN];
+	uint32 ulTime;
+
+	vTest_LinkBoot();
+
+	vTest_LinkCommand(ucaTx, COMMAND_PKT);
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+
+	vCP_Wait(2000000000ULL);
+	ulTime = ulTest_LinkTimedReport(ucaRx);
+	CHECK(ulTime >= 2000);
+
+	// The staged frame is sent again while nothing changed
+	vCP_Wait(1000000000ULL);
+	CHECK_EQUAL(ulTime, ulTest_LinkTimedReport(ucaRx));
+
+	// The sync restages it against the new time base
+	vTest_LinkHeader(ucaTx, TIME_SYNC, SP_DATAMESSAGE_VERSION);
+	CHECK_EQUAL(CP_OK, ucCP_Exchange(ucaTx, ucaRx));
+	CHECK_EQUAL(TIME_SYNC, ucaRx[MSG_TYP_IDX]);
+
+	CHECK(ulTest_LinkTimedReport(ucaRx) < 100);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A TIME_SYNC drops the staged timed report
+///////////////////////////////////////////////////////////////////////////////
+void vTest_LinkTimeSync(void)
+{
+	vBOARD_Init();
+	vCP_Run(vTest_LinkTimeSyncScript);
+}
+
+//! @}
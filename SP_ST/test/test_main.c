@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file test_main.c
+//! \brief Runs the host tests
+//!
+//! Usage: sp_test [name ...].  Without names every test runs, otherwise the
+//! tests whose name contains one of them.  Each test runs in a child process
+//! on a reset device model.
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "hal.h"
+#include "sim.h"
+#include "check.h"
+
+//! \struct TEST_ENTRY
+typedef struct {
+	const char * pcName;
+	void (*pfnTest)(void);
+} TEST_ENTRY;
+
+//! \def TEST
+#define TEST(name)		{ #name, name }
+
+static const TEST_ENTRY s_saTest_List[] = {
+	TEST(vTest_CrcReference),
+	TEST(vTest_CrcDetectsFlips),
+	TEST(vTest_FlashChannelRecord),
+	TEST(vTest_FlashTornRecord),
+	TEST(vTest_FlashKeepsHid),
+	TEST(vTest_ClockToMillis),
+	TEST(vTest_ClockCountsAclk),
+	TEST(vTest_ClockCalibrateVlo),
+	TEST(vTest_ClockSyncCalibrates),
+	TEST(vTest_ConvertThermistor),
+	TEST(vTest_ConvertThermocouple),
+	TEST(vTest_ThermoTrimsSpike),
+	TEST(vTest_ThermoMeanFilter),
+	TEST(vTest_ThermoMainsSync),
+	TEST(vTest_ReportPacked),
+	TEST(vTest_ReportDispatch),
+	TEST(vTest_ReportRatiometric),
+	TEST(vTest_BurstTrigger),
+	TEST(vTest_BurstBound),
+	TEST(vTest_BurstShortTimeout),
+	TEST(vTest_BurstRejects),
+	TEST(vTest_LinkCommandReport),
+	TEST(vTest_LinkLineError),
+	TEST(vTest_LinkNackRetry),
+	TEST(vTest_LinkTxAbort),
+	TEST(vTest_LinkBurst),
+	TEST(vTest_LinkIrqTx),
+	TEST(vTest_LinkTimeSync),
+};
+
+//! \var s_uiCheck_Failures
+//! \brief The failed checks of the running test
+static unsigned int s_uiCheck_Failures;
+
+void vCHECK_True(int iPass, const char * pcWhat, const char * pcFile, int iLine)
+{
+	if (iPass)
+		return;
+
+	printf("%s:%d: check failed: %s\n", pcFile, iLine, pcWhat);
+	s_uiCheck_Failures++;
+}
+
+void vCHECK_Equal(long lExp, long lVal, const char * pcWhat, const char * pcFile, int iLine)
+{
+	if (lExp == lVal)
+		return;
+
+	printf("%s:%d: %s is %ld (0x%lX), expected %ld (0x%lX)\n", pcFile, iLine, pcWhat, lVal, lVal, lExp, lExp);
+	s_uiCheck_Failures++;
+}
+
+void vCHECK_Near(long lExp, long lVal, long lTol, const char * pcWhat, const char * pcFile, int iLine)
+{
+	if (lVal >= lExp - lTol && lVal <= lExp + lTol)
+		return;
+
+	printf("%s:%d: %s is %ld, expected %ld +/- %ld\n", pcFile, iLine, pcWhat, lVal, lExp, lTol);
+	s_uiCheck_Failures++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Tells whether a test was asked for
+//!   \param pcName The test; iArgc, ppcArgv The names asked for
+//!   \return Nonzero to run the test
+///////////////////////////////////////////////////////////////////////////////
+static int iTest_Selected(const char * pcName, int iArgc, char ** ppcArgv)
+{
+	int iArg;
+
+	if (iArgc < 2)
+		return 1;
+
+	for (iArg = 1; iArg < iArgc; iArg++)
+	{
+		if (strstr(pcName, ppcArgv[iArg]))
+			return 1;
+	}
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Runs one test in a child process
+//!   \param psTest The test
+//!   \return 0 if it passed
+///////////////////////////////////////////////////////////////////////////////
+static int iTest_Run(const TEST_ENTRY * psTest)
+{
+	pid_t iPid;
+	int iStatus;
+
+	fflush(stdout);
+
+	iPid = fork();
+	if (iPid < 0)
+	{
+		perror("fork");
+		return 1;
+	}
+
+	if (iPid == 0)
+	{
+		vSIM_Reset();
+		psTest->pfnTest();
+		fflush(stdout);
+		_exit(s_uiCheck_Failures ? 1 : 0);
+	}
+
+	if (waitpid(iPid, &iStatus, 0) < 0)
+		return 1;
+
+	return !(WIFEXITED(iStatus) && WEXITSTATUS(iStatus) == 0);
+}
+
+int main(int iArgc, char ** ppcArgv)
+{
+	unsigned int uiIdx;
+	unsigned int uiRun;
+	unsigned int uiFailed;
+
+	uiRun = 0;
+	uiFailed = 0;
+
+	for (uiIdx = 0; uiIdx < sizeof(s_saTest_List) / sizeof(s_saTest_List[0]); uiIdx++)
+	{
+		if (!iTest_Selected(s_saTest_List[uiIdx].pcName, iArgc, ppcArgv))
+			continue;
+
+		uiRun++;
+
+		if (iTest_Run(&s_saTest_List[uiIdx]) != 0)
+		{
+			printf("FAIL %s\n", s_saTest_List[uiIdx].pcName);
+			uiFailed++;
+		}
+		else
+		{
+			printf("ok   %s\n", s_saTest_List[uiIdx].pcName);
+		}
+	}
+
+	printf("%u of %u tests passed\n", uiRun - uiFailed, uiRun);
+
+	return (uiFailed || uiRun == 0) ? 1 : 0;
+}
+
+//! @}
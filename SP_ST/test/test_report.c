@@ -0,0 +1,229 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file test_report.c
+//! \brief Tests of the dispatch and the reports of main.c
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include "hal.h"
+#include "core.h"
+#include "Thermo.h"
+#include "Convert.h"
+#include "sim.h"
+#include "board.h"
+#include "check.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Starts the SP as main() does, short of the core loop
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vTest_ReportInit(void)
+{
+	vBOARD_Init();
+	vCORE_Initilize();
+	vMain_CleanDataStruct();
+	vThermo_LoadCalibration();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Finds a data generator in an unpacked report
+//!   \param pucData, ucLength The report; ucId The generator ID
+//!   \return The offset of its entry, ucLength if it is not there
+///////////////////////////////////////////////////////////////////////////////
+static uint8 ucTest_Find(const uint8 * pucData, uint8 ucLength, uint8 ucId)
+{
+	uint8 ucPos;
+
+	for (ucPos = 0; ucPos < ucLength; ucPos += pucData[ucPos + 1] + 2)
+	{
+		if (pucData[ucPos] == ucId)
+			return ucPos;
+	}
+
+	return ucLength;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Reads the two byte value of a data generator in an unpacked report
+//!   \param pucData, ucLength The report; ucId The generator ID
+//!   \return The value
+///////////////////////////////////////////////////////////////////////////////
+static uint16 uiTest_Value(const uint8 * pucData, uint8 ucLength, uint8 ucId)
+{
+	uint8 ucPos;
+
+	ucPos = ucTest_Find(pucData, ucLength, ucId);
+	CHECK(ucPos < ucLength);
+
+	return ((uint16) pucData[ucPos + 2] << 8) | pucData[ucPos + 3];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The packed report holds the same readings as the plain one
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ReportPacked(void)
+{
+	uint8 ucaPlain[MAXMSGLEN];
+	uint8 ucaPacked[MAXMSGLEN];
+	uint8 ucPlainLen;
+	uint8 ucPackedLen;
+	uint8 ucGen;
+	uint8 ucPos;
+	uint8 ucHalf;
+	uint8 ucEntry;
+	uint16 uiValue;
+
+	vTest_ReportInit();
+
+	CHECK_EQUAL(0, uiMainDispatch(0, 0, 0));
+	CHECK_EQUAL(0, uiMainDispatch(1, 0, 0));
+	CHECK_EQUAL(0, uiMainDispatch(2, 0, 0));
+	CHECK_EQUAL(0, uiMainDispatch(4, 0, 0));
+
+	ucPlainLen = ucMain_FetchData(ucaPlain);
+	ucPackedLen = ucMain_FetchPackedData(ucaPacked);
+
+	// Six generators of two bytes and their headers
+	CHECK_EQUAL(6 * 4, ucPlainLen);
+
+	// The bitmap, five 12-bit values and the test generator as it is
+	CHECK_EQUAL(1 + 8 + 4, ucPackedLen);
+	CHECK_EQUAL(0x5E, ucaPacked[0]);
+
+	ucPos = 1;
+	ucHalf = 0;
+	for (ucGen = 0; ucGen < 8; ucGen++)
+	{
+		if (!(ucaPacked[0] & (1 << ucGen)))
+			continue;
+
+		if (!ucHalf)
+		{
+			uiValue = ((uint16) ucaPacked[ucPos] << 4) | (ucaPacked[ucPos + 1] >> 4);
+			ucPos++;
+		}
+		else
+		{
+			uiValue = ((uint16) (ucaPacked[ucPos] & 0x0F) << 8) | ucaPacked[ucPos + 1];
+			ucPos += 2;
+		}
+		ucHalf = !ucHalf;
+
+		ucEntry = ucTest_Find(ucaPlain, ucPlainLen, ucGen);
+		CHECK(ucEntry < ucPlainLen);
+		CHECK_EQUAL((ucaPlain[ucEntry + 2] << 8) | ucaPlain[ucEntry + 3], uiValue);
+	}
+
+	if (ucHalf)
+		ucPos++;
+
+	// The channels read their board inputs
+	CHECK_EQUAL(g_uiaBOARD_Channel[1], (ucaPlain[ucTest_Find(ucaPlain, ucPlainLen, 3) + 2] << 8) | ucaPlain[ucTest_Find(ucaPlain, ucPlainLen, 3) + 3]);
+	CHECK_EQUAL(g_uiaBOARD_Channel[0], (ucaPlain[ucTest_Find(ucaPlain, ucPlainLen, 1) + 2] << 8) | ucaPlain[ucTest_Find(ucaPlain, ucPlainLen, 1) + 3]);
+
+	// The test generator follows unpacked
+	CHECK_EQUAL(ucPackedLen - 4, ucPos);
+	CHECK_EQUAL(0, ucaPacked[ucPos]);
+	CHECK_EQUAL(2, ucaPacked[ucPos + 1]);
+	CHECK_EQUAL(0xBE, ucaPacked[ucPos + 2]);
+	CHECK_EQUAL(0xEF, ucaPacked[ucPos + 3]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The dispatch reports what each transducer did
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ReportDispatch(void)
+{
+	uint8 ucaData[MAXMSGLEN];
+	uint8 ucParam[2];
+	uint8 ucLength;
+
+	vTest_ReportInit();
+
+	// Nothing is new after the start
+	CHECK_EQUAL(0, ucMain_FetchData(ucaData));
+
+	CHECK_EQUAL(1, uiMainDispatch(5, 0, 0));
+
+	// An open channel reports its fault in place of the earlier reading, and
+	// is marked dead
+	CHECK_EQUAL(0, uiMainDispatch(3, 0, 0));
+	g_uiaBOARD_Channel[3] = 4095;
+	CHECK_EQUAL(0, uiMainDispatch(3, 0, 0));
+	CHECK_EQUAL(THERMO_HEALTH_OPEN, ucThermo_GetHealth(3));
+
+	ucLength = ucMain_FetchData(ucaData);
+	CHECK_EQUAL(ucLength, ucTest_Find(ucaData, ucLength, 5));
+	ucParam[0] = ucTest_Find(ucaData, ucLength, 5 | 0x40);
+	CHECK(ucParam[0] < ucLength);
+	CHECK_EQUAL(1, ucaData[ucParam[0] + 1]);
+	CHECK_EQUAL(THERMO_HEALTH_OPEN, ucaData[ucParam[0] + 2]);
+
+	// The probe of the next scan still finds it open
+	CHECK_EQUAL(0, uiMainDispatch(3, 0, 0));
+	ucLength = ucMain_FetchData(ucaData);
+	CHECK(ucTest_Find(ucaData, ucLength, 5 | 0x40) < ucLength);
+
+	// A channel bound to a type reports degrees C x 100, 4096 uV of type K
+	// over a cold junction at 25 degrees C
+	CHECK_EQUAL(0, ucConvert_Bind(1, CONVERT_TYPE_K));
+	g_uiaBOARD_Channel[1] = g_uiaBOARD_Channel[0] + 3355;
+	ucParam[0] = THERMO_FILTER_TRIMMED;
+	CHECK_EQUAL(0, uiMainDispatch(1, 1, ucParam));
+
+	ucLength = ucMain_FetchData(ucaData);
+	ucParam[0] = ucTest_Find(ucaData, ucLength, 3 | 0x80);
+	CHECK(ucParam[0] < ucLength);
+	CHECK_NEAR(12431, (int16) ((ucaData[ucParam[0] + 2] << 8) | ucaData[ucParam[0] + 3]), 3);
+
+	// The mains parameter is only read with THERMO_FILTER_EXTENDED
+	ucParam[0] = THERMO_FILTER_MEAN;
+	ucParam[1] = 0x55;
+	CHECK_EQUAL(0, uiMainDispatch(1, 2, ucParam));
+	ucParam[0] = THERMO_FILTER_MEAN | THERMO_FILTER_EXTENDED;
+	CHECK_EQUAL(1, uiMainDispatch(1, 2, ucParam));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The ratiometric mode scales to the references and reads the zero
+//! once per scan
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ReportRatiometric(void)
+{
+	uint8 ucaData[MAXMSGLEN];
+	uint8 ucaParam[4];
+	uint8 ucLength;
+
+	vTest_ReportInit();
+
+	// An ADC that reads the references 100 ticks in from either rail
+	g_uiBOARD_RefHigh = 3995;
+	g_uiBOARD_RefLow = 100;
+
+	ucaParam[0] = THERMO_FILTER_MEAN | THERMO_FILTER_EXTENDED;
+	ucaParam[1] = THERMO_MAINS_NONE;
+	ucaParam[2] = 1;
+	ucaParam[3] = 1;
+	CHECK_EQUAL(0, uiMainDispatch(1, sizeof(ucaParam), ucaParam));
+
+	// (ticks - 100) * 4095 / 3895
+	ucLength = ucMain_FetchData(ucaData);
+	CHECK_EQUAL(164, uiTest_Value(ucaData, ucLength, 1));
+	CHECK_EQUAL(703, uiTest_Value(ucaData, ucLength, 3));
+
+	// The rest of the scan reuses the zero
+	g_uiaBOARD_Channel[0] = 0x0200;
+	CHECK_EQUAL(0, uiMainDispatch(2, 0, 0));
+	CHECK_EQUAL(0, uiMainDispatch(4, 0, 0));
+	ucLength = ucMain_FetchData(ucaData);
+	CHECK_EQUAL(164, uiTest_Value(ucaData, ucLength, 1));
+
+	// The next scan reads and reports it again
+	CHECK_EQUAL(0, uiMainDispatch(1, 0, 0));
+	ucLength = ucMain_FetchData(ucaData);
+	CHECK_EQUAL(433, uiTest_Value(ucaData, ucLength, 1));
+}
+
+//! @}
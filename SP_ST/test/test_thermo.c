@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+//! \file test_thermo.c
+//! \brief Tests of the \ref convert tables and the \ref thermo readings
+//!
+//! @addtogroup test
+//! @{
+///////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "core.h"
+#include "Thermo.h"
+#include "Convert.h"
+#include "sim.h"
+#include "board.h"
+#include "check.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The thermistor table converts its points and between them
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ConvertThermistor(void)
+{
+	CHECK_EQUAL(2500, iConvert_Thermistor(2048));
+	CHECK_EQUAL(8500, iConvert_Thermistor(401));
+	CHECK_EQUAL(-4000, iConvert_Thermistor(3997));
+
+	// Halfway between 25 and 20 degrees C
+	CHECK_NEAR(2250, iConvert_Thermistor((2048 + 2278) / 2), 2);
+
+	CHECK_EQUAL(CONVERT_OUT_OF_RANGE, iConvert_Thermistor(400));
+	CHECK_EQUAL(CONVERT_OUT_OF_RANGE, iConvert_Thermistor(3998));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A thermocouple converts against the cold junction
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ConvertThermocouple(void)
+{
+	// Unbound or out of range channels do not convert
+	CHECK_EQUAL(CONVERT_OUT_OF_RANGE, iConvert_Thermocouple(1, 1000, 100, 2500));
+	CHECK_EQUAL(1, ucConvert_Bind(1, 'X'));
+	CHECK_EQUAL(1, ucConvert_Bind(5, CONVERT_TYPE_K));
+
+	CHECK_EQUAL(0, ucConvert_Bind(1, CONVERT_TYPE_K));
+	CHECK_EQUAL(CONVERT_TYPE_K, ucConvert_GetType(1));
+
+	// 4096 uV of type K is 100 degrees C with the cold junction at 0
+	CHECK_NEAR(10000, iConvert_Thermocouple(1, 100 + 3355, 100, 0), 2);
+
+	// No EMF reads the cold junction
+	CHECK_NEAR(2500, iConvert_Thermocouple(1, 100, 100, 2500), 2);
+
+	// Below the zero reading is below the cold junction
+	CHECK(iConvert_Thermocouple(1, 50, 100, 2500) < 2500);
+
+	CHECK_EQUAL(CONVERT_OUT_OF_RANGE, iConvert_Thermocouple(1, 100, 100, CONVERT_OUT_OF_RANGE));
+
+	CHECK_EQUAL(0, ucConvert_Bind(1, CONVERT_TYPE_NONE));
+	CHECK_EQUAL(CONVERT_TYPE_NONE, ucConvert_GetType(1));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief A level of 1000 ticks with a spike on the fourth sample
+///////////////////////////////////////////////////////////////////////////////
+static unsigned int uiTest_Spike(unsigned char ucChannel, unsigned long ulSample, unsigned long long ullNs)
+{
+	static unsigned long s_ulFirst = 0xFFFFFFFFUL;
+
+	if (ucChannel != 1)
+		return 0x0100;
+
+	if (s_ulFirst == 0xFFFFFFFFUL)
+		s_ulFirst = ulSample;
+
+	return (ulSample - s_ulFirst == 3) ? 4000 : 1000;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Brings up the ADC12 with the calibration of an erased part
+//!   \param none
+//!   \return none
+///////////////////////////////////////////////////////////////////////////////
+static void vTest_ThermoInit(void)
+{
+	vBOARD_Init();
+	vCORE_Initilize();
+	vADCInit();
+	vThermo_LoadCalibration();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The trimmed mean drops a spike that the plain mean keeps
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ThermoTrimsSpike(void)
+{
+	unsigned long ulStart;
+
+	vTest_ThermoInit();
+	g_pfnBOARD_Wave = uiTest_Spike;
+
+	ulStart = g_ulSIM_AdcConversions;
+	CHECK_EQUAL(1000, uiThermo_ReadChannel(1, THERMO_FILTER_TRIMMED));
+	CHECK_EQUAL(THERMO_SAMPLES, g_ulSIM_AdcConversions - ulStart);
+
+	// The channel is switched off again
+	CHECK_EQUAL(0, ucBOARD_Channel());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief The mean averages every sample and the reading is calibrated
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ThermoMeanFilter(void)
+{
+	vTest_ThermoInit();
+	g_pfnBOARD_Wave = uiTest_Spike;
+
+	CHECK_EQUAL((9 * 1000 + 4000 + THERMO_SAMPLES / 2) / THERMO_SAMPLES, uiThermo_ReadChannel(1, THERMO_FILTER_MEAN));
+
+	// A gain of 1.5 and an offset of 10 on channel 2
+	g_pfnBOARD_Wave = 0;
+	CHECK_EQUAL(0, ucThermo_SetCalibration(2, THERMO_CAL_UNITY + THERMO_CAL_UNITY / 2, 10));
+	CHECK_EQUAL(g_uiaBOARD_Channel[2] * 3 / 2 + 10, uiThermo_ReadChannel(2, THERMO_FILTER_TRIMMED));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief 2000 ticks with 500 ticks of 50 Hz on top
+///////////////////////////////////////////////////////////////////////////////
+static unsigned int uiTest_Mains(unsigned char ucChannel, unsigned long ulSample, unsigned long long ullNs)
+{
+	return (unsigned int) (2000.5 + 500.0 * sin(2.0 * M_PI * 50.0 * ullNs / 1e9));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! \brief Samples spread over a mains period cancel the mains
+///////////////////////////////////////////////////////////////////////////////
+void vTest_ThermoMainsSync(void)
+{
+	unsigned long long ullStart;
+
+	vTest_ThermoInit();
+	g_pfnBOARD_Wave = uiTest_Mains;
+
+	CHECK_EQUAL(1, ucThermo_SetMainsSync(THERMO_MAINS_50HZ, 0));
+	CHECK_EQUAL(0, ucThermo_SetMainsSync(THERMO_MAINS_50HZ, 1));
+
+	ullStart = g_ullSIM_Now;
+	CHECK_NEAR(2000, uiThermo_ReadChannel(1, THERMO_FILTER_MEAN), 2);
+
+	// The settle, then one period of samples
+	CHECK_NEAR(125000000ULL + 20000000ULL, g_ullSIM_Now - ullStart, 1000000ULL);
+	CHECK_EQUAL(0, g_ulSIM_AdcOverruns);
+
+	// Off again, the samples take a fraction of the period and see the mains
+	CHECK_EQUAL(0, ucThermo_SetMainsSync(THERMO_MAINS_NONE, 0));
+	vSIM_Run(5000000ULL);
+	CHECK(abs((int) uiThermo_ReadChannel(1, THERMO_FILTER_MEAN) - 2000) > 2);
+}
+
+//! @}